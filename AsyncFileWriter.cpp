@@ -0,0 +1,595 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Writes blocks to a file asynchronously, so new blocks can be generated while
+ *          earlier ones are still being written.
+ */
+#include "AsyncFileWriter.h"
+
+#include <vector>
+#include <fstream>
+#include <algorithm>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <condition_variable>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+namespace wavegen
+{
+
+namespace
+{
+
+[[noreturn]] void throw_write_failure()
+{
+    throw std::ofstream::failure("File generation failed. Failed to write audio data to file.");
+}
+
+}// namespace
+
+/**
+ * Interface of the platform specific writers.
+ */
+class async_file_writer::backend
+{
+public:
+    virtual ~backend() = default;
+
+    virtual void write(unsigned slot, const uint8_t* data, std::size_t size, uint64_t offset) = 0;
+    virtual void wait(unsigned slot) = 0;
+    virtual void close() = 0;
+    virtual const char* name() const = 0;
+};
+
+namespace
+{
+
+#if defined(_WIN32)
+
+/**
+ * Overlapped WriteFile, one OVERLAPPED structure and event per slot.
+ */
+class overlapped_backend : public async_file_writer::backend
+{
+public:
+    overlapped_backend(const std::string& file_path, unsigned slot_count)
+        : m_slots(slot_count)
+    {
+        m_file = CreateFileA(file_path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) {
+            throw std::ofstream::failure("File generation failed. Failed to open file " + file_path);
+        }
+
+        for (auto& slot : m_slots) {
+            slot.overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+            if (!slot.overlapped.hEvent) {
+                release();
+                throw std::ofstream::failure("File generation failed. Failed to open file " + file_path);
+            }
+        }
+    }
+
+    ~overlapped_backend() override {
+        release();
+    }
+
+    void write(unsigned slot_index, const uint8_t* data, std::size_t size, uint64_t offset) override {
+        auto& slot = m_slots[slot_index];
+        slot.data = data;
+        slot.size = size;
+        slot.offset = offset;
+        slot.busy = true;
+        start(slot);
+    }
+
+    void wait(unsigned slot_index) override {
+        auto& slot = m_slots[slot_index];
+        while (slot.busy) {
+            DWORD written {};
+            if (!GetOverlappedResult(m_file, &slot.overlapped, &written, TRUE) || written == 0) {
+                slot.busy = false;
+                throw_write_failure();
+            }
+
+            slot.data += written;
+            slot.size -= written;
+            slot.offset += written;
+            slot.busy = slot.size > 0;
+            if (slot.busy) {
+                start(slot); // short write, continue with the rest
+            }
+        }
+    }
+
+    void close() override {
+        for (unsigned slot_index{}; slot_index < m_slots.size(); ++slot_index) {
+            wait(slot_index);
+        }
+
+        bool closed = CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+        if (!closed) {
+            throw_write_failure();
+        }
+    }
+
+    const char* name() const override { return "overlapped"; }
+
+private:
+    struct slot_state
+    {
+        OVERLAPPED overlapped {};
+        const uint8_t* data {};
+        std::size_t size {};
+        uint64_t offset {};
+        bool busy {};
+    };
+
+    void start(slot_state& slot) {
+        slot.overlapped.Offset = static_cast<DWORD>(slot.offset);
+        slot.overlapped.OffsetHigh = static_cast<DWORD>(slot.offset >> 32);
+        ResetEvent(slot.overlapped.hEvent);
+
+        auto size = static_cast<DWORD>(std::min<std::size_t>(slot.size, 1u << 30));
+        if (!WriteFile(m_file, slot.data, size, nullptr, &slot.overlapped) && GetLastError() != ERROR_IO_PENDING) {
+            slot.busy = false;
+            throw_write_failure();
+        }
+    }
+
+    void release() noexcept {
+        for (auto& slot : m_slots) {
+            if (slot.busy) {
+                DWORD written {};
+                GetOverlappedResult(m_file, &slot.overlapped, &written, TRUE);
+                slot.busy = false;
+            }
+            if (slot.overlapped.hEvent) {
+                CloseHandle(slot.overlapped.hEvent);
+                slot.overlapped.hEvent = nullptr;
+            }
+        }
+
+        if (m_file != INVALID_HANDLE_VALUE) {
+            CloseHandle(m_file);
+            m_file = INVALID_HANDLE_VALUE;
+        }
+    }
+
+    HANDLE m_file {INVALID_HANDLE_VALUE};
+    std::vector<slot_state> m_slots;
+};
+
+#else
+
+/**
+ * One pending write of a slot. Short writes advance the slot and are continued.
+ */
+struct slot_state
+{
+    const uint8_t* data {};
+    std::size_t size {};
+    uint64_t offset {};
+    bool busy {};
+    bool failed {};
+
+    void advance(std::size_t written) {
+        data += written;
+        size -= written;
+        offset += written;
+    }
+};
+
+int open_for_writing(const std::string& file_path)
+{
+    int fd = ::open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::ofstream::failure("File generation failed. Failed to open file " + file_path);
+    }
+
+    return fd;
+}
+
+/**
+ * pwrite on a background thread, for systems without io_uring.
+ */
+class thread_backend : public async_file_writer::backend
+{
+public:
+    thread_backend(int fd, unsigned slot_count)
+        : m_fd(fd)
+        , m_slots(slot_count)
+        , m_thread([this] { run(); })
+    {
+    }
+
+    ~thread_backend() override {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_changed.notify_all();
+        m_thread.join();
+
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+
+    void write(unsigned slot, const uint8_t* data, std::size_t size, uint64_t offset) override {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_slots[slot] = {data, size, offset, true, false};
+            m_queue.push_back(slot);
+        }
+        m_changed.notify_all();
+    }
+
+    void wait(unsigned slot) override {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_changed.wait(lock, [&] { return !m_slots[slot].busy; });
+
+        if (m_slots[slot].failed) {
+            m_slots[slot].failed = false;
+            throw_write_failure();
+        }
+    }
+
+    void close() override {
+        for (unsigned slot{}; slot < m_slots.size(); ++slot) {
+            wait(slot);
+        }
+
+        int fd = m_fd;
+        m_fd = -1;
+        if (::close(fd) != 0) {
+            throw_write_failure();
+        }
+    }
+
+    const char* name() const override { return "thread"; }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            // pending writes are completed even when stopping, their memory must not be touched afterwards
+            m_changed.wait(lock, [&] { return m_stopping || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                return;
+            }
+
+            unsigned slot_index = m_queue.front();
+            m_queue.pop_front();
+            slot_state slot = m_slots[slot_index];
+
+            lock.unlock();
+            bool failed = false;
+            while (slot.size > 0) {
+                auto written = ::pwrite(m_fd, slot.data, slot.size, static_cast<off_t>(slot.offset));
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (written <= 0) {
+                    failed = true;
+                    break;
+                }
+                slot.advance(static_cast<std::size_t>(written));
+            }
+            lock.lock();
+
+            m_slots[slot_index].busy = false;
+            m_slots[slot_index].failed = failed;
+            m_changed.notify_all();
+        }
+    }
+
+    int m_fd;
+    std::vector<slot_state> m_slots;
+    std::deque<unsigned> m_queue;
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    bool m_stopping {};
+    std::thread m_thread;
+};
+
+#endif
+
+#if defined(__linux__)
+
+int io_uring_setup(unsigned entries, io_uring_params* params)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+/**
+ * io_uring driven through the raw system calls, so no liburing is needed.
+ * Every slot has at most one request in flight, so the submission queue never overflows.
+ */
+class uring_backend : public async_file_writer::backend
+{
+public:
+    /**
+     * Returns nullptr if the kernel does not support io_uring (with IORING_OP_WRITE).
+     */
+    static std::unique_ptr<uring_backend> create(int fd, unsigned slot_count) {
+        io_uring_params params {};
+        int ring_fd = io_uring_setup(slot_count, &params);
+        if (ring_fd < 0) {
+            return nullptr;
+        }
+
+        // IORING_OP_WRITE was added together with IORING_FEAT_RW_CUR_POS (5.6)
+        if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+            ::close(ring_fd);
+            return nullptr;
+        }
+
+        std::unique_ptr<uring_backend> backend(new uring_backend(fd, ring_fd, slot_count));
+        if (!backend->map_rings(params)) {
+            backend->m_fd = -1; // the file stays open for the fallback backend
+            return nullptr;
+        }
+
+        return backend;
+    }
+
+    ~uring_backend() override {
+        // the kernel may still read from the slots' memory, so drain before releasing anything,
+        // nothing was submitted if the rings could not be mapped
+        for (unsigned slot{}; m_cq_head && slot < m_slots.size(); ++slot) {
+            try {
+                wait(slot);
+            } catch (...) {
+            }
+        }
+
+        if (m_sqes) {
+            ::munmap(m_sqes, m_sqes_size);
+        }
+        if (m_cq_ring && m_cq_ring != m_sq_ring) {
+            ::munmap(m_cq_ring, m_cq_ring_size);
+        }
+        if (m_sq_ring) {
+            ::munmap(m_sq_ring, m_sq_ring_size);
+        }
+        ::close(m_ring_fd);
+
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+
+    void write(unsigned slot, const uint8_t* data, std::size_t size, uint64_t offset) override {
+        m_slots[slot] = {data, size, offset, true, false};
+        submit(slot);
+    }
+
+    void wait(unsigned slot) override {
+        reap();
+        while (m_slots[slot].busy) {
+            int result = io_uring_enter(m_ring_fd, 0, 1, IORING_ENTER_GETEVENTS);
+            if (result < 0 && errno != EINTR) {
+                m_slots[slot].busy = false;
+                throw_write_failure();
+            }
+            reap();
+        }
+
+        if (m_slots[slot].failed) {
+            m_slots[slot].failed = false;
+            throw_write_failure();
+        }
+    }
+
+    void close() override {
+        for (unsigned slot{}; slot < m_slots.size(); ++slot) {
+            wait(slot);
+        }
+
+        int fd = m_fd;
+        m_fd = -1;
+        if (::close(fd) != 0) {
+            throw_write_failure();
+        }
+    }
+
+    const char* name() const override { return "io_uring"; }
+
+private:
+    uring_backend(int fd, int ring_fd, unsigned slot_count)
+        : m_fd(fd)
+        , m_ring_fd(ring_fd)
+        , m_slots(slot_count)
+    {
+    }
+
+    bool map_rings(const io_uring_params& params) {
+        m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            m_sq_ring_size = m_cq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+        }
+
+        m_sq_ring = map(m_sq_ring_size, IORING_OFF_SQ_RING);
+        if (!m_sq_ring) {
+            return false;
+        }
+
+        m_cq_ring = (params.features & IORING_FEAT_SINGLE_MMAP) ? m_sq_ring : map(m_cq_ring_size, IORING_OFF_CQ_RING);
+        if (!m_cq_ring) {
+            return false;
+        }
+
+        m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        m_sqes = static_cast<io_uring_sqe*>(map(m_sqes_size, IORING_OFF_SQES));
+        if (!m_sqes) {
+            return false;
+        }
+
+        auto sq = static_cast<uint8_t*>(m_sq_ring);
+        m_sq_tail  = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        m_sq_mask  = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        m_sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        auto cq = static_cast<uint8_t*>(m_cq_ring);
+        m_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        m_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        m_cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        m_cqes    = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        return true;
+    }
+
+    void* map(std::size_t size, off_t offset) {
+        void* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, offset);
+        return memory == MAP_FAILED ? nullptr : memory;
+    }
+
+    void submit(unsigned slot_index) {
+        const auto& slot = m_slots[slot_index];
+
+        unsigned tail = *m_sq_tail;
+        unsigned index = tail & *m_sq_mask;
+
+        io_uring_sqe& sqe = m_sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_WRITE;
+        sqe.fd = m_fd;
+        sqe.addr = reinterpret_cast<uint64_t>(slot.data);
+        sqe.len = static_cast<uint32_t>(std::min<std::size_t>(slot.size, 1u << 30));
+        sqe.off = slot.offset;
+        sqe.user_data = slot_index;
+
+        m_sq_array[index] = index;
+        std::atomic_ref<unsigned>(*m_sq_tail).store(tail + 1, std::memory_order_release);
+
+        int result {};
+        do {
+            result = io_uring_enter(m_ring_fd, 1, 0, 0);
+        } while (result < 0 && errno == EINTR);
+
+        if (result != 1) {
+            m_slots[slot_index].busy = false;
+            throw_write_failure();
+        }
+    }
+
+    void reap() {
+        unsigned head = *m_cq_head;
+        unsigned tail = std::atomic_ref<unsigned>(*m_cq_tail).load(std::memory_order_acquire);
+
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = m_cqes[head & *m_cq_mask];
+            auto& slot = m_slots[cqe.user_data];
+
+            if (cqe.res <= 0) {
+                slot.busy = false;
+                slot.failed = true;
+                continue;
+            }
+
+            slot.advance(static_cast<std::size_t>(cqe.res));
+            if (slot.size == 0) {
+                slot.busy = false;
+            } else {
+                m_pending_resubmit.push_back(static_cast<unsigned>(cqe.user_data));
+            }
+        }
+        std::atomic_ref<unsigned>(*m_cq_head).store(head, std::memory_order_release);
+
+        // short writes are continued once the completion queue entries are consumed
+        while (!m_pending_resubmit.empty()) {
+            unsigned slot_index = m_pending_resubmit.back();
+            m_pending_resubmit.pop_back();
+            submit(slot_index);
+        }
+    }
+
+    int m_fd;
+    int m_ring_fd;
+    std::vector<slot_state> m_slots;
+    std::vector<unsigned> m_pending_resubmit;
+
+    void* m_sq_ring {};
+    std::size_t m_sq_ring_size {};
+    void* m_cq_ring {};
+    std::size_t m_cq_ring_size {};
+    io_uring_sqe* m_sqes {};
+    std::size_t m_sqes_size {};
+
+    unsigned* m_sq_tail {};
+    unsigned* m_sq_mask {};
+    unsigned* m_sq_array {};
+    unsigned* m_cq_head {};
+    unsigned* m_cq_tail {};
+    unsigned* m_cq_mask {};
+    io_uring_cqe* m_cqes {};
+};
+
+#endif
+
+}// namespace
+
+async_file_writer::async_file_writer(const std::string& file_path, unsigned slot_count)
+{
+#if defined(_WIN32)
+    m_backend = std::make_unique<overlapped_backend>(file_path, slot_count);
+#else
+    int fd = open_for_writing(file_path);
+#if defined(__linux__)
+    m_backend = uring_backend::create(fd, slot_count);
+#endif
+    if (!m_backend) {
+        m_backend = std::make_unique<thread_backend>(fd, slot_count);
+    }
+#endif
+}
+
+async_file_writer::~async_file_writer() = default;
+
+void async_file_writer::write(unsigned slot, const uint8_t* data, std::size_t size, uint64_t offset)
+{
+    m_backend->write(slot, data, size, offset);
+}
+
+void async_file_writer::wait(unsigned slot)
+{
+    m_backend->wait(slot);
+}
+
+void async_file_writer::close()
+{
+    m_backend->close();
+}
+
+const char* async_file_writer::backend_name() const
+{
+    return m_backend->name();
+}
+
+}// namespace wavegen
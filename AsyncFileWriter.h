@@ -0,0 +1,63 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Writes blocks to a file asynchronously, so new blocks can be generated while
+ *          earlier ones are still being written.
+ */
+#ifndef ASYNC_FILE_WRITER_H_
+#define ASYNC_FILE_WRITER_H_
+
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace wavegen
+{
+
+/**
+ * Asynchronous file writer with a fixed number of write slots. Every slot holds at most
+ * one write in flight; its memory has to stay untouched until wait() returns for the slot.
+ *
+ * Backends: io_uring on Linux, overlapped WriteFile on Windows. Where io_uring is not
+ * available (old kernels, sandboxes) writes are handed to a background thread instead.
+ * Throws std::ofstream::failure if the file cannot be opened or written.
+ */
+class async_file_writer
+{
+public:
+    async_file_writer(const std::string& file_path, unsigned slot_count);
+    ~async_file_writer();
+
+    async_file_writer(const async_file_writer&) = delete;
+    async_file_writer& operator=(const async_file_writer&) = delete;
+
+    /**
+     * Starts writing size bytes of data at the given file offset. The slot has to be idle.
+     */
+    void write(unsigned slot, const uint8_t* data, std::size_t size, uint64_t offset);
+
+    /**
+     * Blocks until the write of the given slot has completed. Returns at once for an idle slot.
+     */
+    void wait(unsigned slot);
+
+    /**
+     * Waits for all writes and closes the file.
+     */
+    void close();
+
+    /**
+     * Returns the name of the backend in use.
+     */
+    const char* backend_name() const;
+
+    class backend;
+
+private:
+    std::unique_ptr<backend> m_backend;
+};
+
+}// namespace wavegen
+
+#endif // ASYNC_FILE_WRITER_H_
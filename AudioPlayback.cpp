@@ -0,0 +1,403 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Plays packed frames from a lock-free ring buffer on an audio device.
+ */
+#include "AudioPlayback.h"
+
+#include <chrono>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <mmdeviceapi.h>
+#include <audioclient.h>
+#pragma comment(lib, "ole32.lib")
+#else
+#include <cerrno>
+#include <dlfcn.h>
+#endif
+
+namespace wavegen
+{
+
+namespace
+{
+
+// Periods per device buffer, the callback runs once per period.
+constexpr unsigned k_period_count {4};
+
+/**
+ * Returns the frames of a period of the device buffer.
+ */
+std::size_t get_period_frames(const wave_format& format, double latency_sec)
+{
+    return std::max<std::size_t>(1, static_cast<std::size_t>(format.sample_rate * latency_sec / k_period_count));
+}
+
+[[noreturn]] void throw_playback_failure(const std::string& reason)
+{
+    throw std::runtime_error("Playback failed. " + reason);
+}
+
+#if !defined(_WIN32)
+
+/**
+ * The part of the ALSA API playback needs, resolved from libasound at run time.
+ * The values are those of the stable ALSA ABI.
+ */
+struct alsa_api
+{
+    static constexpr int k_stream_playback {0};         // SND_PCM_STREAM_PLAYBACK
+    static constexpr int k_format_float_le {14};        // SND_PCM_FORMAT_FLOAT_LE
+    static constexpr int k_format_s24_3le {32};         // SND_PCM_FORMAT_S24_3LE
+    static constexpr int k_access_rw_interleaved {3};   // SND_PCM_ACCESS_RW_INTERLEAVED
+
+    alsa_api()
+    {
+        m_library = ::dlopen("libasound.so.2", RTLD_NOW | RTLD_LOCAL);
+        if (!m_library) {
+            throw_playback_failure("ALSA is not available, libasound.so.2 could not be loaded.");
+        }
+
+        bool resolved = resolve(pcm_open, "snd_pcm_open") && resolve(pcm_set_params, "snd_pcm_set_params")
+                        && resolve(pcm_writei, "snd_pcm_writei") && resolve(pcm_recover, "snd_pcm_recover")
+                        && resolve(pcm_drain, "snd_pcm_drain") && resolve(pcm_close, "snd_pcm_close")
+                        && resolve(strerror, "snd_strerror");
+        if (!resolved) {
+            ::dlclose(m_library);
+            throw_playback_failure("ALSA is not available, libasound.so.2 lacks the PCM API.");
+        }
+    }
+
+    ~alsa_api() { ::dlclose(m_library); }
+
+    alsa_api(const alsa_api&) = delete;
+    alsa_api& operator=(const alsa_api&) = delete;
+
+    int (*pcm_open)(void** pcm, const char* name, int stream, int mode) {};
+    int (*pcm_set_params)(void* pcm, int format, int access, unsigned channels, unsigned rate, int soft_resample, unsigned latency_us) {};
+    long (*pcm_writei)(void* pcm, const void* buffer, unsigned long frames) {};
+    int (*pcm_recover)(void* pcm, int error, int silent) {};
+    int (*pcm_drain)(void* pcm) {};
+    int (*pcm_close)(void* pcm) {};
+    const char* (*strerror)(int error) {};
+
+private:
+    template <typename Function>
+    bool resolve(Function& function, const char* name)
+    {
+        function = reinterpret_cast<Function>(::dlsym(m_library, name));
+        return function != nullptr;
+    }
+
+    void* m_library {};
+};
+
+#endif
+
+}// namespace
+
+audio_playback::audio_playback(const std::string& device_name, const wave_format& format, double latency_sec,
+                               spsc_ring_buffer<uint8_t>& ring)
+    : m_format(format)
+    , m_ring(ring)
+{
+    if (latency_sec <= 0.0) {
+        throw std::invalid_argument("Invalid argument. Playback latency should be greater than 0.");
+    }
+
+    m_thread = std::thread([this, device_name, latency_sec] { run(device_name, latency_sec); });
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_state_changed.wait(lock, [this] { return m_opened || m_error; });
+    if (m_error) {
+        lock.unlock();
+        m_thread.join();
+        std::rethrow_exception(m_error);
+    }
+}
+
+audio_playback::~audio_playback()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_state_changed.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void audio_playback::start()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_started = true;
+    }
+    m_state_changed.notify_all();
+}
+
+void audio_playback::finish()
+{
+    m_finished.store(true, std::memory_order_release);
+    start();
+    m_thread.join();
+
+    if (m_error) {
+        std::rethrow_exception(m_error);
+    }
+}
+
+void audio_playback::run(const std::string& device_name, double latency_sec)
+{
+    try {
+        if (device_name == "null") {
+            play_null(latency_sec);
+        } else {
+#if defined(_WIN32)
+            if (device_name != "default") {
+                throw_playback_failure("Only the default device is supported by WASAPI playback.");
+            }
+            play_wasapi(latency_sec);
+#else
+            play_alsa(device_name, latency_sec);
+#endif
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_error = std::current_exception();
+        m_failed.store(true, std::memory_order_release);
+    }
+    m_state_changed.notify_all();
+}
+
+bool audio_playback::fill_period(uint8_t* out, std::size_t size)
+{
+    // once finished, everything still in the ring is the end of the data
+    bool finished = m_finished.load(std::memory_order_acquire);
+    auto read_size = m_ring.read(out, size);
+    if (read_size < size) {
+        std::memset(out + read_size, 0, size - read_size);
+        if (!finished) {
+            m_underrun_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    return !(finished && read_size == 0) && !m_stopping.load(std::memory_order_relaxed);
+}
+
+void audio_playback::wait_started()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_opened = true;
+    }
+    m_state_changed.notify_all();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_state_changed.wait(lock, [this] { return m_started || m_stopping; });
+}
+
+void audio_playback::play_null(double latency_sec)
+{
+    m_backend_name = "null";
+    auto period_frames = get_period_frames(m_format, latency_sec);
+    std::vector<uint8_t> period(period_frames * get_frame_size());
+    auto period_duration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(period_frames) / m_format.sample_rate));
+
+    wait_started();
+
+    // consumes one period per period duration, as a device clock would
+    auto next_period = std::chrono::steady_clock::now();
+    while (fill_period(period.data(), period.size())) {
+        next_period += period_duration;
+        std::this_thread::sleep_until(next_period);
+    }
+}
+
+#if defined(_WIN32)
+
+void audio_playback::play_alsa(const std::string&, double)
+{
+    throw_playback_failure("ALSA is not available on Windows.");
+}
+
+namespace
+{
+
+/**
+ * Owns one reference of a COM interface.
+ */
+template <typename Interface>
+struct com_ref
+{
+    ~com_ref() { if (pointer) pointer->Release(); }
+
+    Interface* operator->() const { return pointer; }
+
+    Interface* pointer {};
+};
+
+void check_result(HRESULT result, const char* call)
+{
+    if (FAILED(result)) {
+        throw_playback_failure(std::string("WASAPI call ") + call + " failed.");
+    }
+}
+
+}// namespace
+
+void audio_playback::play_wasapi(double latency_sec)
+{
+    m_backend_name = "wasapi";
+
+    HRESULT co_result = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    check_result(co_result, "CoInitializeEx");
+
+    struct co_uninitializer { ~co_uninitializer() { CoUninitialize(); } } uninitialize;
+
+    com_ref<IMMDeviceEnumerator> enumerator;
+    check_result(CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL, __uuidof(IMMDeviceEnumerator),
+                                  reinterpret_cast<void**>(&enumerator.pointer)), "CoCreateInstance");
+
+    com_ref<IMMDevice> device;
+    check_result(enumerator->GetDefaultAudioEndpoint(eRender, eConsole, &device.pointer), "GetDefaultAudioEndpoint");
+
+    com_ref<IAudioClient> client;
+    check_result(device->Activate(__uuidof(IAudioClient), CLSCTX_ALL, nullptr, reinterpret_cast<void**>(&client.pointer)), "Activate");
+
+    WAVEFORMATEX format{};
+    format.wFormatTag = m_format.sample_format == sample_format::ieee_float ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM;
+    format.nChannels = m_format.channel_count;
+    format.nSamplesPerSec = m_format.sample_rate;
+    format.wBitsPerSample = m_format.bits_per_sample;
+    format.nBlockAlign = static_cast<WORD>(get_frame_size());
+    format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
+
+    // the shared mode engine converts the format of the frames to the one of the endpoint
+    auto buffer_duration = static_cast<REFERENCE_TIME>(latency_sec * 1e7);
+    DWORD flags = AUDCLNT_STREAMFLAGS_EVENTCALLBACK | AUDCLNT_STREAMFLAGS_AUTOCONVERTPCM | AUDCLNT_STREAMFLAGS_SRC_DEFAULT_QUALITY;
+    check_result(client->Initialize(AUDCLNT_SHAREMODE_SHARED, flags, buffer_duration, 0, &format, nullptr), "Initialize");
+
+    HANDLE event = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+    if (!event) {
+        throw_playback_failure("Failed to create the WASAPI event.");
+    }
+    struct event_closer { HANDLE event; ~event_closer() { CloseHandle(event); } } close_event {event};
+    check_result(client->SetEventHandle(event), "SetEventHandle");
+
+    UINT32 buffer_frames{};
+    check_result(client->GetBufferSize(&buffer_frames), "GetBufferSize");
+
+    com_ref<IAudioRenderClient> render;
+    check_result(client->GetService(__uuidof(IAudioRenderClient), reinterpret_cast<void**>(&render.pointer)), "GetService");
+
+    wait_started();
+    check_result(client->Start(), "Start");
+
+    // the event signals a period of the buffer was played, the free part is refilled
+    bool playing = true;
+    while (playing) {
+        if (WaitForSingleObject(event, 2000) != WAIT_OBJECT_0) {
+            client->Stop();
+            throw_playback_failure("The WASAPI device stopped requesting data.");
+        }
+
+        UINT32 padding{};
+        check_result(client->GetCurrentPadding(&padding), "GetCurrentPadding");
+        UINT32 frame_count = buffer_frames - padding;
+        if (frame_count == 0) {
+            continue;
+        }
+
+        BYTE* data{};
+        check_result(render->GetBuffer(frame_count, &data), "GetBuffer");
+        playing = fill_period(data, static_cast<std::size_t>(frame_count) * get_frame_size());
+        check_result(render->ReleaseBuffer(frame_count, 0), "ReleaseBuffer");
+    }
+
+    // lets the buffered frames play out
+    UINT32 padding{};
+    while (!m_stopping && SUCCEEDED(client->GetCurrentPadding(&padding)) && padding > 0) {
+        WaitForSingleObject(event, 2000);
+    }
+    client->Stop();
+}
+
+#else
+
+void audio_playback::play_wasapi(double)
+{
+    throw_playback_failure("WASAPI is only available on Windows.");
+}
+
+void audio_playback::play_alsa(const std::string& device_name, double latency_sec)
+{
+    m_backend_name = "alsa";
+
+    int format = alsa_api::k_format_s24_3le;
+    if (m_format.sample_format == sample_format::ieee_float && m_format.bits_per_sample == 32) {
+        format = alsa_api::k_format_float_le;
+    } else if (m_format.sample_format != sample_format::pcm || m_format.bits_per_sample != 24) {
+        throw_playback_failure("ALSA playback supports 24 bit PCM and 32 bit float frames.");
+    }
+
+    alsa_api alsa;
+    void* pcm{};
+    int result = alsa.pcm_open(&pcm, device_name.c_str(), alsa_api::k_stream_playback, 0);
+    if (result < 0) {
+        throw_playback_failure("Failed to open ALSA device " + device_name + ": " + alsa.strerror(result));
+    }
+
+    struct pcm_closer { alsa_api& alsa; void* pcm; ~pcm_closer() { alsa.pcm_close(pcm); } } close_pcm {alsa, pcm};
+
+    result = alsa.pcm_set_params(pcm, format, alsa_api::k_access_rw_interleaved, m_format.channel_count, m_format.sample_rate, 1,
+                                 static_cast<unsigned>(latency_sec * 1e6));
+    if (result < 0) {
+        throw_playback_failure("Failed to configure ALSA device " + device_name + ": " + alsa.strerror(result));
+    }
+
+    auto period_frames = get_period_frames(m_format, latency_sec);
+    std::vector<uint8_t> period(period_frames * get_frame_size());
+
+    wait_started();
+
+    // writei blocks until the period fits the device buffer, this thread is the callback
+    while (fill_period(period.data(), period.size())) {
+        const uint8_t* frames = period.data();
+        for (auto frame_count = period_frames; frame_count > 0;) {
+            auto written = alsa.pcm_writei(pcm, frames, frame_count);
+            if (written < 0) {
+                if (written == -EPIPE) {
+                    m_underrun_count.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                result = alsa.pcm_recover(pcm, static_cast<int>(written), 1);
+                if (result < 0) {
+                    throw_playback_failure(std::string("ALSA device failed while playing: ") + alsa.strerror(result));
+                }
+                continue;
+            }
+
+            frames += written * get_frame_size();
+            frame_count -= static_cast<std::size_t>(written);
+        }
+    }
+
+    if (!m_stopping) {
+        alsa.pcm_drain(pcm);
+    }
+}
+
+#endif
+
+}// namespace wavegen
@@ -0,0 +1,102 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Plays packed frames from a lock-free ring buffer on an audio device.
+ */
+#ifndef AUDIO_PLAYBACK_H_
+#define AUDIO_PLAYBACK_H_
+
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include <exception>
+#include <condition_variable>
+
+#include "WaveFormat.h"
+#include "RingBuffer.h"
+
+namespace wavegen
+{
+
+/**
+ * Plays the frames a generator thread writes into a ring buffer. A device thread runs the
+ * audio callback, which only ever copies whole periods out of the ring: it never allocates,
+ * locks or computes a sample. A period the ring cannot fill is padded with silence and
+ * counted as an underrun.
+ *
+ * Devices: "default" or an ALSA device name, played through ALSA on Linux (which PipeWire and
+ * PulseAudio serve as well), or the default WASAPI endpoint on Windows. libasound is loaded at
+ * run time, so it is neither needed to build nor to render files. "null" plays in real time
+ * into nothing, on any platform, for testing without a sound card.
+ * Throws std::runtime_error if the device cannot be opened or fails while playing.
+ */
+class audio_playback
+{
+public:
+    /**
+     * Opens the device for the format of the ring's frames. latency_sec is the device buffer
+     * the callback fills, the ring should hold at least twice as much.
+     */
+    audio_playback(const std::string& device_name, const wave_format& format, double latency_sec,
+                   spsc_ring_buffer<uint8_t>& ring);
+    ~audio_playback();
+
+    audio_playback(const audio_playback&) = delete;
+    audio_playback& operator=(const audio_playback&) = delete;
+
+    /**
+     * Starts playing; the ring should have been filled up before.
+     */
+    void start();
+
+    /**
+     * Marks the end of the data and blocks until all of it has been played.
+     * Rethrows the error of a failed device.
+     */
+    void finish();
+
+    /**
+     * True once the device stopped playing because of an error, the generator should stop then.
+     */
+    bool failed() const { return m_failed.load(std::memory_order_acquire); }
+
+    uint64_t underrun_count() const { return m_underrun_count.load(std::memory_order_relaxed); }
+
+    const char* backend_name() const { return m_backend_name; }
+
+private:
+    void run(const std::string& device_name, double latency_sec);
+    void play_null(double latency_sec);
+    void play_alsa(const std::string& device_name, double latency_sec);
+    void play_wasapi(double latency_sec);
+
+    // The audio callback. Fills a period from the ring, false once all data has been played.
+    bool fill_period(uint8_t* out, std::size_t size);
+
+    // Reports the device open and blocks until start() or the destructor.
+    void wait_started();
+
+    uint32_t get_frame_size() const { return m_format.channel_count * m_format.bits_per_sample / 8u; }
+
+    wave_format m_format;
+    spsc_ring_buffer<uint8_t>& m_ring;
+    const char* m_backend_name {"null"};
+
+    std::mutex m_mutex;
+    std::condition_variable m_state_changed;
+    bool m_opened {};
+    bool m_started {};
+    std::exception_ptr m_error;
+
+    std::atomic<bool> m_finished {};
+    std::atomic<bool> m_stopping {};
+    std::atomic<bool> m_failed {};
+    std::atomic<uint64_t> m_underrun_count {};
+    std::thread m_thread;
+};
+
+}// namespace wavegen
+
+#endif // AUDIO_PLAYBACK_H_
@@ -0,0 +1,204 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   A list of wave files to render in one batch, read from a CSV or JSON lines manifest.
+ */
+#include "BatchManifest.h"
+
+#include <algorithm>
+#include <fstream>
+#include <utility>
+#include <stdexcept>
+
+namespace wavegen
+{
+
+namespace
+{
+
+std::string trim(const std::string& text)
+{
+    auto begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return {};
+    }
+
+    auto end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+std::string unquote(const std::string& text)
+{
+    if (text.size() >= 2 && text.front() == '"' && text.back() == '"') {
+        return text.substr(1, text.size() - 2);
+    }
+
+    return text;
+}
+
+std::invalid_argument invalid_json(std::size_t line_number)
+{
+    return std::invalid_argument("Invalid manifest. Line " + std::to_string(line_number) + " is not a valid JSON object.");
+}
+
+/**
+ * Parses the string starting at the quote at pos, returns it without its quotes and moves pos past it.
+ * Only the escapes \" \\ and \/ are understood, which covers file paths.
+ */
+std::string parse_json_string(const std::string& line, std::size_t& pos, std::size_t line_number)
+{
+    std::string value;
+    for (++pos; pos < line.size() && line[pos] != '"'; ++pos) {
+        if (line[pos] == '\\' && pos + 1 < line.size()) {
+            ++pos;
+        }
+        value += line[pos];
+    }
+
+    if (pos >= line.size()) {
+        throw std::invalid_argument("Invalid manifest. Line " + std::to_string(line_number) + " has an unterminated string.");
+    }
+
+    ++pos;
+    return value;
+}
+
+/**
+ * Returns the value of a key of a flat JSON object, strings without their quotes. The object is
+ * parsed member by member, so a key name inside a string value is not mistaken for the key.
+ */
+std::string json_value(const std::string& line, const std::string& key, std::size_t line_number)
+{
+    auto skip_space = [&](std::size_t pos) { return std::min(line.find_first_not_of(" \t", pos), line.size()); };
+
+    auto pos = skip_space(1);
+    if (pos < line.size() && line[pos] == '}') {
+        pos = line.size();
+    }
+
+    while (pos < line.size()) {
+        if (line[pos] != '"') {
+            throw invalid_json(line_number);
+        }
+        auto name = parse_json_string(line, pos, line_number);
+
+        pos = skip_space(pos);
+        if (pos >= line.size() || line[pos] != ':') {
+            throw invalid_json(line_number);
+        }
+
+        pos = skip_space(pos + 1);
+        if (pos >= line.size() || line[pos] == '{' || line[pos] == '[') {
+            throw invalid_json(line_number);
+        }
+
+        std::string value;
+        if (line[pos] == '"') {
+            value = parse_json_string(line, pos, line_number);
+        } else {
+            auto end = std::min(line.find_first_of(",} \t", pos), line.size());
+            value = line.substr(pos, end - pos);
+            pos = end;
+        }
+
+        if (name == key) {
+            return value;
+        }
+
+        pos = skip_space(pos);
+        if (pos >= line.size() || line[pos] == '}') {
+            break;
+        }
+        if (line[pos] != ',') {
+            throw invalid_json(line_number);
+        }
+        pos = skip_space(pos + 1);
+    }
+
+    throw std::invalid_argument("Invalid manifest. Line " + std::to_string(line_number) + " has no \"" + key + "\".");
+}
+
+/**
+ * Returns whether all of text parses as a number, the way make_job reads it.
+ */
+bool is_number(const std::string& text)
+{
+    try {
+        std::size_t end{};
+        std::stod(text, &end);
+        return end == text.size();
+    } catch (const std::exception& e) {
+        return false;
+    }
+}
+
+batch_job make_job(const std::string& frequency, const std::string& length, const std::string& path, std::size_t line_number)
+{
+    batch_job job{};
+
+    try {
+        std::size_t frequency_end{}, length_end{};
+        job.wave_frequency = std::stod(frequency, &frequency_end);
+        job.file_length_sec = std::stod(length, &length_end);
+        if (frequency_end != frequency.size() || length_end != length.size()) {
+            throw std::invalid_argument(frequency);
+        }
+    } catch (const std::exception& e) {
+        throw std::invalid_argument("Invalid manifest. Enter valid numbers for wave frequency and file length on line " 
+                                    + std::to_string(line_number) + ".");
+    }
+
+    if (path.empty()) {
+        throw std::invalid_argument("Invalid manifest. Line " + std::to_string(line_number) + " has no output path.");
+    }
+    job.file_path = path;
+
+    return job;
+}
+
+}// namespace
+
+std::vector<batch_job> read_manifest(const std::string& manifest_path)
+{
+    std::ifstream manifest(manifest_path);
+    if (!manifest.is_open()) {
+        throw std::ifstream::failure("Batch generation failed. Failed to open manifest " + manifest_path);
+    }
+
+    std::vector<batch_job> jobs;
+    std::string line;
+    bool first_line {true};
+    for (std::size_t line_number{1}; std::getline(manifest, line); ++line_number) {
+        line = trim(line);
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+
+        bool header_allowed = std::exchange(first_line, false);
+
+        if (line.front() == '{') {
+            jobs.push_back(make_job(json_value(line, "frequency", line_number), json_value(line, "length", line_number), 
+                                    json_value(line, "path", line_number), line_number));
+            continue;
+        }
+
+        auto first_comma = line.find(',');
+        auto second_comma = first_comma == std::string::npos ? first_comma : line.find(',', first_comma + 1);
+        if (second_comma == std::string::npos) {
+            throw std::invalid_argument("Invalid manifest. Line " + std::to_string(line_number) 
+                                        + " should hold a frequency, a length and an output path.");
+        }
+
+        auto frequency = trim(line.substr(0, first_comma));
+        if (header_allowed && !is_number(frequency)) {
+            continue; // header line, any other line has to hold a job
+        }
+
+        jobs.push_back(make_job(frequency, trim(line.substr(first_comma + 1, second_comma - first_comma - 1)), 
+                                unquote(trim(line.substr(second_comma + 1))), line_number));
+    }
+
+    return jobs;
+}
+
+}// namespace wavegen
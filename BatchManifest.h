@@ -0,0 +1,38 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   A list of wave files to render in one batch, read from a CSV or JSON lines manifest.
+ */
+#ifndef BATCH_MANIFEST_H_
+#define BATCH_MANIFEST_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace wavegen
+{
+
+/**
+ * A single wave file of a batch.
+ */
+struct batch_job
+{
+    double wave_frequency {};      // Hz, may be fractional
+    double file_length_sec {};
+    std::string file_path;
+};
+
+/**
+ * Reads the jobs of a manifest file, one job per line. A line is either CSV:
+ *     frequency,length,path
+ * or a JSON object:
+ *     {"frequency": 440, "length": 2.5, "path": "a440.wav"}
+ * Blank lines and lines starting with '#' are skipped, as is a CSV header line at the top.
+ * Throws on a malformed line, naming its line number.
+ */
+std::vector<batch_job> read_manifest(const std::string& manifest_path);
+
+}// namespace wavegen
+
+#endif // BATCH_MANIFEST_H_
@@ -0,0 +1,98 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Runtime detection of the SIMD instruction sets used by the vectorised kernels.
+ */
+#include "CpuFeatures.h"
+
+#if defined(WAVEGEN_X86) && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace wavegen
+{
+
+namespace
+{
+
+struct cpu_feature_flags
+{
+    bool ssse3 {};
+    bool avx2 {};
+    bool avx512 {};
+    bool neon {};
+};
+
+cpu_feature_flags detect_cpu_features()
+{
+    cpu_feature_flags flags{};
+
+#if defined(WAVEGEN_X86) && defined(_MSC_VER) && !defined(__clang__)
+    int info[4] {};
+    __cpuid(info, 0);
+    int max_leaf = info[0];
+
+    __cpuid(info, 1);
+    bool ssse3   = (info[2] & (1 << 9)) != 0;
+    bool fma     = (info[2] & (1 << 12)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx     = (info[2] & (1 << 28)) != 0;
+
+    // the OS has to save the AVX (and AVX-512) registers on context switches
+    unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    bool os_avx    = (xcr0 & 0x06) == 0x06;
+    bool os_avx512 = (xcr0 & 0xE6) == 0xE6;
+
+    int leaf7_ebx {};
+    if (max_leaf >= 7) {
+        __cpuidex(info, 7, 0);
+        leaf7_ebx = info[1];
+    }
+
+    flags.ssse3  = ssse3;
+    flags.avx2   = avx && fma && os_avx && (leaf7_ebx & (1 << 5)) != 0;
+    flags.avx512 = os_avx512 && (leaf7_ebx & (1 << 16)) != 0 && (leaf7_ebx & (1 << 30)) != 0;
+#elif defined(WAVEGEN_X86)
+    __builtin_cpu_init();
+    flags.ssse3  = __builtin_cpu_supports("ssse3");
+    flags.avx2   = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    flags.avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#elif defined(WAVEGEN_NEON)
+    flags.neon = true; // Advanced SIMD is mandatory on AArch64
+#endif
+
+    return flags;
+}
+
+}// namespace
+
+bool cpu_supports(simd_isa isa)
+{
+    static const cpu_feature_flags flags = detect_cpu_features();
+
+    switch (isa) {
+        case simd_isa::scalar: return true;
+        case simd_isa::ssse3:  return flags.ssse3;
+        case simd_isa::avx2:   return flags.avx2;
+        case simd_isa::avx512: return flags.avx512;
+        case simd_isa::neon:   return flags.neon;
+    }
+
+    return false;
+}
+
+const char* simd_isa_name(simd_isa isa)
+{
+    switch (isa) {
+        case simd_isa::scalar: return "scalar";
+        case simd_isa::ssse3:  return "ssse3";
+        case simd_isa::avx2:   return "avx2";
+        case simd_isa::avx512: return "avx512";
+        case simd_isa::neon:   return "neon";
+    }
+
+    return "unknown";
+}
+
+}// namespace wavegen
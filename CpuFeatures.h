@@ -0,0 +1,50 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Runtime detection of the SIMD instruction sets used by the vectorised kernels.
+ */
+#ifndef CPU_FEATURES_H_
+#define CPU_FEATURES_H_
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define WAVEGEN_X86 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define WAVEGEN_NEON 1
+#endif
+
+// Enables an instruction set for a single function, so kernels can be dispatched at runtime
+// without compiling the whole program for that instruction set. MSVC needs no annotation.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define WAVEGEN_TARGET(isa)
+#else
+#define WAVEGEN_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace wavegen
+{
+
+/**
+ * Instruction sets the vectorised kernels are specialised for.
+ */
+enum class simd_isa
+{
+    scalar,
+    ssse3,      // x86 SSSE3 (pshufb)
+    avx2,       // x86 AVX2 + FMA
+    avx512,     // x86 AVX-512 F + BW
+    neon        // AArch64 Advanced SIMD
+};
+
+/**
+ * Returns true if the running CPU (and OS) supports the given instruction set.
+ */
+bool cpu_supports(simd_isa isa);
+
+/**
+ * Returns a printable name of the given instruction set.
+ */
+const char* simd_isa_name(simd_isa isa);
+
+}// namespace wavegen
+
+#endif // CPU_FEATURES_H_
@@ -0,0 +1,244 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   TPDF dither and noise-shaped quantization of generated samples, driven by a
+ *          counter-based noise generator so the output does not depend on blocks or threads.
+ */
+#include "Dither.h"
+
+#include <cmath>
+#include <algorithm>
+#include <initializer_list>
+
+#if defined(WAVEGEN_X86)
+#include <immintrin.h>
+#elif defined(WAVEGEN_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace wavegen
+{
+
+namespace
+{
+
+constexpr double k_fraction_scale {1.0 / (1u << k_dither_fraction_bits)};  // Sample units per generated unit
+constexpr double k_noise_scale {1.0 / 65'536.0};                           // LSB per unit of the summed noise
+
+/**
+ * The kernels dither runs of samples whose indices share their high 32 bits, so the noise
+ * is hashed in 32 bit lanes: key_mix is get_dither_key_mix() of the run, first_index the
+ * low 32 bits of its first sample index.
+ */
+using dither_run = void (*)(const int32_t* in, std::size_t count, uint32_t key_mix, uint32_t first_index, int32_t* out);
+
+void dither_scalar_run(const int32_t* in, std::size_t count, uint32_t key_mix, uint32_t first_index, int32_t* out)
+{
+    for (std::size_t i{}; i < count; ++i) {
+        double value = in[i] * k_fraction_scale + get_tpdf_dither(hash_dither_noise((first_index + static_cast<uint32_t>(i)) ^ key_mix));
+        out[i] = static_cast<int32_t>(std::floor(value + 0.5));
+    }
+}
+
+/**
+ * A dither kernel of the given run kernel: splits the samples at every multiple of 2^32.
+ */
+template <dither_run Run>
+void dither_runs(const int32_t* in, std::size_t count, uint32_t key, uint64_t first_index, int32_t* out)
+{
+    while (count > 0) {
+        auto run = static_cast<std::size_t>(std::min<uint64_t>(count, (uint64_t{1} << 32) - (first_index & 0xFFFF'FFFF)));
+        Run(in, run, get_dither_key_mix(key, static_cast<uint32_t>(first_index >> 32)), static_cast<uint32_t>(first_index), out);
+
+        in += run;
+        out += run;
+        first_index += run;
+        count -= run;
+    }
+}
+
+#if defined(WAVEGEN_X86)
+
+/**
+ * 8 samples per iteration: the noise of 8 sample indices is hashed in 32 bit lanes,
+ * samples and noise are summed and rounded as two vectors of 4 doubles.
+ */
+WAVEGEN_TARGET("avx2")
+void dither_avx2_run(const int32_t* in, std::size_t count, uint32_t key_mix, uint32_t first_index, int32_t* out)
+{
+    const __m256i lane_offsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i key_lanes = _mm256_set1_epi32(static_cast<int32_t>(key_mix));
+    const __m256i low_mask = _mm256_set1_epi32(0xFFFF);
+    const __m256d fraction_scale = _mm256_set1_pd(k_fraction_scale);
+    const __m256d noise_scale = _mm256_set1_pd(k_noise_scale);
+    const __m256d half = _mm256_set1_pd(0.5);
+
+    std::size_t i{};
+    for (; i + 8 <= count; i += 8) {
+        __m256i x = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int32_t>(first_index + static_cast<uint32_t>(i))), lane_offsets);
+        x = _mm256_xor_si256(x, key_lanes);
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 17));
+        x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int32_t>(0xED5AD4BBu)));
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 11));
+        x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int32_t>(0xAC4C1B51u)));
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 15));
+        x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int32_t>(0x31848BABu)));
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 14));
+
+        __m256i noise = _mm256_sub_epi32(_mm256_add_epi32(_mm256_and_si256(x, low_mask), _mm256_srli_epi32(x, 16)), low_mask);
+        __m256i samples = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+
+        __m128i rounded[2];
+        for (int half_index{}; half_index < 2; ++half_index) {
+            __m128i sample_lanes = half_index == 0 ? _mm256_castsi256_si128(samples) : _mm256_extracti128_si256(samples, 1);
+            __m128i noise_lanes = half_index == 0 ? _mm256_castsi256_si128(noise) : _mm256_extracti128_si256(noise, 1);
+
+            __m256d value = _mm256_add_pd(_mm256_mul_pd(_mm256_cvtepi32_pd(sample_lanes), fraction_scale),
+                                          _mm256_mul_pd(_mm256_cvtepi32_pd(noise_lanes), noise_scale));
+            rounded[half_index] = _mm256_cvttpd_epi32(_mm256_floor_pd(_mm256_add_pd(value, half)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_set_m128i(rounded[1], rounded[0]));
+    }
+
+    dither_scalar_run(in + i, count - i, key_mix, first_index + static_cast<uint32_t>(i), out + i);
+}
+
+/**
+ * 16 samples per iteration, as the AVX2 kernel on 512 bit vectors.
+ */
+WAVEGEN_TARGET("avx512f")
+void dither_avx512_run(const int32_t* in, std::size_t count, uint32_t key_mix, uint32_t first_index, int32_t* out)
+{
+    const __m512i lane_offsets = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i key_lanes = _mm512_set1_epi32(static_cast<int32_t>(key_mix));
+    const __m512i low_mask = _mm512_set1_epi32(0xFFFF);
+    const __m512d fraction_scale = _mm512_set1_pd(k_fraction_scale);
+    const __m512d noise_scale = _mm512_set1_pd(k_noise_scale);
+    const __m512d half = _mm512_set1_pd(0.5);
+
+    std::size_t i{};
+    for (; i + 16 <= count; i += 16) {
+        __m512i x = _mm512_add_epi32(_mm512_set1_epi32(static_cast<int32_t>(first_index + static_cast<uint32_t>(i))), lane_offsets);
+        x = _mm512_xor_si512(x, key_lanes);
+        x = _mm512_xor_si512(x, _mm512_srli_epi32(x, 17));
+        x = _mm512_mullo_epi32(x, _mm512_set1_epi32(static_cast<int32_t>(0xED5AD4BBu)));
+        x = _mm512_xor_si512(x, _mm512_srli_epi32(x, 11));
+        x = _mm512_mullo_epi32(x, _mm512_set1_epi32(static_cast<int32_t>(0xAC4C1B51u)));
+        x = _mm512_xor_si512(x, _mm512_srli_epi32(x, 15));
+        x = _mm512_mullo_epi32(x, _mm512_set1_epi32(static_cast<int32_t>(0x31848BABu)));
+        x = _mm512_xor_si512(x, _mm512_srli_epi32(x, 14));
+
+        __m512i noise = _mm512_sub_epi32(_mm512_add_epi32(_mm512_and_si512(x, low_mask), _mm512_srli_epi32(x, 16)), low_mask);
+        __m512i samples = _mm512_loadu_si512(in + i);
+
+        __m256i rounded[2];
+        for (int half_index{}; half_index < 2; ++half_index) {
+            __m256i sample_lanes = _mm512_extracti64x4_epi64(samples, half_index);
+            __m256i noise_lanes = _mm512_extracti64x4_epi64(noise, half_index);
+
+            __m512d value = _mm512_add_pd(_mm512_mul_pd(_mm512_cvtepi32_pd(sample_lanes), fraction_scale),
+                                          _mm512_mul_pd(_mm512_cvtepi32_pd(noise_lanes), noise_scale));
+            value = _mm512_roundscale_pd(_mm512_add_pd(value, half), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+            rounded[half_index] = _mm512_cvttpd_epi32(value);
+        }
+        _mm512_storeu_si512(out + i, _mm512_inserti64x4(_mm512_castsi256_si512(rounded[0]), rounded[1], 1));
+    }
+
+    dither_scalar_run(in + i, count - i, key_mix, first_index + static_cast<uint32_t>(i), out + i);
+}
+
+#elif defined(WAVEGEN_NEON)
+
+/**
+ * 4 samples per iteration, rounded as two vectors of 2 doubles.
+ */
+void dither_neon_run(const int32_t* in, std::size_t count, uint32_t key_mix, uint32_t first_index, int32_t* out)
+{
+    const uint32_t offsets[4] = {0, 1, 2, 3};
+    const uint32x4_t lane_offsets = vld1q_u32(offsets);
+    const uint32x4_t key_lanes = vdupq_n_u32(key_mix);
+    const uint32x4_t low_mask = vdupq_n_u32(0xFFFF);
+
+    std::size_t i{};
+    for (; i + 4 <= count; i += 4) {
+        uint32x4_t x = veorq_u32(vaddq_u32(vdupq_n_u32(first_index + static_cast<uint32_t>(i)), lane_offsets), key_lanes);
+        x = vmulq_n_u32(veorq_u32(x, vshrq_n_u32(x, 17)), 0xED5AD4BBu);
+        x = vmulq_n_u32(veorq_u32(x, vshrq_n_u32(x, 11)), 0xAC4C1B51u);
+        x = vmulq_n_u32(veorq_u32(x, vshrq_n_u32(x, 15)), 0x31848BABu);
+        x = veorq_u32(x, vshrq_n_u32(x, 14));
+
+        int32x4_t noise = vsubq_s32(vreinterpretq_s32_u32(vaddq_u32(vandq_u32(x, low_mask), vshrq_n_u32(x, 16))),
+                                    vreinterpretq_s32_u32(low_mask));
+        int32x4_t samples = vld1q_s32(in + i);
+
+        float64x2_t low = vaddq_f64(vmulq_n_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(samples))), k_fraction_scale),
+                                    vmulq_n_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(noise))), k_noise_scale));
+        float64x2_t high = vaddq_f64(vmulq_n_f64(vcvtq_f64_s64(vmovl_s32(vget_high_s32(samples))), k_fraction_scale),
+                                     vmulq_n_f64(vcvtq_f64_s64(vmovl_s32(vget_high_s32(noise))), k_noise_scale));
+
+        int32x2_t rounded_low = vmovn_s64(vcvtq_s64_f64(vrndmq_f64(vaddq_f64(low, vdupq_n_f64(0.5)))));
+        int32x2_t rounded_high = vmovn_s64(vcvtq_s64_f64(vrndmq_f64(vaddq_f64(high, vdupq_n_f64(0.5)))));
+        vst1q_s32(out + i, vcombine_s32(rounded_low, rounded_high));
+    }
+
+    dither_scalar_run(in + i, count - i, key_mix, first_index + static_cast<uint32_t>(i), out + i);
+}
+
+#endif
+
+}// namespace
+
+dither_kernel get_dither_kernel(simd_isa isa)
+{
+    if (!cpu_supports(isa)) {
+        return nullptr;
+    }
+
+    switch (isa) {
+        case simd_isa::scalar: return dither_runs<dither_scalar_run>;
+#if defined(WAVEGEN_X86)
+        case simd_isa::avx2:   return dither_runs<dither_avx2_run>;
+        case simd_isa::avx512: return dither_runs<dither_avx512_run>;
+#elif defined(WAVEGEN_NEON)
+        case simd_isa::neon:   return dither_runs<dither_neon_run>;
+#endif
+        default:               return nullptr;
+    }
+}
+
+dither_kernel best_dither_kernel()
+{
+    for (auto isa : {simd_isa::avx512, simd_isa::avx2, simd_isa::neon}) {
+        if (auto kernel = get_dither_kernel(isa)) {
+            return kernel;
+        }
+    }
+
+    return dither_runs<dither_scalar_run>;
+}
+
+void shape_noise(const int32_t* in, std::size_t count, uint32_t key, uint64_t first_index, int32_t* out, noise_shaper_state& state)
+{
+    // fixed point in units of the noise, 2^-16 LSB: the feedback is exact, and its dependency chain short
+    constexpr int k_unit_bits {16};
+
+    for (std::size_t i{}; i < count; ++i) {
+        auto sample_index = first_index + i;
+        if (sample_index % k_dither_shaping_span == 0) {
+            state = {};
+        }
+
+        auto noise = get_dither_noise(key, sample_index);
+        int64_t dither = static_cast<int64_t>(noise & 0xFFFF) + (noise >> 16) - 0xFFFF;
+
+        // E(z) = 1 - 2 z^-1 + z^-2
+        int64_t wanted = static_cast<int64_t>(in[i]) * (1 << (k_unit_bits - k_dither_fraction_bits)) - (2 * state.error - state.previous_error);
+        int64_t rounded = (wanted + dither + (1 << (k_unit_bits - 1))) >> k_unit_bits;
+
+        state.previous_error = state.error;
+        state.error = rounded * (1 << k_unit_bits) - wanted;
+        out[i] = static_cast<int32_t>(rounded);
+    }
+}
+
+}// namespace wavegen
@@ -0,0 +1,115 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   TPDF dither and noise-shaped quantization of generated samples, driven by a
+ *          counter-based noise generator so the output does not depend on blocks or threads.
+ */
+#ifndef DITHER_H_
+#define DITHER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "CpuFeatures.h"
+
+namespace wavegen
+{
+
+// The quantization of generated samples to whole samples of the output.
+enum class dither_mode
+{
+    none,       // the generators truncate their samples, the quantization error follows the signal
+    tpdf,       // triangular noise of +-1 LSB is added before rounding, the error is white and independent of the signal
+    shaped      // TPDF dither with a second-order error feedback, which moves the noise towards high frequencies
+};
+
+constexpr uint32_t k_dither_fraction_bits {5};          // Generators of a dithered render run at 2^5 times the amplitude
+constexpr uint32_t k_dither_shaping_span {262'144};     // The error feedback restarts at every multiple of this sample index
+
+/**
+ * Returns the mix of noise sequence key (a channel) with the high 32 bits of the sample indices
+ * of a run of samples. It is the plain key mix for indices below 2^32.
+ */
+inline uint32_t get_dither_key_mix(uint32_t key, uint32_t index_high)
+{
+    return key * 0x9E3779B9u + 0x7F4A7C15u + index_high * 0x85EBCA77u;
+}
+
+/**
+ * The "triple32" integer hash, which passes the usual statistical test suites.
+ */
+inline uint32_t hash_dither_noise(uint32_t x)
+{
+    x ^= x >> 17;
+    x *= 0xED5AD4BBu;
+    x ^= x >> 11;
+    x *= 0xAC4C1B51u;
+    x ^= x >> 15;
+    x *= 0x31848BABu;
+    x ^= x >> 14;
+
+    return x;
+}
+
+/**
+ * Returns 32 random bits of sample sample_index of the noise sequence key (a channel): a counter
+ * based generator, the bits only depend on key and index and not on the samples generated before.
+ */
+inline uint32_t get_dither_noise(uint32_t key, uint64_t sample_index)
+{
+    return hash_dither_noise(static_cast<uint32_t>(sample_index) ^ get_dither_key_mix(key, static_cast<uint32_t>(sample_index >> 32)));
+}
+
+/**
+ * Returns the TPDF dither of the given noise bits in LSB: the sum of two uniform 16 bit values,
+ * a triangular distribution over (-1, 1). The value is a multiple of 2^-16, so adding it to a
+ * sample with k_dither_fraction_bits bits of fraction is exact in double precision.
+ */
+inline double get_tpdf_dither(uint32_t noise)
+{
+    return static_cast<double>(static_cast<int32_t>((noise & 0xFFFF) + (noise >> 16)) - 0xFFFF) * (1.0 / 65'536.0);
+}
+
+/**
+ * A dither kernel rounds count samples holding k_dither_fraction_bits bits of fraction to whole
+ * samples, adding the TPDF dither of sample indices first_index onwards of noise sequence key.
+ * in and out may be the same. The arithmetic is exact, so all kernels produce the same samples.
+ */
+using dither_kernel = void (*)(const int32_t* in, std::size_t count, uint32_t key, uint64_t first_index, int32_t* out);
+
+/**
+ * Returns the kernel for the given instruction set, or nullptr if the kernel
+ * is not available on this platform or CPU.
+ */
+dither_kernel get_dither_kernel(simd_isa isa);
+
+/**
+ * Returns the fastest kernel supported by the running CPU.
+ */
+dither_kernel best_dither_kernel();
+
+// The error feedback of the noise shaping, the quantization errors of the last two samples in 2^-16 LSB.
+struct noise_shaper_state
+{
+    int64_t error {};
+    int64_t previous_error {};
+};
+
+/**
+ * Rounds count samples like a dither kernel, and feeds the quantization error back through
+ * E(z) = (1 - z^-1)^2: the noise drops by 12 dB per octave towards low frequencies, where it is
+ * audible and measured, down to the floor of its resets (see below), and rises towards half the sample rate.
+ * state carries the error from one call to the next of consecutive samples. It is reset at every
+ * multiple of k_dither_shaping_span, so a sample only depends on the samples since the last reset,
+ * and a block starting in between has to be preceded by the samples since that reset.
+ * Every reset drops the error of the two samples before it, a white pulse which sets a floor under
+ * the shaped noise: at 48 kHz, the noise from 20 to 300 Hz is about 50 dB below that of TPDF dither,
+ * where shaping without resets would reach about 63 dB (and resets every 4096 samples only 33 dB).
+ * The floor falls by 3 dB per doubling of the span. Warming the state up over samples in front
+ * of the span does not lower it, the error feedback never converges to the state of another run.
+ */
+void shape_noise(const int32_t* in, std::size_t count, uint32_t key, uint64_t first_index, int32_t* out, noise_shaper_state& state);
+
+}// namespace wavegen
+
+#endif // DITHER_H_
@@ -0,0 +1,704 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   FLAC encoding of rendered 24 bit PCM, the frames of a block being encoded in parallel.
+ */
+#include "FlacEncoder.h"
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+namespace wavegen
+{
+
+namespace
+{
+
+constexpr uint32_t k_qlp_precision {15};        // Bits of a quantized predictor coefficient, with its sign
+constexpr uint32_t k_max_qlp_shift {15};
+constexpr uint32_t k_max_partition_order {8};
+constexpr uint32_t k_max_rice4_parameter {14};  // Higher parameters need the 5 bit parameters of RICE2
+constexpr uint32_t k_max_rice_parameter {30};   // 31 escapes to unencoded residuals, which are not used
+constexpr int64_t k_max_residual {1 << 30};     // Residuals of at least this magnitude are stored verbatim
+
+// Subframe types and channel assignments of the frame header.
+constexpr uint32_t k_subframe_constant {0b000000};
+constexpr uint32_t k_subframe_verbatim {0b000001};
+constexpr uint32_t k_subframe_lpc {0b100000};   // Or'ed with the order - 1
+constexpr uint32_t k_left_side {0b1000};
+constexpr uint32_t k_side_right {0b1001};
+constexpr uint32_t k_mid_side {0b1010};
+
+constexpr std::array<uint8_t, 256> make_crc8_table()
+{
+    std::array<uint8_t, 256> table {};
+    for (unsigned i{}; i < 256; ++i) {
+        unsigned crc = i;
+        for (int bit{}; bit < 8; ++bit) {
+            crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+        }
+        table[i] = static_cast<uint8_t>(crc);
+    }
+    return table;
+}
+
+constexpr std::array<uint16_t, 256> make_crc16_table()
+{
+    std::array<uint16_t, 256> table {};
+    for (unsigned i{}; i < 256; ++i) {
+        unsigned crc = i << 8;
+        for (int bit{}; bit < 8; ++bit) {
+            crc = crc & 0x8000 ? (crc << 1) ^ 0x8005 : crc << 1;
+        }
+        table[i] = static_cast<uint16_t>(crc);
+    }
+    return table;
+}
+
+constexpr auto k_crc8_table = make_crc8_table();       // x^8 + x^2 + x + 1, of the frame header
+constexpr auto k_crc16_table = make_crc16_table();     // x^16 + x^15 + x^2 + 1, of the whole frame
+
+uint8_t get_crc8(const uint8_t* data, std::size_t size)
+{
+    uint8_t crc {};
+    for (std::size_t i{}; i < size; ++i) {
+        crc = k_crc8_table[crc ^ data[i]];
+    }
+    return crc;
+}
+
+uint16_t get_crc16(const uint8_t* data, std::size_t size)
+{
+    uint16_t crc {};
+    for (std::size_t i{}; i < size; ++i) {
+        crc = static_cast<uint16_t>((crc << 8) ^ k_crc16_table[(crc >> 8) ^ data[i]]);
+    }
+    return crc;
+}
+
+/**
+ * Appends bits to a buffer, most significant bit first. The bits of the last byte are
+ * only appended once it is complete, or by align().
+ */
+class bit_writer
+{
+public:
+    explicit bit_writer(std::vector<uint8_t>& out)
+        : m_out(out)
+    {
+    }
+
+    // Appends the low bit_count bits of value, bit_count being at most 32.
+    void put(uint64_t value, unsigned bit_count)
+    {
+        m_buffer = (m_buffer << bit_count) | (value & ((uint64_t{1} << bit_count) - 1));
+        m_bit_count += bit_count;
+        while (m_bit_count >= 8) {
+            m_bit_count -= 8;
+            m_out.push_back(static_cast<uint8_t>(m_buffer >> m_bit_count));
+        }
+    }
+
+    void put_signed(int64_t value, unsigned bit_count)
+    {
+        put(static_cast<uint64_t>(value), bit_count);
+    }
+
+    // Appends a Rice code of parameter k: the quotient in unary, then the k low bits.
+    void put_rice(uint32_t value, unsigned k)
+    {
+        uint32_t quotient = value >> k;
+        if (quotient + 1 + k <= 32) {
+            put((uint64_t{1} << k) | (value & ((uint64_t{1} << k) - 1)), quotient + 1 + k);
+            return;
+        }
+
+        for (; quotient >= 32; quotient -= 32) {
+            put(0, 32);
+        }
+        put(1, quotient + 1);
+        put(value, k);
+    }
+
+    // Pads the last byte with zero bits.
+    void align()
+    {
+        if (m_bit_count > 0) {
+            put(0, 8 - m_bit_count);
+        }
+    }
+
+private:
+    std::vector<uint8_t>& m_out;
+    uint64_t m_buffer {};
+    unsigned m_bit_count {};
+};
+
+// Appends the "UTF-8" code of a frame number, up to 36 bits.
+void put_frame_number(bit_writer& bits, uint64_t number)
+{
+    if (number < 0x80) {
+        bits.put(number, 8);
+        return;
+    }
+
+    // n bytes hold 5 * n + 1 bits: the first byte n leading ones, a zero and the high bits, the other bytes 10 and 6 bits
+    unsigned byte_count {2};
+    while (byte_count < 7 && number >= uint64_t{1} << (5 * byte_count + 1)) {
+        ++byte_count;
+    }
+
+    unsigned shift = 6 * (byte_count - 1);
+    bits.put((0xFF00u >> byte_count) | (number >> shift), 8);
+    while (shift > 0) {
+        shift -= 6;
+        bits.put(0x80 | ((number >> shift) & 0x3F), 8);
+    }
+}
+
+uint32_t get_block_size_code(uint32_t frame_count)
+{
+    for (uint32_t code{8}; code < 16; ++code) {
+        if (frame_count == 256u << (code - 8)) {
+            return code;
+        }
+    }
+    return frame_count <= 256 ? 0b0110 : 0b0111;    // 8 or 16 bits of frame_count - 1 after the frame number
+}
+
+uint32_t get_sample_size_code(uint16_t bits_per_sample)
+{
+    switch (bits_per_sample) {
+        case 8:  return 0b001;
+        case 12: return 0b010;
+        case 16: return 0b100;
+        case 20: return 0b101;
+        case 24: return 0b110;
+        case 32: return 0b111;
+        default: return 0b000;      // as in STREAMINFO
+    }
+}
+
+// Returns the sum of the magnitudes of the residuals of the fixed second order predictor, a measure of how well a channel predicts.
+uint64_t get_fixed_residual_sum(const int32_t* samples, uint32_t count)
+{
+    uint64_t sum {};
+    for (uint32_t i{2}; i < count; ++i) {
+        int64_t residual = static_cast<int64_t>(samples[i]) - 2 * static_cast<int64_t>(samples[i - 1]) + samples[i - 2];
+        sum += static_cast<uint64_t>(residual < 0 ? -residual : residual);
+    }
+    return sum;
+}
+
+// A quantized linear predictor: sample i is predicted as (sum of coefficients[j] * sample[i - 1 - j]) >> shift.
+struct lpc_predictor
+{
+    uint32_t order {};
+    int32_t shift {};
+    std::array<int32_t, k_flac_max_lpc_order> coefficients {};
+};
+
+// The linear predictors of every order up to max_order of a channel, and the order of the fewest estimated bits.
+struct lpc_analysis
+{
+    uint32_t max_order {};
+    uint32_t best_order {};
+    std::array<std::array<double, k_flac_max_lpc_order>, k_flac_max_lpc_order> coefficients {};    // Of order i + 1
+};
+
+/**
+ * Computes the linear predictors of the channel from its autocorrelation under a Welch window with
+ * the Levinson-Durbin recursion, estimating the bits of every order from the variance of its residual.
+ * Returns false if the channel cannot be predicted.
+ */
+bool analyze_channel(const int32_t* samples, uint32_t count, uint16_t bits_per_sample, flac_scratch& scratch, lpc_analysis& analysis)
+{
+    analysis.max_order = std::min(k_flac_max_lpc_order, count / 2);
+    if (analysis.max_order == 0) {
+        return false;
+    }
+
+    auto& window = scratch.window;
+    if (window.size() != count) {
+        window.resize(count);
+        double half = (count - 1) / 2.0;
+        for (uint32_t i{}; i < count; ++i) {
+            double position = (i - half) / (half + 1.0);
+            window[i] = 1.0 - position * position;
+        }
+    }
+
+    auto& windowed = scratch.windowed;
+    windowed.resize(count);
+    for (uint32_t i{}; i < count; ++i) {
+        windowed[i] = samples[i] * window[i];
+    }
+
+    std::array<double, k_flac_max_lpc_order + 1> autocorrelation {};
+    for (uint32_t lag{}; lag <= analysis.max_order; ++lag) {
+        double sum {};
+        for (uint32_t i = lag; i < count; ++i) {
+            sum += windowed[i] * windowed[i - lag];
+        }
+        autocorrelation[lag] = sum;
+    }
+    if (autocorrelation[0] <= 0.0) {
+        return false;
+    }
+
+    // lpc holds the predictor of the current order, negated
+    std::array<double, k_flac_max_lpc_order> lpc {};
+    double error = autocorrelation[0];
+    double best_bits {std::numeric_limits<double>::max()};
+    for (uint32_t i{}; i < analysis.max_order; ++i) {
+        double reflection = -autocorrelation[i + 1];
+        for (uint32_t j{}; j < i; ++j) {
+            reflection -= lpc[j] * autocorrelation[i - j];
+        }
+        reflection /= error;
+
+        lpc[i] = reflection;
+        for (uint32_t j{}; j < i / 2; ++j) {
+            double tmp = lpc[j];
+            lpc[j] += reflection * lpc[i - 1 - j];
+            lpc[i - 1 - j] += reflection * tmp;
+        }
+        if (i % 2) {
+            lpc[i / 2] += lpc[i / 2] * reflection;
+        }
+        error *= 1.0 - reflection * reflection;
+
+        for (uint32_t j{}; j <= i; ++j) {
+            analysis.coefficients[i][j] = -lpc[j];
+        }
+
+        // bits of the residuals, and of the warm up samples and coefficients
+        uint32_t order = i + 1;
+        double residual_bits = error > 0.0 ? std::max(0.0, 0.5 * std::log2(0.5 * error / count)) : 0.0;
+        double bits = residual_bits * (count - order) + order * static_cast<double>(bits_per_sample + k_qlp_precision);
+        if (bits < best_bits) {
+            best_bits = bits;
+            analysis.best_order = order;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Quantizes the predictor of the given order of an analysis, the largest coefficient taking all bits
+ * of the precision. Returns false if its coefficients are too large.
+ */
+bool quantize_predictor(const lpc_analysis& analysis, uint32_t order, lpc_predictor& predictor)
+{
+    const auto& coefficients = analysis.coefficients[order - 1];
+    double max_coefficient {};
+    for (uint32_t j{}; j < order; ++j) {
+        max_coefficient = std::max(max_coefficient, std::abs(coefficients[j]));
+    }
+    if (!(max_coefficient > 0.0) || !std::isfinite(max_coefficient)) {
+        return false;
+    }
+
+    int exponent {};
+    std::frexp(max_coefficient, &exponent);
+    int shift = static_cast<int>(k_qlp_precision) - 1 - exponent;
+    if (shift < 0) {
+        return false;
+    }
+    predictor.order = order;
+    predictor.shift = std::min<int>(shift, k_max_qlp_shift);
+
+    // rounds with error feedback, so the rounding errors of the coefficients do not add up
+    constexpr int32_t k_max_qlp {(1 << (k_qlp_precision - 1)) - 1};
+    double rounding_error {};
+    for (uint32_t j{}; j < order; ++j) {
+        double value = coefficients[j] * std::ldexp(1.0, predictor.shift) + rounding_error;
+        auto quantized = static_cast<int32_t>(std::clamp<long>(std::lround(value), -k_max_qlp - 1, k_max_qlp));
+        rounding_error = value - quantized;
+        predictor.coefficients[j] = quantized;
+    }
+
+    return true;
+}
+
+/**
+ * Computes the residuals of the samples after the warm up samples. Returns false if a residual
+ * is too large for the Rice codes.
+ */
+bool compute_residual(const int32_t* samples, uint32_t count, const lpc_predictor& predictor, int32_t* residual)
+{
+    for (uint32_t i = predictor.order; i < count; ++i) {
+        int64_t sum {};
+        for (uint32_t j{}; j < predictor.order; ++j) {
+            sum += static_cast<int64_t>(predictor.coefficients[j]) * samples[i - 1 - j];
+        }
+        int64_t value = samples[i] - (sum >> predictor.shift);
+        if (value >= k_max_residual || value <= -k_max_residual) {
+            return false;
+        }
+        residual[i - predictor.order] = static_cast<int32_t>(value);
+    }
+    return true;
+}
+
+inline uint32_t zigzag(int32_t value)
+{
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+// Returns the Rice parameter of the fewest bits for count values summing up to sum, and their bits.
+uint32_t get_rice_parameter(uint64_t sum, uint64_t count, uint64_t& bits)
+{
+    uint32_t guess {};
+    while (guess < k_max_rice_parameter && (count << (guess + 1)) <= sum) {
+        ++guess;
+    }
+
+    bits = std::numeric_limits<uint64_t>::max();
+    uint32_t best {};
+    for (uint32_t k = guess > 0 ? guess - 1 : 0; k <= std::min(guess + 1, k_max_rice_parameter); ++k) {
+        // sum >> k estimates the quotients, they only lose the carries of the low bits
+        uint64_t estimate = count * (k + 1) + (sum >> k);
+        if (estimate < bits) {
+            bits = estimate;
+            best = k;
+        }
+    }
+    return best;
+}
+
+// The partitions of a residual and their Rice parameters.
+struct rice_partitioning
+{
+    uint32_t order {};
+    bool rice2 {};      // 5 bit parameters
+    std::array<uint32_t, 1u << k_max_partition_order> parameters {};
+    uint64_t bits {};   // Estimated, with the header of the residual
+};
+
+/**
+ * Finds the partition order and parameters of the fewest bits for the residual of a frame of
+ * frame_count samples and a predictor of the given order. A partition order has to split the frame
+ * into 2^order partitions of the same size, the first of which is left with residuals.
+ */
+rice_partitioning find_partitioning(const int32_t* residual, uint32_t frame_count, uint32_t predictor_order)
+{
+    uint32_t max_order {};
+    while (max_order < k_max_partition_order && frame_count % (2u << max_order) == 0 && (frame_count >> (max_order + 1)) > predictor_order) {
+        ++max_order;
+    }
+
+    // sums of the finest partitions, merged pairwise for the coarser ones
+    std::array<uint64_t, 1u << k_max_partition_order> sums {};
+    uint32_t partition_size = frame_count >> max_order;
+    const int32_t* value = residual;
+    for (uint32_t partition{}; partition < (1u << max_order); ++partition) {
+        uint32_t size = partition == 0 ? partition_size - predictor_order : partition_size;
+        for (uint32_t i{}; i < size; ++i) {
+            sums[partition] += zigzag(*value++);
+        }
+    }
+
+    rice_partitioning best;
+    best.bits = std::numeric_limits<uint64_t>::max();
+    for (uint32_t order = max_order;; --order) {
+        rice_partitioning candidate;
+        candidate.order = order;
+        candidate.bits = 2 + 4;
+        uint32_t size = frame_count >> order;
+        uint32_t max_parameter {};
+        for (uint32_t partition{}; partition < (1u << order); ++partition) {
+            uint64_t bits {};
+            uint64_t count = partition == 0 ? size - predictor_order : size;
+            candidate.parameters[partition] = get_rice_parameter(sums[partition], count, bits);
+            candidate.bits += bits;
+            max_parameter = std::max(max_parameter, candidate.parameters[partition]);
+        }
+        candidate.rice2 = max_parameter > k_max_rice4_parameter;
+        candidate.bits += (1u << order) * (candidate.rice2 ? 5 : 4);
+        if (candidate.bits < best.bits) {
+            best = candidate;
+        }
+
+        if (order == 0) {
+            break;
+        }
+        for (uint32_t partition{}; partition < (1u << (order - 1)); ++partition) {
+            sums[partition] = sums[2 * partition] + sums[2 * partition + 1];
+        }
+    }
+
+    return best;
+}
+
+void put_residual(bit_writer& bits, const int32_t* residual, uint32_t frame_count, uint32_t predictor_order,
+                  const rice_partitioning& partitioning)
+{
+    bits.put(partitioning.rice2 ? 1 : 0, 2);
+    bits.put(partitioning.order, 4);
+
+    uint32_t size = frame_count >> partitioning.order;
+    for (uint32_t partition{}; partition < (1u << partitioning.order); ++partition) {
+        auto parameter = partitioning.parameters[partition];
+        bits.put(parameter, partitioning.rice2 ? 5 : 4);
+        uint32_t count = partition == 0 ? size - predictor_order : size;
+        for (uint32_t i{}; i < count; ++i) {
+            bits.put_rice(zigzag(*residual++), parameter);
+        }
+    }
+}
+
+/**
+ * Appends the subframe of a channel of frame_count samples of bit_count bits: a constant, the
+ * predictor and residual, or the verbatim samples, whichever is the smallest.
+ */
+void put_subframe(bit_writer& bits, const int32_t* samples, uint32_t frame_count, uint16_t bit_count, flac_scratch& scratch)
+{
+    if (std::all_of(samples, samples + frame_count, [&](int32_t sample) { return sample == samples[0]; })) {
+        bits.put(k_subframe_constant << 1, 8);
+        bits.put_signed(samples[0], bit_count);
+        return;
+    }
+
+    // the estimated order competes with a few low ones, whose coefficients lose less to quantization
+    lpc_analysis analysis;
+    if (analyze_channel(samples, frame_count, bit_count, scratch, analysis)) {
+        lpc_predictor best;
+        rice_partitioning best_partitioning;
+        uint64_t best_bits = static_cast<uint64_t>(frame_count) * bit_count;
+        scratch.residual.resize(std::max<std::size_t>(scratch.residual.size(), frame_count));
+        scratch.best_residual.resize(std::max<std::size_t>(scratch.best_residual.size(), frame_count));
+
+        uint32_t tried_orders {};      // bit order - 1 is set once the order was tried
+        for (uint32_t order : {analysis.best_order, 2u, 4u, 8u}) {
+            lpc_predictor predictor;
+            if (order > analysis.max_order || tried_orders & (1u << (order - 1)) || !quantize_predictor(analysis, order, predictor)
+                || !compute_residual(samples, frame_count, predictor, scratch.residual.data())) {
+                continue;
+            }
+            tried_orders |= 1u << (order - 1);
+
+            auto partitioning = find_partitioning(scratch.residual.data(), frame_count, order);
+            uint64_t lpc_bits = order * static_cast<uint64_t>(bit_count + k_qlp_precision) + 4 + 5 + partitioning.bits;
+            if (lpc_bits < best_bits) {
+                best_bits = lpc_bits;
+                best = predictor;
+                best_partitioning = partitioning;
+                scratch.residual.swap(scratch.best_residual);
+            }
+        }
+
+        if (best.order > 0) {
+            bits.put((k_subframe_lpc | (best.order - 1)) << 1, 8);
+            for (uint32_t i{}; i < best.order; ++i) {
+                bits.put_signed(samples[i], bit_count);
+            }
+            bits.put(k_qlp_precision - 1, 4);
+            bits.put_signed(best.shift, 5);
+            for (uint32_t j{}; j < best.order; ++j) {
+                bits.put_signed(best.coefficients[j], k_qlp_precision);
+            }
+            put_residual(bits, scratch.best_residual.data(), frame_count, best.order, best_partitioning);
+            return;
+        }
+    }
+
+    bits.put(k_subframe_verbatim << 1, 8);
+    for (uint32_t i{}; i < frame_count; ++i) {
+        bits.put_signed(samples[i], bit_count);
+    }
+}
+
+}// namespace
+
+std::vector<uint8_t> create_flac_header(const wave_format& format, uint64_t frame_count, uint32_t block_frames)
+{
+    std::vector<uint8_t> header {'f', 'L', 'a', 'C'};
+    header.reserve(k_flac_header_size);
+    bit_writer bits(header);
+
+    bits.put(1, 1);         // the last metadata block
+    bits.put(0, 7);         // STREAMINFO
+    bits.put(k_flac_header_size - 8, 24);
+    bits.put(block_frames, 16);
+    bits.put(block_frames, 16);
+    bits.put(0, 24);        // frame sizes unknown
+    bits.put(0, 24);
+    bits.put(format.sample_rate, 20);
+    bits.put(format.channel_count - 1u, 3);
+    bits.put(format.bits_per_sample - 1u, 5);
+    bits.put(frame_count >> 32, 4);
+    bits.put(frame_count, 32);
+    for (int i{}; i < 4; ++i) {
+        bits.put(0, 32);    // MD5 unknown
+    }
+
+    return header;
+}
+
+void encode_flac_frame(std::span<const int32_t> samples, uint16_t channel_count, uint16_t bits_per_sample, uint64_t frame_number,
+                       std::vector<uint8_t>& out, flac_scratch& scratch)
+{
+    auto frame_count = static_cast<uint32_t>(samples.size() / channel_count);
+
+    // the channels one after another, stereo followed by its mid and side channels
+    auto& channels = scratch.channels;
+    channels.resize(std::max<std::size_t>(channels.size(), static_cast<std::size_t>(frame_count) * (channel_count == 2 ? 4 : channel_count)));
+    for (uint32_t frame{}; frame < frame_count; ++frame) {
+        for (uint16_t channel{}; channel < channel_count; ++channel) {
+            channels[channel * static_cast<std::size_t>(frame_count) + frame] = samples[frame * channel_count + channel];
+        }
+    }
+
+    uint32_t assignment = channel_count - 1u;
+    std::array<const int32_t*, k_flac_max_channel_count> subframes {};
+    std::array<uint16_t, k_flac_max_channel_count> subframe_bits {};
+    for (uint16_t channel{}; channel < channel_count; ++channel) {
+        subframes[channel] = channels.data() + channel * static_cast<std::size_t>(frame_count);
+        subframe_bits[channel] = bits_per_sample;
+    }
+
+    if (channel_count == 2) {
+        int32_t* left = channels.data();
+        int32_t* right = left + frame_count;
+        int32_t* mid = right + frame_count;
+        int32_t* side = mid + frame_count;
+        for (uint32_t frame{}; frame < frame_count; ++frame) {
+            mid[frame] = static_cast<int32_t>((static_cast<int64_t>(left[frame]) + right[frame]) >> 1);
+            side[frame] = left[frame] - right[frame];
+        }
+
+        // the pair of channels predicting best
+        uint64_t left_sum = get_fixed_residual_sum(left, frame_count);
+        uint64_t right_sum = get_fixed_residual_sum(right, frame_count);
+        uint64_t mid_sum = get_fixed_residual_sum(mid, frame_count);
+        uint64_t side_sum = get_fixed_residual_sum(side, frame_count);
+        uint64_t best_sum = left_sum + right_sum;
+        if (left_sum + side_sum < best_sum) {
+            best_sum = left_sum + side_sum;
+            assignment = k_left_side;
+            subframes = {left, side};
+            subframe_bits = {bits_per_sample, static_cast<uint16_t>(bits_per_sample + 1)};
+        }
+        if (side_sum + right_sum < best_sum) {
+            best_sum = side_sum + right_sum;
+            assignment = k_side_right;
+            subframes = {side, right};
+            subframe_bits = {static_cast<uint16_t>(bits_per_sample + 1), bits_per_sample};
+        }
+        if (mid_sum + side_sum < best_sum) {
+            assignment = k_mid_side;
+            subframes = {mid, side};
+            subframe_bits = {bits_per_sample, static_cast<uint16_t>(bits_per_sample + 1)};
+        }
+    }
+
+    auto frame_start = out.size();
+    bit_writer bits(out);
+    auto block_size_code = get_block_size_code(frame_count);
+    bits.put(0x3FFE, 14);       // sync code
+    bits.put(0, 1);
+    bits.put(0, 1);             // fixed block size
+    bits.put(block_size_code, 4);
+    bits.put(0, 4);             // sample rate of STREAMINFO
+    bits.put(assignment, 4);
+    bits.put(get_sample_size_code(bits_per_sample), 3);
+    bits.put(0, 1);
+    put_frame_number(bits, frame_number);
+    if (block_size_code == 0b0110) {
+        bits.put(frame_count - 1, 8);
+    } else if (block_size_code == 0b0111) {
+        bits.put(frame_count - 1, 16);
+    }
+    bits.put(get_crc8(out.data() + frame_start, out.size() - frame_start), 8);
+
+    for (uint16_t channel{}; channel < channel_count; ++channel) {
+        put_subframe(bits, subframes[channel], frame_count, subframe_bits[channel], scratch);
+    }
+    bits.align();
+    bits.put(get_crc16(out.data() + frame_start, out.size() - frame_start), 16);
+}
+
+flac_encoder::flac_encoder(const wave_format& format, uint64_t frame_count, thread_pool& pool, uint32_t block_frames)
+    : m_format(format)
+    , m_pool(pool)
+    , m_block_frames(block_frames)
+{
+    if (format.sample_format != sample_format::pcm || format.bits_per_sample != 24) {
+        throw std::invalid_argument("Invalid argument. FLAC encodes 24 bit PCM, not floats.");
+    }
+    if (format.channel_count == 0 || format.channel_count > k_flac_max_channel_count) {
+        throw std::invalid_argument("Invalid argument. FLAC holds from 1 to 8 channels.");
+    }
+    if (block_frames < 16 || block_frames > k_flac_block_frames) {
+        throw std::invalid_argument("Invalid argument. FLAC frames should hold from 16 to 4096 frames.");
+    }
+
+    m_header = create_flac_header(format, frame_count, block_frames);
+    m_scratch.resize(pool.size());
+}
+
+std::span<const uint8_t> flac_encoder::encode(std::span<const uint8_t> data)
+{
+    auto sample_count = data.size() / 3;
+    m_samples.resize(std::max(m_samples.size(), m_sample_count + sample_count));
+
+    // sign extends the packed little endian samples
+    int32_t* samples = m_samples.data() + m_sample_count;
+    for (std::size_t i{}; i < sample_count; ++i) {
+        uint32_t value = data[3 * i] | (data[3 * i + 1] << 8) | (static_cast<uint32_t>(data[3 * i + 2]) << 16);
+        samples[i] = static_cast<int32_t>(value << 8) >> 8;
+    }
+    m_sample_count += sample_count;
+
+    std::size_t block_samples = static_cast<std::size_t>(m_block_frames) * m_format.channel_count;
+    auto frame_count = m_sample_count / block_samples;
+    encode_frames(frame_count);
+
+    auto encoded = frame_count * block_samples;
+    std::copy(m_samples.begin() + encoded, m_samples.begin() + m_sample_count, m_samples.begin());
+    m_sample_count -= encoded;
+
+    return m_output;
+}
+
+std::span<const uint8_t> flac_encoder::finish()
+{
+    std::size_t block_samples = static_cast<std::size_t>(m_block_frames) * m_format.channel_count;
+    encode_frames((m_sample_count + block_samples - 1) / block_samples);
+    m_sample_count = 0;
+
+    return m_output;
+}
+
+void flac_encoder::encode_frames(std::size_t frame_count)
+{
+    m_output.clear();
+    if (frame_count == 0) {
+        return;
+    }
+
+    std::size_t block_samples = static_cast<std::size_t>(m_block_frames) * m_format.channel_count;
+    m_frames.resize(std::max(m_frames.size(), frame_count));
+    m_pool.for_each_range(frame_count, [&](unsigned worker_index, std::size_t begin, std::size_t end) {
+        for (auto frame = begin; frame < end; ++frame) {
+            auto first = frame * block_samples;
+            std::span<const int32_t> samples(m_samples.data() + first, std::min(block_samples, m_sample_count - first));
+            m_frames[frame].clear();
+            encode_flac_frame(samples, m_format.channel_count, m_format.bits_per_sample, m_frame_number + frame, m_frames[frame],
+                              m_scratch[worker_index]);
+        }
+    });
+
+    for (std::size_t frame{}; frame < frame_count; ++frame) {
+        m_output.insert(m_output.end(), m_frames[frame].begin(), m_frames[frame].end());
+    }
+    m_frame_number += frame_count;
+}
+
+}// namespace wavegen
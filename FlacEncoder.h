@@ -0,0 +1,97 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   FLAC encoding of rendered 24 bit PCM, the frames of a block being encoded in parallel.
+ */
+#ifndef FLAC_ENCODER_H_
+#define FLAC_ENCODER_H_
+
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "WaveFormat.h"
+#include "ThreadPool.h"
+
+namespace wavegen
+{
+
+constexpr uint32_t k_flac_block_frames {4'096};     // Frames of a FLAC frame
+constexpr uint32_t k_flac_max_lpc_order {12};       // Highest order of the linear predictors
+constexpr uint16_t k_flac_max_channel_count {8};
+constexpr std::size_t k_flac_header_size {42};      // "fLaC" and the STREAMINFO block
+
+/**
+ * Returns the "fLaC" marker and the STREAMINFO block of a stream of frame_count frames of the given
+ * format, frame_count 0 if the length is unknown (a stream). The sizes of the frames and the MD5 of
+ * the samples are left unknown (0), so the header can be written before the first frame.
+ */
+std::vector<uint8_t> create_flac_header(const wave_format& format, uint64_t frame_count, uint32_t block_frames = k_flac_block_frames);
+
+// Buffers of the encoding of one frame, only ever grown, so the frames of a thread can share them.
+struct flac_scratch
+{
+    std::vector<int32_t> channels;      // The samples of a frame, channel after channel
+    std::vector<int32_t> residual;
+    std::vector<int32_t> best_residual;     // Of the best predictor tried
+    std::vector<double> window;         // Of the last frame size
+    std::vector<double> windowed;       // The samples of a channel under the window
+};
+
+/**
+ * Appends FLAC frame frame_number of a fixed block size stream to out. samples holds its frames of
+ * interleaved samples of bits_per_sample bits. Every channel is encoded as the best of a constant,
+ * a linear predictor of up to k_flac_max_lpc_order or its verbatim samples, with a partitioned Rice
+ * code of the residual. Stereo frames may be encoded as left, right, mid or side channels, whichever
+ * pair predicts best.
+ * A frame only depends on its own samples and number, so the frames of a stream can be encoded in any order.
+ */
+void encode_flac_frame(std::span<const int32_t> samples, uint16_t channel_count, uint16_t bits_per_sample, uint64_t frame_number,
+                       std::vector<uint8_t>& out, flac_scratch& scratch);
+
+/**
+ * Encodes the packed 24 bit PCM audio data of a render into a FLAC stream, block by block. The
+ * frames completed by a block are encoded in parallel on the pool, every worker encoding its
+ * own contiguous frames into their own buffers, and are then joined in order.
+ * Throws std::invalid_argument for a format FLAC cannot hold: floats or more than 8 channels.
+ */
+class flac_encoder
+{
+public:
+    // frame_count is written to the header, 0 if unknown.
+    flac_encoder(const wave_format& format, uint64_t frame_count, thread_pool& pool, uint32_t block_frames = k_flac_block_frames);
+
+    // The header of the stream.
+    std::span<const uint8_t> header() const { return m_header; }
+
+    /**
+     * Encodes the frames completed by the given audio data, and keeps the rest of it for the next
+     * call. Returns the encoded frames, valid until the next call, empty if no frame was completed.
+     */
+    std::span<const uint8_t> encode(std::span<const uint8_t> data);
+
+    /**
+     * Encodes the frames left, the last one may be shorter than the others. Returns them like encode().
+     */
+    std::span<const uint8_t> finish();
+
+private:
+    // Encodes the frame_count frames at the start of m_samples.
+    void encode_frames(std::size_t frame_count);
+
+    wave_format m_format;
+    thread_pool& m_pool;
+    uint32_t m_block_frames;
+    std::vector<uint8_t> m_header;
+    std::vector<int32_t> m_samples;             // Interleaved samples not encoded yet
+    std::size_t m_sample_count {};              // Of m_samples
+    uint64_t m_frame_number {};                 // Of the next FLAC frame
+    std::vector<std::vector<uint8_t>> m_frames;     // The encoded frames of a call
+    std::vector<flac_scratch> m_scratch;        // One per worker
+    std::vector<uint8_t> m_output;
+};
+
+}// namespace wavegen
+
+#endif // FLAC_ENCODER_H_
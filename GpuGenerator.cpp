@@ -0,0 +1,598 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Generation and packing of sine waves on an OpenCL device, for renders of many files at once.
+ */
+#include "GpuGenerator.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#define WAVEGEN_CL_CALL __stdcall
+#else
+#include <dlfcn.h>
+#define WAVEGEN_CL_CALL
+#endif
+
+namespace wavegen
+{
+
+namespace
+{
+
+using cl_int = int32_t;
+using cl_uint = uint32_t;
+using cl_ulong = uint64_t;
+
+static_assert(k_float_full_scale == 30'000'000.0f, "The pack kernel scales float samples by 1 / 30000000.");
+
+// The generators in OpenCL C. The phases are computed like those of sine_wave_generator, from the
+// same constants, and none of the expressions can be contracted into a fused multiply-add.
+constexpr const char* k_program_source = R"(
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+
+int get_sample(ulong index, uint frequency, uint rate, double amplitude, double time_increment, double radians_per_step,
+               int integer_path)
+{
+    double phase;
+    if (integer_path) {
+        phase = (double)(index % rate * frequency % rate) * radians_per_step;
+    } else {
+        phase = (2.0 * 3.141592653589793 * frequency) * ((double)index * time_increment);
+    }
+    return (int)(amplitude * sin(phase));
+}
+
+__kernel void generate_samples(__global int* samples, ulong first_index, uint frequency, uint rate, double amplitude,
+                               double time_increment, double radians_per_step, int integer_path)
+{
+    size_t i = get_global_id(0);
+    samples[i] = get_sample(first_index + i, frequency, rate, amplitude, time_increment, radians_per_step, integer_path);
+}
+
+__kernel void pack_frames(__global uchar* out, __global const uint* frequencies, __global const ulong* first_frames,
+                          __global const uint* frame_counts, uint channel_count, uint wave_stride, uint sample_size, uint rate,
+                          double amplitude, double time_increment, double radians_per_step, int integer_path)
+{
+    size_t frame = get_global_id(0);
+    size_t wave = get_global_id(1);
+    if (frame >= frame_counts[wave]) {
+        return;
+    }
+
+    __global uchar* frame_out = out + wave * wave_stride + frame * channel_count * sample_size;
+    ulong index = first_frames[wave] + frame;
+    for (uint channel = 0; channel < channel_count; ++channel) {
+        int sample = get_sample(index, frequencies[wave * channel_count + channel], rate, amplitude, time_increment,
+                                radians_per_step, integer_path);
+        __global uchar* sample_out = frame_out + channel * sample_size;
+        if (sample_size == 4) {
+            uint bits = as_uint(clamp((float)sample * (1.0f / 30000000.0f), -1.0f, 1.0f));
+            sample_out[0] = bits & 0xFF;
+            sample_out[1] = (bits >> 8) & 0xFF;
+            sample_out[2] = (bits >> 16) & 0xFF;
+            sample_out[3] = (bits >> 24) & 0xFF;
+        } else {
+            sample_out[0] = sample & 0xFF;
+            sample_out[1] = (sample >> 8) & 0xFF;
+            sample_out[2] = (sample >> 16) & 0xFF;
+        }
+    }
+}
+)";
+
+constexpr std::size_t k_max_kernel_samples {1u << 22};     // Samples of a generate_samples call, 16 MiB
+
+[[noreturn]] void throw_gpu_failure(const std::string& reason)
+{
+    throw std::runtime_error("GPU generation failed. " + reason);
+}
+
+/**
+ * The part of the OpenCL 1.2 API the generators need, resolved from the ICD loader at run time.
+ * The values are those of the stable OpenCL ABI, handles are opaque pointers.
+ */
+struct opencl_api
+{
+    static constexpr cl_int k_success {0};                          // CL_SUCCESS
+    static constexpr cl_int k_platform_not_found {-1001};           // CL_PLATFORM_NOT_FOUND_KHR, no ICD installed
+    static constexpr cl_ulong k_device_type_gpu {1 << 2};           // CL_DEVICE_TYPE_GPU
+    static constexpr cl_ulong k_device_type_all {0xFFFFFFFF};       // CL_DEVICE_TYPE_ALL
+    static constexpr cl_uint k_device_type {0x1000};                // CL_DEVICE_TYPE
+    static constexpr cl_uint k_device_name {0x102B};                // CL_DEVICE_NAME
+    static constexpr cl_uint k_device_extensions {0x1030};          // CL_DEVICE_EXTENSIONS
+    static constexpr cl_uint k_program_build_log {0x1183};          // CL_PROGRAM_BUILD_LOG
+    static constexpr cl_ulong k_mem_write_only {1 << 1};            // CL_MEM_WRITE_ONLY
+    static constexpr cl_ulong k_mem_read_only {1 << 2};             // CL_MEM_READ_ONLY
+    static constexpr cl_ulong k_mem_alloc_host_ptr {1 << 4};        // CL_MEM_ALLOC_HOST_PTR
+    static constexpr cl_ulong k_map_read_write {(1 << 0) | (1 << 1)};      // CL_MAP_READ | CL_MAP_WRITE
+    static constexpr cl_uint k_true {1};
+    static constexpr cl_uint k_false {0};
+
+    opencl_api()
+    {
+        m_library = open_library();
+        if (!m_library) {
+            throw_gpu_failure("OpenCL is not available, its library could not be loaded.");
+        }
+
+        bool resolved = resolve(get_platform_ids, "clGetPlatformIDs") && resolve(get_device_ids, "clGetDeviceIDs")
+                        && resolve(get_device_info, "clGetDeviceInfo") && resolve(create_context, "clCreateContext")
+                        && resolve(create_command_queue, "clCreateCommandQueue")
+                        && resolve(create_program_with_source, "clCreateProgramWithSource")
+                        && resolve(build_program, "clBuildProgram") && resolve(get_program_build_info, "clGetProgramBuildInfo")
+                        && resolve(create_kernel, "clCreateKernel") && resolve(create_buffer, "clCreateBuffer")
+                        && resolve(set_kernel_arg, "clSetKernelArg") && resolve(enqueue_write_buffer, "clEnqueueWriteBuffer")
+                        && resolve(enqueue_read_buffer, "clEnqueueReadBuffer")
+                        && resolve(enqueue_nd_range_kernel, "clEnqueueNDRangeKernel")
+                        && resolve(enqueue_map_buffer, "clEnqueueMapBuffer")
+                        && resolve(enqueue_unmap_mem_object, "clEnqueueUnmapMemObject") && resolve(flush, "clFlush")
+                        && resolve(finish, "clFinish") && resolve(wait_for_events, "clWaitForEvents")
+                        && resolve(release_event, "clReleaseEvent") && resolve(release_mem_object, "clReleaseMemObject")
+                        && resolve(release_kernel, "clReleaseKernel") && resolve(release_program, "clReleaseProgram")
+                        && resolve(release_command_queue, "clReleaseCommandQueue") && resolve(release_context, "clReleaseContext");
+        if (!resolved) {
+            close_library();
+            throw_gpu_failure("OpenCL is not available, its library lacks the OpenCL 1.2 API.");
+        }
+    }
+
+    ~opencl_api() { close_library(); }
+
+    opencl_api(const opencl_api&) = delete;
+    opencl_api& operator=(const opencl_api&) = delete;
+
+    // Throws for a failed call, naming what failed.
+    void check(cl_int result, const char* action) const
+    {
+        if (result != k_success) {
+            throw_gpu_failure(std::string("Failed to ") + action + " (OpenCL error " + std::to_string(result) + ").");
+        }
+    }
+
+    cl_int (WAVEGEN_CL_CALL *get_platform_ids)(cl_uint count, void** platforms, cl_uint* platform_count) {};
+    cl_int (WAVEGEN_CL_CALL *get_device_ids)(void* platform, cl_ulong type, cl_uint count, void** devices, cl_uint* device_count) {};
+    cl_int (WAVEGEN_CL_CALL *get_device_info)(void* device, cl_uint info, std::size_t size, void* value, std::size_t* value_size) {};
+    void* (WAVEGEN_CL_CALL *create_context)(const intptr_t* properties, cl_uint device_count, void* const* devices,
+                                            void (WAVEGEN_CL_CALL *notify)(const char*, const void*, std::size_t, void*),
+                                            void* user_data, cl_int* result) {};
+    void* (WAVEGEN_CL_CALL *create_command_queue)(void* context, void* device, cl_ulong properties, cl_int* result) {};
+    void* (WAVEGEN_CL_CALL *create_program_with_source)(void* context, cl_uint count, const char** sources,
+                                                        const std::size_t* lengths, cl_int* result) {};
+    cl_int (WAVEGEN_CL_CALL *build_program)(void* program, cl_uint device_count, void* const* devices, const char* options,
+                                            void (WAVEGEN_CL_CALL *notify)(void*, void*), void* user_data) {};
+    cl_int (WAVEGEN_CL_CALL *get_program_build_info)(void* program, void* device, cl_uint info, std::size_t size, void* value,
+                                                     std::size_t* value_size) {};
+    void* (WAVEGEN_CL_CALL *create_kernel)(void* program, const char* name, cl_int* result) {};
+    void* (WAVEGEN_CL_CALL *create_buffer)(void* context, cl_ulong flags, std::size_t size, void* host, cl_int* result) {};
+    cl_int (WAVEGEN_CL_CALL *set_kernel_arg)(void* kernel, cl_uint index, std::size_t size, const void* value) {};
+    cl_int (WAVEGEN_CL_CALL *enqueue_write_buffer)(void* queue, void* buffer, cl_uint blocking, std::size_t offset, std::size_t size,
+                                                   const void* data, cl_uint wait_count, void* const* wait_events, void** event) {};
+    cl_int (WAVEGEN_CL_CALL *enqueue_read_buffer)(void* queue, void* buffer, cl_uint blocking, std::size_t offset, std::size_t size,
+                                                  void* data, cl_uint wait_count, void* const* wait_events, void** event) {};
+    cl_int (WAVEGEN_CL_CALL *enqueue_nd_range_kernel)(void* queue, void* kernel, cl_uint dimensions, const std::size_t* offsets,
+                                                      const std::size_t* global_sizes, const std::size_t* local_sizes,
+                                                      cl_uint wait_count, void* const* wait_events, void** event) {};
+    void* (WAVEGEN_CL_CALL *enqueue_map_buffer)(void* queue, void* buffer, cl_uint blocking, cl_ulong flags, std::size_t offset,
+                                                std::size_t size, cl_uint wait_count, void* const* wait_events, void** event,
+                                                cl_int* result) {};
+    cl_int (WAVEGEN_CL_CALL *enqueue_unmap_mem_object)(void* queue, void* buffer, void* mapping, cl_uint wait_count,
+                                                       void* const* wait_events, void** event) {};
+    cl_int (WAVEGEN_CL_CALL *flush)(void* queue) {};
+    cl_int (WAVEGEN_CL_CALL *finish)(void* queue) {};
+    cl_int (WAVEGEN_CL_CALL *wait_for_events)(cl_uint count, void* const* events) {};
+    cl_int (WAVEGEN_CL_CALL *release_event)(void* event) {};
+    cl_int (WAVEGEN_CL_CALL *release_mem_object)(void* buffer) {};
+    cl_int (WAVEGEN_CL_CALL *release_kernel)(void* kernel) {};
+    cl_int (WAVEGEN_CL_CALL *release_program)(void* program) {};
+    cl_int (WAVEGEN_CL_CALL *release_command_queue)(void* queue) {};
+    cl_int (WAVEGEN_CL_CALL *release_context)(void* context) {};
+
+private:
+#if defined(_WIN32)
+    static void* open_library() { return ::LoadLibraryA("OpenCL.dll"); }
+    void* find(const char* name) { return reinterpret_cast<void*>(::GetProcAddress(static_cast<HMODULE>(m_library), name)); }
+    void close_library() { ::FreeLibrary(static_cast<HMODULE>(m_library)); }
+#else
+    static void* open_library()
+    {
+#if defined(__APPLE__)
+        return ::dlopen("/System/Library/Frameworks/OpenCL.framework/OpenCL", RTLD_NOW | RTLD_LOCAL);
+#else
+        void* library = ::dlopen("libOpenCL.so.1", RTLD_NOW | RTLD_LOCAL);
+        return library ? library : ::dlopen("libOpenCL.so", RTLD_NOW | RTLD_LOCAL);
+#endif
+    }
+    void* find(const char* name) { return ::dlsym(m_library, name); }
+    void close_library() { ::dlclose(m_library); }
+#endif
+
+    template <typename Function>
+    bool resolve(Function& function, const char* name)
+    {
+        function = reinterpret_cast<Function>(find(name));
+        return function != nullptr;
+    }
+
+    void* m_library {};
+};
+
+// Returns a string property of a device, empty if it cannot be queried.
+std::string get_device_string(const opencl_api& api, void* device, cl_uint info)
+{
+    std::size_t size {};
+    if (api.get_device_info(device, info, 0, nullptr, &size) != opencl_api::k_success || size == 0) {
+        return {};
+    }
+
+    std::string value(size, '\0');
+    api.get_device_info(device, info, size, value.data(), nullptr);
+    value.resize(value.find('\0') == std::string::npos ? size : value.find('\0'));
+    return value;
+}
+
+// The arguments of a kernel which take the phases of the samples, in the order of the kernels.
+struct phase_args
+{
+    uint32_t sample_rate;
+    double amplitude;
+    double time_increment;          // Seconds per sample, like sine_wave_generator
+    double radians_per_step;        // Radians per 1 / sample_rate turns, like sine_wave_generator
+    int32_t integer_path;
+};
+
+phase_args get_phase_args(uint32_t amplitude, uint32_t sample_rate, oscillator_mode mode)
+{
+    return {sample_rate, static_cast<double>(amplitude), 1.0 / sample_rate, 2.0 * k_PI / sample_rate,
+            mode == oscillator_mode::integer ? 1 : 0};
+}
+
+}// namespace
+
+struct gpu_device::state
+{
+    ~state()
+    {
+        if (program) {
+            api.release_program(program);
+        }
+        if (queue) {
+            api.release_command_queue(queue);
+        }
+        if (context) {
+            api.release_context(context);
+        }
+    }
+
+    // Creates a kernel of the program, released by the caller.
+    void* create_kernel(const char* kernel_name)
+    {
+        cl_int result {};
+        void* kernel = api.create_kernel(program, kernel_name, &result);
+        api.check(result, "create the kernel");
+        return kernel;
+    }
+
+    // Creates a buffer of the device, released by the caller.
+    void* create_buffer(cl_ulong flags, std::size_t size)
+    {
+        cl_int result {};
+        void* buffer = api.create_buffer(context, flags, size, nullptr, &result);
+        api.check(result, "allocate a device buffer");
+        return buffer;
+    }
+
+    template <typename Value>
+    void set_arg(void* kernel, cl_uint index, const Value& value)
+    {
+        api.check(api.set_kernel_arg(kernel, index, sizeof(Value), &value), "set a kernel argument");
+    }
+
+    // Sets the arguments from first_index on to the phase arguments.
+    void set_phase_args(void* kernel, cl_uint first_index, const phase_args& args)
+    {
+        set_arg(kernel, first_index, args.sample_rate);
+        set_arg(kernel, first_index + 1, args.amplitude);
+        set_arg(kernel, first_index + 2, args.time_increment);
+        set_arg(kernel, first_index + 3, args.radians_per_step);
+        set_arg(kernel, first_index + 4, args.integer_path);
+    }
+
+    opencl_api api;
+    void* device {};
+    void* context {};
+    void* queue {};
+    void* program {};
+    std::string name;
+};
+
+gpu_device::gpu_device(const std::string& name_filter)
+    : m_state(std::make_unique<state>())
+{
+    auto& api = m_state->api;
+
+    cl_uint platform_count {};
+    auto result = api.get_platform_ids(0, nullptr, &platform_count);
+    if (result == opencl_api::k_platform_not_found || platform_count == 0) {
+        throw_gpu_failure("No OpenCL platform is installed.");
+    }
+    api.check(result, "list the OpenCL platforms");
+
+    std::vector<void*> platforms(platform_count);
+    api.check(api.get_platform_ids(platform_count, platforms.data(), nullptr), "list the OpenCL platforms");
+
+    // the first GPU, else the first other device, of those supporting double precision
+    void* fallback {};
+    for (auto* platform : platforms) {
+        cl_uint device_count {};
+        if (api.get_device_ids(platform, opencl_api::k_device_type_all, 0, nullptr, &device_count) != opencl_api::k_success) {
+            continue;
+        }
+
+        std::vector<void*> devices(device_count);
+        api.get_device_ids(platform, opencl_api::k_device_type_all, device_count, devices.data(), nullptr);
+        for (auto* device : devices) {
+            auto name = get_device_string(api, device, opencl_api::k_device_name);
+            if (get_device_string(api, device, opencl_api::k_device_extensions).find("cl_khr_fp64") == std::string::npos
+                || name.find(name_filter) == std::string::npos) {
+                continue;
+            }
+
+            cl_ulong type {};
+            api.get_device_info(device, opencl_api::k_device_type, sizeof(type), &type, nullptr);
+            if (type & opencl_api::k_device_type_gpu) {
+                m_state->device = device;
+                break;
+            }
+            fallback = fallback ? fallback : device;
+        }
+
+        if (m_state->device) {
+            break;
+        }
+    }
+
+    m_state->device = m_state->device ? m_state->device : fallback;
+    if (!m_state->device) {
+        throw_gpu_failure(name_filter.empty() ? std::string("No OpenCL device supports double precision (cl_khr_fp64).")
+                                              : "No OpenCL device named " + name_filter + " supports double precision (cl_khr_fp64).");
+    }
+    m_state->name = get_device_string(api, m_state->device, opencl_api::k_device_name);
+
+    m_state->context = api.create_context(nullptr, 1, &m_state->device, nullptr, nullptr, &result);
+    api.check(result, "create an OpenCL context");
+    m_state->queue = api.create_command_queue(m_state->context, m_state->device, 0, &result);
+    api.check(result, "create an OpenCL command queue");
+
+    const char* source = k_program_source;
+    m_state->program = api.create_program_with_source(m_state->context, 1, &source, nullptr, &result);
+    api.check(result, "create the OpenCL program");
+
+    if (api.build_program(m_state->program, 1, &m_state->device, "", nullptr, nullptr) != opencl_api::k_success) {
+        std::size_t log_size {};
+        api.get_program_build_info(m_state->program, m_state->device, opencl_api::k_program_build_log, 0, nullptr, &log_size);
+        std::string log(log_size, '\0');
+        api.get_program_build_info(m_state->program, m_state->device, opencl_api::k_program_build_log, log_size, log.data(), nullptr);
+        throw_gpu_failure("Failed to build the OpenCL program for " + m_state->name + ": " + log);
+    }
+}
+
+gpu_device::~gpu_device() = default;
+
+const std::string& gpu_device::name() const
+{
+    return m_state->name;
+}
+
+gpu_sine_wave_generator::gpu_sine_wave_generator(gpu_device& device, uint32_t wave_amplitude, uint32_t wave_frequency,
+                                                 uint32_t sample_rate, oscillator_mode mode)
+    : m_device(device)
+    , m_amplitude(wave_amplitude)
+    , m_frequency(wave_frequency)
+    , m_sample_rate(sample_rate)
+    , m_mode(mode)
+    , m_kernel(device.m_state->create_kernel("generate_samples"))
+{
+}
+
+gpu_sine_wave_generator::~gpu_sine_wave_generator()
+{
+    auto& api = m_device.m_state->api;
+    if (m_samples) {
+        api.release_mem_object(m_samples);
+    }
+    api.release_kernel(m_kernel);
+}
+
+void gpu_sine_wave_generator::generate(std::span<int32_t> samples, uint64_t first_index)
+{
+    auto& state = *m_device.m_state;
+    auto block_size = std::min(samples.size(), k_max_kernel_samples);
+    if (block_size > m_capacity) {
+        if (m_samples) {
+            state.api.release_mem_object(m_samples);
+            m_samples = nullptr;
+        }
+        m_samples = state.create_buffer(opencl_api::k_mem_write_only, block_size * sizeof(int32_t));
+        m_capacity = block_size;
+    }
+
+    state.set_arg(m_kernel, 0, m_samples);
+    state.set_arg(m_kernel, 2, m_frequency);
+    state.set_phase_args(m_kernel, 3, get_phase_args(m_amplitude, m_sample_rate, m_mode));
+
+    for (std::size_t offset{}; offset < samples.size(); offset += block_size) {
+        std::size_t count = std::min(block_size, samples.size() - offset);
+        state.set_arg(m_kernel, 1, static_cast<cl_ulong>(first_index + offset));
+        state.api.check(state.api.enqueue_nd_range_kernel(state.queue, m_kernel, 1, nullptr, &count, nullptr, 0, nullptr, nullptr),
+                        "run the generator");
+        state.api.check(state.api.enqueue_read_buffer(state.queue, m_samples, opencl_api::k_true, 0, count * sizeof(int32_t),
+                                                      samples.data() + offset, 0, nullptr, nullptr),
+                        "copy the samples from the device");
+    }
+}
+
+/**
+ * The buffers of one chunk: the frames on the device and in pinned host memory, and the parameters
+ * of the waves, which stay in host memory until the chunk is done.
+ */
+struct gpu_batch_generator::slot
+{
+    void* frames {};
+    void* pinned {};
+    uint8_t* host_frames {};        // The mapping of pinned
+    void* frequencies {};
+    void* first_frames {};
+    void* frame_counts {};
+    void* done {};                  // Event of the copy into pinned host memory, while the chunk is in flight
+
+    std::vector<uint32_t> frequency_data;
+    std::vector<uint64_t> first_frame_data;
+    std::vector<uint32_t> frame_count_data;
+};
+
+gpu_batch_generator::gpu_batch_generator(gpu_device& device, const gpu_wave_settings& settings, uint32_t max_wave_count,
+                                         uint32_t chunk_frames, unsigned slot_count)
+    : m_device(device)
+    , m_settings(settings)
+    , m_max_wave_count(max_wave_count)
+    , m_chunk_frames(chunk_frames)
+    , m_frame_size(settings.channel_count * (settings.sample_format == sample_format::ieee_float ? 4u : 3u))
+{
+    if (max_wave_count == 0 || chunk_frames == 0 || slot_count == 0 || settings.channel_count == 0) {
+        throw std::invalid_argument("Invalid argument. A GPU batch needs at least one wave, frame, slot and channel.");
+    }
+
+    auto& state = *m_device.m_state;
+    m_kernel = state.create_kernel("pack_frames");
+
+    try {
+        std::size_t frames_size = static_cast<std::size_t>(max_wave_count) * chunk_frames * m_frame_size;
+        std::size_t wave_channel_count = static_cast<std::size_t>(max_wave_count) * settings.channel_count;
+        for (unsigned index{}; index < slot_count; ++index) {
+            auto& buffers = *m_slots.emplace_back(std::make_unique<slot>());
+
+            buffers.frames = state.create_buffer(opencl_api::k_mem_write_only, frames_size);
+            // host memory of the runtime, page locked, so copies into it go straight to it by DMA
+            buffers.pinned = state.create_buffer(opencl_api::k_mem_alloc_host_ptr, frames_size);
+            cl_int result {};
+            buffers.host_frames = static_cast<uint8_t*>(state.api.enqueue_map_buffer(state.queue, buffers.pinned, opencl_api::k_true,
+                                                                                     opencl_api::k_map_read_write, 0, frames_size,
+                                                                                     0, nullptr, nullptr, &result));
+            state.api.check(result, "map a pinned host buffer");
+
+            buffers.frequencies = state.create_buffer(opencl_api::k_mem_read_only, wave_channel_count * sizeof(uint32_t));
+            buffers.first_frames = state.create_buffer(opencl_api::k_mem_read_only, max_wave_count * sizeof(uint64_t));
+            buffers.frame_counts = state.create_buffer(opencl_api::k_mem_read_only, max_wave_count * sizeof(uint32_t));
+        }
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+gpu_batch_generator::~gpu_batch_generator()
+{
+    release();
+}
+
+void gpu_batch_generator::release() noexcept
+{
+    auto& api = m_device.m_state->api;
+    for (auto& buffers : m_slots) {
+        if (buffers->done) {
+            api.wait_for_events(1, &buffers->done);
+            api.release_event(buffers->done);
+        }
+        if (buffers->host_frames) {
+            api.enqueue_unmap_mem_object(m_device.m_state->queue, buffers->pinned, buffers->host_frames, 0, nullptr, nullptr);
+        }
+        for (auto* buffer : {buffers->frames, buffers->pinned, buffers->frequencies, buffers->first_frames, buffers->frame_counts}) {
+            if (buffer) {
+                api.release_mem_object(buffer);
+            }
+        }
+    }
+    m_slots.clear();
+
+    api.finish(m_device.m_state->queue);
+    if (m_kernel) {
+        api.release_kernel(m_kernel);
+        m_kernel = nullptr;
+    }
+}
+
+void gpu_batch_generator::enqueue(unsigned slot_index, std::span<const gpu_chunk_wave> waves)
+{
+    if (waves.size() > m_max_wave_count) {
+        throw std::invalid_argument("Invalid argument. A chunk holds more waves than the GPU batch was created for.");
+    }
+
+    wait(slot_index);
+    auto& state = *m_device.m_state;
+    auto& buffers = *m_slots[slot_index];
+    auto channel_count = m_settings.channel_count;
+
+    buffers.frequency_data.clear();
+    buffers.first_frame_data.clear();
+    buffers.frame_count_data.clear();
+    for (const auto& wave : waves) {
+        buffers.frequency_data.insert(buffers.frequency_data.end(), wave.channel_frequencies, wave.channel_frequencies + channel_count);
+        buffers.first_frame_data.push_back(wave.first_frame);
+        buffers.frame_count_data.push_back(std::min(wave.frame_count, m_chunk_frames));
+    }
+    if (waves.empty()) {
+        return;
+    }
+
+    auto& api = state.api;
+    api.check(api.enqueue_write_buffer(state.queue, buffers.frequencies, opencl_api::k_false, 0, buffers.frequency_data.size() * sizeof(uint32_t),
+                                       buffers.frequency_data.data(), 0, nullptr, nullptr), "copy the waves to the device");
+    api.check(api.enqueue_write_buffer(state.queue, buffers.first_frames, opencl_api::k_false, 0, waves.size() * sizeof(uint64_t),
+                                       buffers.first_frame_data.data(), 0, nullptr, nullptr), "copy the waves to the device");
+    api.check(api.enqueue_write_buffer(state.queue, buffers.frame_counts, opencl_api::k_false, 0, waves.size() * sizeof(uint32_t),
+                                       buffers.frame_count_data.data(), 0, nullptr, nullptr), "copy the waves to the device");
+
+    uint32_t wave_stride = m_chunk_frames * m_frame_size;
+    uint32_t sample_size = m_frame_size / channel_count;
+    state.set_arg(m_kernel, 0, buffers.frames);
+    state.set_arg(m_kernel, 1, buffers.frequencies);
+    state.set_arg(m_kernel, 2, buffers.first_frames);
+    state.set_arg(m_kernel, 3, buffers.frame_counts);
+    state.set_arg(m_kernel, 4, static_cast<cl_uint>(channel_count));
+    state.set_arg(m_kernel, 5, wave_stride);
+    state.set_arg(m_kernel, 6, sample_size);
+    state.set_phase_args(m_kernel, 7, get_phase_args(m_settings.amplitude, m_settings.sample_rate, m_settings.oscillator));
+
+    std::size_t global_sizes[2] {m_chunk_frames, waves.size()};
+    api.check(api.enqueue_nd_range_kernel(state.queue, m_kernel, 2, nullptr, global_sizes, nullptr, 0, nullptr, nullptr),
+              "run the frame generator");
+    api.check(api.enqueue_read_buffer(state.queue, buffers.frames, opencl_api::k_false, 0, waves.size() * wave_stride,
+                                      buffers.host_frames, 0, nullptr, &buffers.done), "copy the frames from the device");
+    api.flush(state.queue);
+}
+
+void gpu_batch_generator::wait(unsigned slot_index)
+{
+    auto& buffers = *m_slots[slot_index];
+    if (buffers.done) {
+        auto& api = m_device.m_state->api;
+        auto result = api.wait_for_events(1, &buffers.done);
+        api.release_event(buffers.done);
+        buffers.done = nullptr;
+        api.check(result, "generate the frames");
+    }
+}
+
+std::span<const uint8_t> gpu_batch_generator::get_frames(unsigned slot_index, std::size_t wave_index) const
+{
+    const auto& buffers = *m_slots[slot_index];
+    return {buffers.host_frames + wave_index * m_chunk_frames * m_frame_size,
+            static_cast<std::size_t>(buffers.frame_count_data[wave_index]) * m_frame_size};
+}
+
+}// namespace wavegen
@@ -0,0 +1,157 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Generation and packing of sine waves on an OpenCL device, for renders of many files at once.
+ */
+#ifndef GPU_GENERATOR_H_
+#define GPU_GENERATOR_H_
+
+#include <span>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "SineWaveGen.h"
+#include "SamplePacker.h"
+
+namespace wavegen
+{
+
+/**
+ * An OpenCL device with the program of the generators built for it. OpenCL is loaded at run
+ * time (libOpenCL.so.1, OpenCL.dll or the OpenCL framework), so wavegen neither needs its SDK
+ * to build nor a GPU to run. A GPU is preferred over other devices, and the device has to
+ * support double precision (cl_khr_fp64), which the phases need.
+ * Throws std::runtime_error if OpenCL or a suitable device is not available.
+ */
+class gpu_device
+{
+public:
+    // name_filter selects the first device whose name contains it, an empty filter any device.
+    explicit gpu_device(const std::string& name_filter = {});
+    ~gpu_device();
+
+    gpu_device(const gpu_device&) = delete;
+    gpu_device& operator=(const gpu_device&) = delete;
+
+    const std::string& name() const;
+
+private:
+    friend class gpu_sine_wave_generator;
+    friend class gpu_batch_generator;
+
+    struct state;
+    std::unique_ptr<state> m_state;
+};
+
+/**
+ * A sine_wave_generator evaluated on a gpu_device: the same constructor and generate().
+ * Every sample is evaluated in double precision from its index like the exact path of the CPU, or
+ * from its integer reduced phase like the integer path. The recursive and polynomial paths, which
+ * approximate the exact one, are evaluated like it. The sin of the device is accurate to a few
+ * ulp instead of being correctly rounded, so a sample may differ from the CPU by 1 LSB.
+ * A call generates the block and copies it back before it returns, which only pays off for large blocks.
+ */
+class gpu_sine_wave_generator
+{
+public:
+    gpu_sine_wave_generator(gpu_device& device, uint32_t wave_amplitude, uint32_t wave_frequency, uint32_t sample_rate,
+                            oscillator_mode mode = oscillator_mode::exact);
+    ~gpu_sine_wave_generator();
+
+    gpu_sine_wave_generator(const gpu_sine_wave_generator&) = delete;
+    gpu_sine_wave_generator& operator=(const gpu_sine_wave_generator&) = delete;
+
+    /**
+     * Fills the given block with consecutive samples, starting at first_index.
+     */
+    void generate(std::span<int32_t> samples, uint64_t first_index);
+
+    oscillator_mode mode() const { return m_mode; }
+
+private:
+    gpu_device& m_device;
+    uint32_t m_amplitude;
+    uint32_t m_frequency;
+    uint32_t m_sample_rate;
+    oscillator_mode m_mode;
+
+    void* m_kernel {};
+    void* m_samples {};             // Device buffer of the block
+    std::size_t m_capacity {};      // Samples of m_samples
+};
+
+// Settings shared by all waves of a gpu_batch_generator.
+struct gpu_wave_settings
+{
+    uint32_t amplitude {};
+    uint32_t sample_rate {};
+    uint16_t channel_count {1};
+    wavegen::sample_format sample_format {wavegen::sample_format::pcm};     // 24 bit PCM or 32 bit float
+    oscillator_mode oscillator {oscillator_mode::exact};
+};
+
+// The frames of one wave (e.g. a file) of a chunk of a gpu_batch_generator.
+struct gpu_chunk_wave
+{
+    const uint32_t* channel_frequencies {};     // Hz of every channel
+    uint64_t first_frame {};
+    uint32_t frame_count {};        // At most chunk_frames()
+};
+
+/**
+ * Generates and packs chunks of interleaved frames of many waves at once, like the frame writers of
+ * the CPU do with sine_wave_generator sources, one work item per frame of every wave.
+ * The packed frames are copied into pinned host memory of one of slot_count slots. Enqueuing a chunk
+ * returns at once, so the caller can write the frames of a slot while the next one is generated.
+ */
+class gpu_batch_generator
+{
+public:
+    gpu_batch_generator(gpu_device& device, const gpu_wave_settings& settings, uint32_t max_wave_count, uint32_t chunk_frames,
+                        unsigned slot_count = 2);
+    ~gpu_batch_generator();
+
+    gpu_batch_generator(const gpu_batch_generator&) = delete;
+    gpu_batch_generator& operator=(const gpu_batch_generator&) = delete;
+
+    /**
+     * Starts generating the frames of up to max_wave_count waves into slot, after waiting for
+     * the last chunk of the slot. Wave i of the chunk is wave i of the slot.
+     */
+    void enqueue(unsigned slot, std::span<const gpu_chunk_wave> waves);
+
+    /**
+     * Waits until the chunk of slot is in host memory. Throws std::runtime_error if it failed.
+     */
+    void wait(unsigned slot);
+
+    /**
+     * Returns the packed frames of wave wave_index of the chunk of slot, valid until the slot is enqueued again.
+     */
+    std::span<const uint8_t> get_frames(unsigned slot, std::size_t wave_index) const;
+
+    uint32_t max_wave_count() const { return m_max_wave_count; }
+    uint32_t chunk_frames() const { return m_chunk_frames; }
+    unsigned slot_count() const { return static_cast<unsigned>(m_slots.size()); }
+
+private:
+    struct slot;
+
+    // Waits for the chunks in flight and releases the buffers of the device.
+    void release() noexcept;
+
+    gpu_device& m_device;
+    gpu_wave_settings m_settings;
+    uint32_t m_max_wave_count;
+    uint32_t m_chunk_frames;
+    uint32_t m_frame_size;
+    void* m_kernel {};
+    std::vector<std::unique_ptr<slot>> m_slots;
+};
+
+}// namespace wavegen
+
+#endif // GPU_GENERATOR_H_
@@ -0,0 +1,148 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   A lazily evaluated sequence produced by a coroutine, for pulling blocks of a render on demand.
+ */
+#ifndef LAZY_GENERATOR_H_
+#define LAZY_GENERATOR_H_
+
+#include <memory>
+#include <utility>
+#include <cstddef>
+#include <iterator>
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+
+namespace wavegen
+{
+
+/**
+ * The values a coroutine co_yields, in the manner of C++23's std::generator, which the standard
+ * libraries wavegen is built with do not all ship yet. The coroutine does not run before the first
+ * value is pulled (begin()), and every further pull (++) runs it up to its next co_yield, so values
+ * which are not pulled are never computed. A value is referenced, not copied: it stays valid until
+ * the next pull. An exception thrown by the coroutine is rethrown by the pull.
+ * Move-only, destroying the generator destroys the suspended coroutine with its locals.
+ */
+template <typename T>
+class lazy_generator
+{
+public:
+    using value_type = std::remove_cvref_t<T>;
+
+    struct promise_type
+    {
+        const value_type* value {};
+        std::exception_ptr error;
+
+        lazy_generator get_return_object() { return lazy_generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        // a yielded temporary lives until the coroutine resumes
+        std::suspend_always yield_value(const value_type& yielded) noexcept
+        {
+            value = std::addressof(yielded);
+            return {};
+        }
+
+        void return_void() noexcept {}
+        void unhandled_exception() { error = std::current_exception(); }
+
+        // values are only produced by co_yield
+        template <typename Awaitable>
+        void await_transform(Awaitable&&) = delete;
+    };
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = lazy_generator::value_type;
+
+        iterator() = default;
+
+        const value_type& operator*() const { return *m_coroutine.promise().value; }
+        const value_type* operator->() const { return m_coroutine.promise().value; }
+
+        iterator& operator++()
+        {
+            resume(m_coroutine);
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const { return !m_coroutine || m_coroutine.done(); }
+
+    private:
+        friend class lazy_generator;
+
+        explicit iterator(std::coroutine_handle<promise_type> coroutine)
+            : m_coroutine(coroutine)
+        {
+        }
+
+        std::coroutine_handle<promise_type> m_coroutine;
+    };
+
+    lazy_generator() = default;
+
+    lazy_generator(lazy_generator&& other) noexcept
+        : m_coroutine(std::exchange(other.m_coroutine, {}))
+    {
+    }
+
+    lazy_generator& operator=(lazy_generator&& other) noexcept
+    {
+        if (this != &other) {
+            release();
+            m_coroutine = std::exchange(other.m_coroutine, {});
+        }
+        return *this;
+    }
+
+    ~lazy_generator() { release(); }
+
+    /**
+     * Runs the coroutine up to its first value. Has to be called once, before the first ++.
+     */
+    iterator begin()
+    {
+        if (m_coroutine) {
+            resume(m_coroutine);
+        }
+        return iterator(m_coroutine);
+    }
+
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+    explicit lazy_generator(std::coroutine_handle<promise_type> coroutine)
+        : m_coroutine(coroutine)
+    {
+    }
+
+    static void resume(std::coroutine_handle<promise_type> coroutine)
+    {
+        coroutine.resume();
+        if (auto error = std::exchange(coroutine.promise().error, nullptr)) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    void release() noexcept
+    {
+        if (m_coroutine) {
+            m_coroutine.destroy();
+            m_coroutine = {};
+        }
+    }
+
+    std::coroutine_handle<promise_type> m_coroutine;
+};
+
+}// namespace wavegen
+
+#endif // LAZY_GENERATOR_H_
@@ -0,0 +1,132 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   A file of fixed size which is written through a shared memory mapping.
+ */
+#include "MappedFile.h"
+
+#include <fstream>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+namespace wavegen
+{
+
+#if defined(_WIN32)
+
+mapped_file::mapped_file(const std::string& file_path, uint64_t size)
+    : m_size(size)
+{
+    m_file = CreateFileA(file_path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        throw std::ofstream::failure("File generation failed. Failed to open file " + file_path);
+    }
+
+    // creating the mapping extends the file to the mapped size
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr);
+    if (!m_mapping) {
+        release();
+        throw std::ofstream::failure("File generation failed. Failed to resize file " + file_path);
+    }
+
+    m_data = static_cast<uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, 0));
+    if (!m_data) {
+        release();
+        throw std::ofstream::failure("File generation failed. Failed to map file " + file_path);
+    }
+}
+
+void mapped_file::close()
+{
+    bool unmapped = !m_data || UnmapViewOfFile(m_data);
+    m_data = nullptr;
+    release();
+
+    if (!unmapped) {
+        throw std::ofstream::failure("File generation failed. Failed to write audio data to file.");
+    }
+}
+
+void mapped_file::release() noexcept
+{
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+
+    if (m_file) {
+        CloseHandle(m_file);
+        m_file = nullptr;
+    }
+}
+
+#else
+
+mapped_file::mapped_file(const std::string& file_path, uint64_t size)
+    : m_size(size)
+{
+    m_fd = ::open(file_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (m_fd < 0) {
+        throw std::ofstream::failure("File generation failed. Failed to open file " + file_path);
+    }
+
+    if (::ftruncate(m_fd, static_cast<off_t>(size)) != 0) {
+        release();
+        throw std::ofstream::failure("File generation failed. Failed to resize file " + file_path);
+    }
+
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (data == MAP_FAILED) {
+        release();
+        throw std::ofstream::failure("File generation failed. Failed to map file " + file_path);
+    }
+    m_data = static_cast<uint8_t*>(data);
+}
+
+void mapped_file::close()
+{
+    bool unmapped = !m_data || ::munmap(m_data, m_size) == 0;
+    m_data = nullptr;
+    bool closed = m_fd < 0 || ::close(m_fd) == 0;
+    m_fd = -1;
+
+    if (!unmapped || !closed) {
+        throw std::ofstream::failure("File generation failed. Failed to write audio data to file.");
+    }
+}
+
+void mapped_file::release() noexcept
+{
+    if (m_data) {
+        ::munmap(m_data, m_size);
+        m_data = nullptr;
+    }
+
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+#endif
+
+mapped_file::~mapped_file()
+{
+    release();
+}
+
+}// namespace wavegen
@@ -0,0 +1,53 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   A file of fixed size which is written through a shared memory mapping.
+ */
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+#include <string>
+#include <cstdint>
+
+namespace wavegen
+{
+
+/**
+ * Creates (or truncates) a file of the given size and maps it writable into memory,
+ * so data can be generated straight into the page cache without an intermediate copy.
+ * Throws std::ofstream::failure if the file cannot be created or mapped.
+ */
+class mapped_file
+{
+public:
+    mapped_file(const std::string& file_path, uint64_t size);
+    ~mapped_file();
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    uint8_t* data() { return m_data; }
+    uint64_t size() const { return m_size; }
+
+    /**
+     * Unmaps and closes the file. Throws std::ofstream::failure if that fails.
+     */
+    void close();
+
+private:
+    void release() noexcept;
+
+    uint8_t* m_data {};
+    uint64_t m_size {};
+
+#if defined(_WIN32)
+    void* m_file {};
+    void* m_mapping {};
+#else
+    int m_fd {-1};
+#endif
+};
+
+}// namespace wavegen
+
+#endif // MAPPED_FILE_H_
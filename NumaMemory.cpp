@@ -0,0 +1,425 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   NUMA topology, thread pinning and huge page buffers, so the workers of a parallel
+ *          render generate into memory on their own node.
+ */
+#include "NumaMemory.h"
+
+#include <new>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <algorithm>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#if defined(__linux__)
+#include <sched.h>
+#include <fstream>
+#include <pthread.h>
+#include <filesystem>
+#endif
+
+namespace wavegen
+{
+
+namespace
+{
+
+inline std::size_t round_up(std::size_t size, std::size_t alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+// One node of all hardware threads, for systems whose topology is unknown.
+std::vector<std::vector<unsigned>> get_single_node()
+{
+    std::vector<unsigned> cpus(std::max(1u, std::thread::hardware_concurrency()));
+    for (unsigned cpu{}; cpu < cpus.size(); ++cpu) {
+        cpus[cpu] = cpu;
+    }
+
+    return {cpus};
+}
+
+#if defined(__linux__)
+
+// Parses a CPU list of the kernel, e.g. "0-3,8-11", keeping the CPUs the process may run on.
+std::vector<unsigned> parse_cpu_list(const std::string& list, const cpu_set_t& allowed)
+{
+    std::vector<unsigned> cpus;
+    std::size_t begin {};
+    while (begin < list.size()) {
+        auto end = std::min(list.find(',', begin), list.size());
+        auto range = list.substr(begin, end - begin);
+        begin = end + 1;
+
+        auto dash = range.find('-');
+        try {
+            unsigned first = std::stoul(range.substr(0, dash));
+            unsigned last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+            for (unsigned cpu {first}; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &allowed)) {
+                    cpus.push_back(cpu);
+                }
+            }
+        } catch (const std::exception&) {
+            // a malformed entry is left out, the kernel does not write any
+        }
+    }
+
+    return cpus;
+}
+
+std::vector<std::vector<unsigned>> read_numa_nodes()
+{
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return get_single_node();
+    }
+
+    std::vector<std::pair<unsigned long, std::vector<unsigned>>> nodes;
+    std::error_code error;
+    for (std::filesystem::directory_iterator entry("/sys/devices/system/node", error), end; !error && entry != end; entry.increment(error)) {
+        auto name = entry->path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 || name.find_first_not_of("0123456789", 4) != std::string::npos) {
+            continue;
+        }
+
+        std::ifstream file(entry->path() / "cpulist");
+        std::string list;
+        std::getline(file, list);
+        auto cpus = parse_cpu_list(list, allowed);
+        if (!cpus.empty()) {
+            nodes.emplace_back(std::stoul(name.substr(4)), std::move(cpus));
+        }
+    }
+
+    if (nodes.empty()) {
+        // no sysfs, e.g. a kernel without NUMA support: one node of the allowed CPUs
+        std::vector<unsigned> cpus;
+        for (unsigned cpu{}; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus.empty() ? get_single_node() : std::vector<std::vector<unsigned>> {cpus};
+    }
+
+    std::sort(nodes.begin(), nodes.end());
+    std::vector<std::vector<unsigned>> node_cpus;
+    for (auto& node : nodes) {
+        node_cpus.push_back(std::move(node.second));
+    }
+
+    return node_cpus;
+}
+
+#elif defined(_WIN32)
+
+// The nodes of the processor group of the process, which holds up to 64 CPUs.
+std::vector<std::vector<unsigned>> read_numa_nodes()
+{
+    ULONG highest_node {};
+    DWORD_PTR process_mask {};
+    DWORD_PTR system_mask {};
+    if (!GetNumaHighestNodeNumber(&highest_node) || !GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+        return get_single_node();
+    }
+
+    std::vector<std::vector<unsigned>> nodes;
+    for (ULONG node{}; node <= highest_node; ++node) {
+        ULONGLONG node_mask {};
+        if (!GetNumaNodeProcessorMask(static_cast<UCHAR>(node), &node_mask)) {
+            continue;
+        }
+
+        std::vector<unsigned> cpus;
+        for (unsigned cpu{}; cpu < 64; ++cpu) {
+            if ((node_mask & process_mask) >> cpu & 1) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (!cpus.empty()) {
+            nodes.push_back(std::move(cpus));
+        }
+    }
+
+    return nodes.empty() ? get_single_node() : nodes;
+}
+
+// Enables the privilege of large pages, which succeeds only if an administrator granted it to the account.
+bool enable_large_pages()
+{
+    HANDLE token {};
+    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+        return false;
+    }
+
+    TOKEN_PRIVILEGES privileges {};
+    privileges.PrivilegeCount = 1;
+    privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+    bool enabled = LookupPrivilegeValueA(nullptr, "SeLockMemoryPrivilege", &privileges.Privileges[0].Luid)
+                   && AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr)
+                   && GetLastError() == ERROR_SUCCESS;
+    CloseHandle(token);
+
+    return enabled;
+}
+
+#else
+
+std::vector<std::vector<unsigned>> read_numa_nodes()
+{
+    return get_single_node();
+}
+
+#endif
+
+}// namespace
+
+const std::vector<std::vector<unsigned>>& get_numa_nodes()
+{
+    static const auto nodes = read_numa_nodes();
+    return nodes;
+}
+
+unsigned get_worker_cpu(unsigned worker_index, unsigned worker_count)
+{
+    const auto& nodes = get_numa_nodes();
+    auto node_count = static_cast<uint64_t>(nodes.size());
+    worker_count = std::max(worker_count, worker_index + 1);
+
+    // workers [ceil(node * count / nodes), ceil((node + 1) * count / nodes)) run on node
+    auto node = static_cast<std::size_t>(worker_index * node_count / worker_count);
+    auto first_worker = static_cast<unsigned>((node * worker_count + node_count - 1) / node_count);
+    const auto& cpus = nodes[node];
+
+    return cpus[(worker_index - first_worker) % cpus.size()];
+}
+
+#if defined(__linux__)
+
+struct thread_pin::saved_affinity
+{
+    pthread_t thread;
+    cpu_set_t cpus;
+};
+
+bool pin_current_thread(unsigned cpu)
+{
+    if (cpu >= CPU_SETSIZE) {
+        return false;
+    }
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+}
+
+thread_pin::thread_pin(unsigned cpu)
+{
+    auto saved = std::make_unique<saved_affinity>();
+    saved->thread = pthread_self();
+    if (pthread_getaffinity_np(saved->thread, sizeof(saved->cpus), &saved->cpus) == 0 && pin_current_thread(cpu)) {
+        m_saved = saved.release();
+        m_pinned = true;
+    }
+}
+
+thread_pin::~thread_pin()
+{
+    if (m_saved) {
+        pthread_setaffinity_np(m_saved->thread, sizeof(m_saved->cpus), &m_saved->cpus);
+        delete m_saved;
+    }
+}
+
+#elif defined(_WIN32)
+
+struct thread_pin::saved_affinity
+{
+    HANDLE thread;
+    DWORD_PTR cpus;
+};
+
+bool pin_current_thread(unsigned cpu)
+{
+    return cpu < 64 && SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR {1} << cpu) != 0;
+}
+
+thread_pin::thread_pin(unsigned cpu)
+{
+    // a real handle of the thread, the pseudo handle of GetCurrentThread() means the destroying thread
+    HANDLE thread = OpenThread(THREAD_SET_INFORMATION | THREAD_QUERY_INFORMATION, FALSE, GetCurrentThreadId());
+    if (!thread) {
+        return;
+    }
+
+    DWORD_PTR cpus = cpu < 64 ? SetThreadAffinityMask(thread, DWORD_PTR {1} << cpu) : 0;
+    if (!cpus) {
+        CloseHandle(thread);
+        return;
+    }
+
+    m_saved = new saved_affinity {thread, cpus};
+    m_pinned = true;
+}
+
+thread_pin::~thread_pin()
+{
+    if (m_saved) {
+        SetThreadAffinityMask(m_saved->thread, m_saved->cpus);
+        CloseHandle(m_saved->thread);
+        delete m_saved;
+    }
+}
+
+#else
+
+// e.g. macOS, which has no API to pin threads to CPUs
+struct thread_pin::saved_affinity {};
+
+bool pin_current_thread(unsigned)
+{
+    return false;
+}
+
+thread_pin::thread_pin(unsigned) {}
+thread_pin::~thread_pin() = default;
+
+#endif
+
+#if defined(_WIN32)
+
+page_buffer::page_buffer(std::size_t size, unsigned writer_count)
+    : m_size(size)
+{
+    if (size == 0) {
+        return;
+    }
+
+    static const bool k_large_pages = enable_large_pages();
+    SIZE_T large_page_size = k_large_pages ? GetLargePageMinimum() : 0;
+    if (large_page_size && size >= large_page_size && writer_count <= 1) {
+        m_mapped_size = round_up(size, large_page_size);
+        m_data = static_cast<uint8_t*>(VirtualAlloc(nullptr, m_mapped_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE));
+        if (m_data) {
+            m_huge_pages = true;
+            return;
+        }
+    }
+
+    m_mapped_size = size;
+    m_data = static_cast<uint8_t*>(VirtualAlloc(nullptr, m_mapped_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+    if (!m_data) {
+        throw std::bad_alloc();
+    }
+}
+
+void page_buffer::release() noexcept
+{
+    if (m_data) {
+        VirtualFree(m_data, 0, MEM_RELEASE);
+        m_data = nullptr;
+    }
+}
+
+#else
+
+page_buffer::page_buffer(std::size_t size, unsigned writer_count)
+    : m_size(size)
+{
+    if (size == 0) {
+        return;
+    }
+
+    if (size / std::max(writer_count, 1u) < k_huge_page_size) {
+        m_mapped_size = round_up(size, static_cast<std::size_t>(sysconf(_SC_PAGESIZE)));
+        void* data = mmap(nullptr, m_mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        m_data = static_cast<uint8_t*>(data);
+        return;
+    }
+
+    m_mapped_size = round_up(size, k_huge_page_size);
+
+#if defined(MAP_HUGETLB)
+    // fails at once unless the administrator reserved enough huge pages, the mapping reserves them
+    void* huge_data = mmap(nullptr, m_mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (huge_data != MAP_FAILED) {
+        m_data = static_cast<uint8_t*>(huge_data);
+        m_huge_pages = true;
+        return;
+    }
+#endif
+
+    // transparent huge pages only back aligned 2 MiB ranges, the mapping is aligned by cutting off its ends
+    std::size_t padded_size = m_mapped_size + k_huge_page_size;
+    void* padded = mmap(nullptr, padded_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (padded == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+
+    auto padded_begin = reinterpret_cast<uintptr_t>(padded);
+    auto begin = round_up(padded_begin, k_huge_page_size);
+    if (begin > padded_begin) {
+        munmap(padded, begin - padded_begin);
+    }
+    munmap(reinterpret_cast<void*>(begin + m_mapped_size), padded_begin + padded_size - (begin + m_mapped_size));
+    m_data = reinterpret_cast<uint8_t*>(begin);
+
+#if defined(MADV_HUGEPAGE)
+    m_huge_pages = madvise(m_data, m_mapped_size, MADV_HUGEPAGE) == 0;
+#endif
+}
+
+void page_buffer::release() noexcept
+{
+    if (m_data) {
+        munmap(m_data, m_mapped_size);
+        m_data = nullptr;
+    }
+}
+
+#endif
+
+page_buffer::~page_buffer()
+{
+    release();
+}
+
+page_buffer::page_buffer(page_buffer&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+    , m_mapped_size(std::exchange(other.m_mapped_size, 0))
+    , m_huge_pages(std::exchange(other.m_huge_pages, false))
+{
+}
+
+page_buffer& page_buffer::operator=(page_buffer&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_mapped_size = std::exchange(other.m_mapped_size, 0);
+        m_huge_pages = std::exchange(other.m_huge_pages, false);
+    }
+
+    return *this;
+}
+
+}// namespace wavegen
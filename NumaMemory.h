@@ -0,0 +1,100 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   NUMA topology, thread pinning and huge page buffers, so the workers of a parallel
+ *          render generate into memory on their own node.
+ */
+#ifndef NUMA_MEMORY_H_
+#define NUMA_MEMORY_H_
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace wavegen
+{
+
+constexpr std::size_t k_huge_page_size {2u << 20};     // 2 MiB, buffers of at least this size are backed by huge pages
+
+/**
+ * Returns the CPUs the process may run on, grouped by NUMA node in the order of the nodes.
+ * Nodes without such CPUs are left out. Without NUMA support (or on a single node machine)
+ * all CPUs are on one node. The topology is read once.
+ */
+const std::vector<std::vector<unsigned>>& get_numa_nodes();
+
+/**
+ * Returns the CPU worker worker_index of worker_count pinned workers runs on. The workers are
+ * spread over the nodes in contiguous groups, so the contiguous ranges of thread_pool::for_each_range
+ * of a node's workers are contiguous in memory as well, and the workers of a node take its CPUs in turn.
+ */
+unsigned get_worker_cpu(unsigned worker_index, unsigned worker_count);
+
+/**
+ * Pins the calling thread to the given CPU. Returns false if the OS does not support or refuses it.
+ */
+bool pin_current_thread(unsigned cpu);
+
+/**
+ * Pins the calling thread to a CPU while it exists, and restores the CPUs the thread could run on
+ * before once it is destroyed, also by another thread as long as the pinned one still runs.
+ */
+class thread_pin
+{
+public:
+    explicit thread_pin(unsigned cpu);
+    ~thread_pin();
+
+    thread_pin(const thread_pin&) = delete;
+    thread_pin& operator=(const thread_pin&) = delete;
+
+    bool pinned() const { return m_pinned; }
+
+private:
+    struct saved_affinity;
+    saved_affinity* m_saved {};
+    bool m_pinned {};
+};
+
+/**
+ * Page aligned memory straight from the OS, backed by huge pages where available: a reserved
+ * MAP_HUGETLB page on Linux, else transparent huge pages through madvise(MADV_HUGEPAGE), or large pages
+ * on Windows where the process holds the privilege. Small buffers use normal pages.
+ * The memory is zero and, except for Windows large pages which are committed at once, not backed by
+ * pages before its first write, so the pages land on the node of the thread first writing them.
+ * A buffer split into writer_count contiguous parts, each first written by another (pinned) thread,
+ * only gets huge pages if every part spans at least one: a huge page lands on the node of the first
+ * of its writers, so smaller parts would share pages with their neighbours on other nodes. Such a
+ * buffer never gets Windows large pages.
+ * Throws std::bad_alloc if the memory cannot be allocated.
+ */
+class page_buffer
+{
+public:
+    page_buffer() = default;
+    explicit page_buffer(std::size_t size, unsigned writer_count = 1);
+    ~page_buffer();
+
+    page_buffer(page_buffer&& other) noexcept;
+    page_buffer& operator=(page_buffer&& other) noexcept;
+
+    uint8_t* data() { return m_data; }
+    const uint8_t* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    // True if huge pages back the buffer, or were at least requested for it (transparent huge pages).
+    bool huge_pages() const { return m_huge_pages; }
+
+private:
+    void release() noexcept;
+
+    uint8_t* m_data {};
+    std::size_t m_size {};
+    std::size_t m_mapped_size {};
+    bool m_huge_pages {};
+};
+
+}// namespace wavegen
+
+#endif // NUMA_MEMORY_H_
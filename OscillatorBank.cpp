@@ -0,0 +1,212 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   A bank of sinusoidal oscillators which are summed into one block of samples,
+ *          for chords and harmonic spectra (additive synthesis).
+ */
+#include "OscillatorBank.h"
+#include "CpuFeatures.h"
+#include "SineKernels.h"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+
+#if defined(WAVEGEN_X86)
+#include <immintrin.h>
+#elif defined(WAVEGEN_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace wavegen
+{
+
+namespace
+{
+
+constexpr double k_two_pi {6.283185307179586};
+
+/**
+ * Seeds lane j of a phasor with the phase of sample j and returns the rotation by lane_count samples.
+ */
+void seed_lanes(const partial_args& args, std::size_t lane_count, double* re, double* im, double& rotation_re, double& rotation_im)
+{
+    for (std::size_t lane{}; lane < lane_count; ++lane) {
+        double phase = k_two_pi * (args.phase + lane * args.phase_increment);
+        re[lane] = std::cos(phase);
+        im[lane] = std::sin(phase);
+    }
+
+    rotation_re = std::cos(k_two_pi * lane_count * args.phase_increment);
+    rotation_im = std::sin(k_two_pi * lane_count * args.phase_increment);
+}
+
+void partial_scalar(const partial_args& args, double* accumulators, std::size_t count)
+{
+    double re{}, im{}, rotation_re{}, rotation_im{};
+    seed_lanes(args, 1, &re, &im, rotation_re, rotation_im);
+
+    for (std::size_t i{}; i < count; ++i) {
+        accumulators[i] += args.amplitude * im;
+
+        double next_re = re * rotation_re - im * rotation_im;
+        im = re * rotation_im + im * rotation_re;
+        re = next_re;
+    }
+}
+
+#if defined(WAVEGEN_X86)
+
+WAVEGEN_TARGET("avx2,fma")
+void partial_avx2(const partial_args& args, double* accumulators, std::size_t count)
+{
+    alignas(32) double lane_re[4], lane_im[4];
+    double rotation_re{}, rotation_im{};
+    seed_lanes(args, 4, lane_re, lane_im, rotation_re, rotation_im);
+
+    const __m256d amplitude = _mm256_set1_pd(args.amplitude);
+    const __m256d rot_re = _mm256_set1_pd(rotation_re);
+    const __m256d rot_im = _mm256_set1_pd(rotation_im);
+    __m256d re = _mm256_load_pd(lane_re);
+    __m256d im = _mm256_load_pd(lane_im);
+
+    std::size_t i{};
+    for (; i + 4 <= count; i += 4) {
+        __m256d acc = _mm256_loadu_pd(accumulators + i);
+        _mm256_storeu_pd(accumulators + i, _mm256_fmadd_pd(amplitude, im, acc));
+
+        __m256d next_re = _mm256_fmsub_pd(re, rot_re, _mm256_mul_pd(im, rot_im));
+        im = _mm256_fmadd_pd(re, rot_im, _mm256_mul_pd(im, rot_re));
+        re = next_re;
+    }
+
+    _mm256_store_pd(lane_im, im);
+    for (std::size_t lane{}; i < count; ++i, ++lane) {
+        accumulators[i] += args.amplitude * lane_im[lane];
+    }
+}
+
+WAVEGEN_TARGET("avx512f,avx512bw")
+void partial_avx512(const partial_args& args, double* accumulators, std::size_t count)
+{
+    alignas(64) double lane_re[8], lane_im[8];
+    double rotation_re{}, rotation_im{};
+    seed_lanes(args, 8, lane_re, lane_im, rotation_re, rotation_im);
+
+    const __m512d amplitude = _mm512_set1_pd(args.amplitude);
+    const __m512d rot_re = _mm512_set1_pd(rotation_re);
+    const __m512d rot_im = _mm512_set1_pd(rotation_im);
+    __m512d re = _mm512_load_pd(lane_re);
+    __m512d im = _mm512_load_pd(lane_im);
+
+    std::size_t i{};
+    for (; i + 8 <= count; i += 8) {
+        __m512d acc = _mm512_loadu_pd(accumulators + i);
+        _mm512_storeu_pd(accumulators + i, _mm512_fmadd_pd(amplitude, im, acc));
+
+        __m512d next_re = _mm512_fmsub_pd(re, rot_re, _mm512_mul_pd(im, rot_im));
+        im = _mm512_fmadd_pd(re, rot_im, _mm512_mul_pd(im, rot_re));
+        re = next_re;
+    }
+
+    _mm512_store_pd(lane_im, im);
+    for (std::size_t lane{}; i < count; ++i, ++lane) {
+        accumulators[i] += args.amplitude * lane_im[lane];
+    }
+}
+
+#elif defined(WAVEGEN_NEON)
+
+void partial_neon(const partial_args& args, double* accumulators, std::size_t count)
+{
+    double lane_re[2], lane_im[2];
+    double rotation_re{}, rotation_im{};
+    seed_lanes(args, 2, lane_re, lane_im, rotation_re, rotation_im);
+
+    float64x2_t re = vld1q_f64(lane_re);
+    float64x2_t im = vld1q_f64(lane_im);
+
+    std::size_t i{};
+    for (; i + 2 <= count; i += 2) {
+        vst1q_f64(accumulators + i, vfmaq_n_f64(vld1q_f64(accumulators + i), im, args.amplitude));
+
+        float64x2_t next_re = vfmsq_n_f64(vmulq_n_f64(re, rotation_re), im, rotation_im);
+        im = vfmaq_n_f64(vmulq_n_f64(im, rotation_re), re, rotation_im);
+        re = next_re;
+    }
+
+    if (i < count) {
+        accumulators[i] += args.amplitude * vgetq_lane_f64(im, 0);
+    }
+}
+
+#endif
+
+partial_kernel best_partial_kernel()
+{
+#if defined(WAVEGEN_X86)
+    if (cpu_supports(simd_isa::avx512)) {
+        return partial_avx512;
+    }
+    if (cpu_supports(simd_isa::avx2)) {
+        return partial_avx2;
+    }
+#elif defined(WAVEGEN_NEON)
+    return partial_neon;
+#endif
+    return partial_scalar;
+}
+
+}// namespace
+
+oscillator_bank::oscillator_bank(uint32_t sample_rate)
+    : m_sample_rate(sample_rate)
+    , m_kernel(best_partial_kernel())
+{
+}
+
+void oscillator_bank::add_partial(double frequency, double amplitude, double phase)
+{
+    if (!(frequency >= 0.0 && frequency <= m_sample_rate / 2.0)) {
+        throw std::invalid_argument("Invalid argument. Partial frequency should be between 0 and half of the sample rate.");
+    }
+
+    m_phases.push_back(phase - std::floor(phase));
+    m_phase_increments.push_back(frequency / m_sample_rate);
+    m_amplitudes.push_back(amplitude);
+}
+
+void oscillator_bank::accumulate_block(uint64_t block_index, std::size_t count, double* accumulators) const
+{
+    std::fill_n(accumulators, count, 0.0);
+
+    for (std::size_t partial{}; partial < m_amplitudes.size(); ++partial) {
+        double phase = m_phases[partial] + fractional_product(static_cast<double>(block_index), m_phase_increments[partial]);
+        m_kernel({m_amplitudes[partial], phase - std::floor(phase), m_phase_increments[partial]}, accumulators, count);
+    }
+}
+
+void oscillator_bank::generate(std::span<int32_t> samples, uint64_t first_index) const
+{
+    constexpr double k_min = std::numeric_limits<int32_t>::min();
+    constexpr double k_max = std::numeric_limits<int32_t>::max();
+
+    alignas(64) double accumulators[k_block_size];
+
+    for (std::size_t offset{}; offset < samples.size(); ) {
+        // blocks start at multiples of k_block_size, samples before first_index are skipped
+        auto sample_index = first_index + offset;
+        auto block_offset = sample_index % k_block_size;
+        auto count = std::min<std::size_t>(k_block_size - block_offset, samples.size() - offset);
+
+        accumulate_block(sample_index - block_offset, block_offset + count, accumulators);
+
+        for (std::size_t i{}; i < count; ++i) {
+            samples[offset + i] = static_cast<int32_t>(std::clamp(accumulators[block_offset + i], k_min, k_max));
+        }
+        offset += count;
+    }
+}
+
+}// namespace wavegen
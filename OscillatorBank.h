@@ -0,0 +1,75 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   A bank of sinusoidal oscillators which are summed into one block of samples,
+ *          for chords and harmonic spectra (additive synthesis).
+ */
+#ifndef OSCILLATOR_BANK_H_
+#define OSCILLATOR_BANK_H_
+
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace wavegen
+{
+
+/**
+ * Adds amplitude * sin(2 * pi * (phase + i * phase_increment)) to accumulator i of count accumulators.
+ * Phases are given in turns.
+ */
+struct partial_args
+{
+    double amplitude;
+    double phase;
+    double phase_increment;
+};
+
+using partial_kernel = void (*)(const partial_args& args, double* accumulators, std::size_t count);
+
+/**
+ * Sum of sinusoidal partials. The partials are stored in structure-of-arrays layout
+ * (phase, increment and amplitude arrays). Every block is rendered partial by partial:
+ * a partial runs as a rotating phasor over the whole block, vectorised across consecutive
+ * samples, and is accumulated into a block of doubles that stays in L1 cache. The cost per
+ * sample is a complex multiply and an add per partial, so it grows linearly.
+ *
+ * Blocks are aligned to absolute sample indices and every phasor starts from a phase
+ * computed exactly for the block, so a sample only depends on its index.
+ */
+class oscillator_bank
+{
+public:
+    static constexpr std::size_t k_block_size {1'024};  // Samples accumulated per block
+
+    explicit oscillator_bank(uint32_t sample_rate);
+
+    /**
+     * Adds a partial. Frequency is given in Hz, amplitude in sample units and phase in turns.
+     * Throws std::invalid_argument for a frequency outside [0, sample_rate / 2].
+     */
+    void add_partial(double frequency, double amplitude, double phase = 0.0);
+
+    std::size_t size() const { return m_amplitudes.size(); }
+
+    /**
+     * Fills the given block with the sum of all partials, starting at first_index.
+     * Sums beyond the int32_t range saturate.
+     */
+    void generate(std::span<int32_t> samples, uint64_t first_index) const;
+
+private:
+    void accumulate_block(uint64_t block_index, std::size_t count, double* accumulators) const;
+
+    uint32_t m_sample_rate;
+    partial_kernel m_kernel;
+
+    std::vector<double> m_phases;           // Phase at sample 0, in turns
+    std::vector<double> m_phase_increments; // Turns per sample
+    std::vector<double> m_amplitudes;
+};
+
+}// namespace wavegen
+
+#endif // OSCILLATOR_BANK_H_
@@ -0,0 +1,346 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   A sequential, non-seekable destination of a render: stdout, a named pipe or a TCP socket.
+ */
+#include "OutputSink.h"
+
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+
+namespace wavegen
+{
+
+namespace
+{
+
+constexpr char k_tcp_prefix[] {"tcp://"};
+
+bool is_tcp_target(const std::string& target)
+{
+    return target.rfind(k_tcp_prefix, 0) == 0;
+}
+
+/**
+ * Splits "tcp://<host>:<port>" into host and port, the host may be an IPv6 address in brackets.
+ */
+void parse_tcp_target(const std::string& target, std::string& host, std::string& port)
+{
+    auto address = target.substr(sizeof(k_tcp_prefix) - 1);
+    auto colon = address.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == address.size()) {
+        throw std::invalid_argument("Invalid argument. A TCP output should be given as tcp://<host>:<port>.");
+    }
+
+    host = address.substr(0, colon);
+    port = address.substr(colon + 1);
+    if (host.size() > 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+}
+
+[[noreturn]] void throw_write_failure()
+{
+    throw std::ofstream::failure("File generation failed. Failed to write audio data to the output.");
+}
+
+}// namespace
+
+#if defined(_WIN32)
+
+bool is_sink_target(const std::string& target)
+{
+    return target == "-" || is_tcp_target(target) || target.rfind("\\\\.\\pipe\\", 0) == 0;
+}
+
+output_sink::output_sink(const std::string& target)
+{
+    if (target == "-") {
+        m_kind = sink_kind::stdout_stream;
+        m_handle = GetStdHandle(STD_OUTPUT_HANDLE);
+        if (!m_handle || m_handle == INVALID_HANDLE_VALUE) {
+            m_handle = nullptr;
+            throw std::ofstream::failure("File generation failed. The standard output is not available.");
+        }
+        return;
+    }
+
+    if (!is_tcp_target(target)) {
+        m_kind = sink_kind::pipe;
+        m_handle = CreateFileA(target.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_handle == INVALID_HANDLE_VALUE) {
+            m_handle = nullptr;
+            throw std::ofstream::failure("File generation failed. Failed to open pipe " + target);
+        }
+        return;
+    }
+
+    m_kind = sink_kind::tcp;
+    std::string host, port;
+    parse_tcp_target(target, host, port);
+
+    WSADATA wsa_data;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0) {
+        throw std::ofstream::failure("File generation failed. Failed to initialize Winsock.");
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses{};
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0) {
+        WSACleanup();
+        throw std::ofstream::failure("File generation failed. Failed to resolve " + target);
+    }
+
+    for (auto* address = addresses; address; address = address->ai_next) {
+        SOCKET sock = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (sock == INVALID_SOCKET) {
+            continue;
+        }
+        if (connect(sock, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0) {
+            m_socket = sock;
+            break;
+        }
+        closesocket(sock);
+    }
+    freeaddrinfo(addresses);
+
+    if (m_socket == INVALID_SOCKET) {
+        WSACleanup();
+        throw std::ofstream::failure("File generation failed. Failed to connect to " + target);
+    }
+
+    BOOL no_delay = TRUE;
+    setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&no_delay), sizeof(no_delay));
+}
+
+void output_sink::write(const uint8_t* data, std::size_t size)
+{
+    while (size > 0) {
+        int chunk = static_cast<int>(std::min<std::size_t>(size, 1u << 30));
+        if (m_kind == sink_kind::tcp) {
+            chunk = send(m_socket, reinterpret_cast<const char*>(data), chunk, 0);
+            if (chunk == SOCKET_ERROR) {
+                throw_write_failure();
+            }
+        } else {
+            DWORD written{};
+            if (!WriteFile(m_handle, data, static_cast<DWORD>(chunk), &written, nullptr)) {
+                throw_write_failure();
+            }
+            chunk = static_cast<int>(written);
+        }
+
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+void output_sink::close()
+{
+    bool closed = true;
+    if (m_kind == sink_kind::tcp && m_socket != INVALID_SOCKET) {
+        closed = shutdown(m_socket, SD_SEND) == 0;
+    } else if (m_kind == sink_kind::stdout_stream && m_handle) {
+        FlushFileBuffers(m_handle);
+    }
+    release();
+
+    if (!closed) {
+        throw_write_failure();
+    }
+}
+
+void output_sink::release() noexcept
+{
+    if (m_kind == sink_kind::tcp && m_socket != INVALID_SOCKET) {
+        closesocket(m_socket);
+        m_socket = INVALID_SOCKET;
+        WSACleanup();
+    }
+
+    if (m_kind == sink_kind::pipe && m_handle) {
+        CloseHandle(m_handle);
+    }
+    m_handle = nullptr;
+}
+
+#else
+
+bool is_sink_target(const std::string& target)
+{
+    struct stat status{};
+    return target == "-" || is_tcp_target(target) || (::stat(target.c_str(), &status) == 0 && S_ISFIFO(status.st_mode));
+}
+
+output_sink::output_sink(const std::string& target)
+{
+    // a reader going away fails the write with EPIPE instead of terminating the process
+    std::signal(SIGPIPE, SIG_IGN);
+
+    if (target == "-") {
+        m_kind = sink_kind::stdout_stream;
+        m_fd = STDOUT_FILENO;
+        return;
+    }
+
+    if (!is_tcp_target(target)) {
+        // blocks until the pipe has a reader
+        m_kind = sink_kind::pipe;
+        m_fd = ::open(target.c_str(), O_WRONLY);
+        if (m_fd < 0) {
+            throw std::ofstream::failure("File generation failed. Failed to open pipe " + target);
+        }
+        return;
+    }
+
+    m_kind = sink_kind::tcp;
+    std::string host, port;
+    parse_tcp_target(target, host, port);
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses{};
+    if (::getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0) {
+        throw std::ofstream::failure("File generation failed. Failed to resolve " + target);
+    }
+
+    for (auto* address = addresses; address; address = address->ai_next) {
+        int fd = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (::connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+            m_fd = fd;
+            break;
+        }
+        ::close(fd);
+    }
+    ::freeaddrinfo(addresses);
+
+    if (m_fd < 0) {
+        throw std::ofstream::failure("File generation failed. Failed to connect to " + target);
+    }
+
+    int no_delay = 1;
+    ::setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+}
+
+void output_sink::write(const uint8_t* data, std::size_t size)
+{
+    while (size > 0) {
+        auto written = ::write(m_fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw_write_failure();
+        }
+
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+void output_sink::close()
+{
+    bool closed = true;
+    if (m_kind == sink_kind::tcp && m_fd >= 0) {
+        closed = ::shutdown(m_fd, SHUT_WR) == 0;
+    }
+    if (m_kind != sink_kind::stdout_stream && m_fd >= 0) {
+        closed = ::close(m_fd) == 0 && closed;
+    }
+    m_fd = -1;
+
+    if (!closed) {
+        throw_write_failure();
+    }
+}
+
+void output_sink::release() noexcept
+{
+    if (m_kind != sink_kind::stdout_stream && m_fd >= 0) {
+        ::close(m_fd);
+    }
+    m_fd = -1;
+}
+
+#endif
+
+void output_sink::write_file(const std::string& file_path, uint64_t offset, uint64_t size)
+{
+#if defined(__linux__)
+    int fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::ifstream::failure("File generation failed. Failed to open file " + file_path);
+    }
+
+    auto position = static_cast<off_t>(offset);
+    while (size > 0) {
+        auto sent = ::sendfile(m_fd, fd, &position, static_cast<std::size_t>(std::min<uint64_t>(size, 1u << 30)));
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            break;  // a destination sendfile cannot write to continues below, a failing one fails there too
+        }
+        size -= static_cast<uint64_t>(sent);
+    }
+    ::close(fd);
+    offset = static_cast<uint64_t>(position);
+
+    if (size == 0) {
+        return;
+    }
+#endif
+
+    std::ifstream file(file_path, std::ifstream::binary);
+    if (!file.is_open() || file.seekg(static_cast<std::streamoff>(offset)).fail()) {
+        throw std::ifstream::failure("File generation failed. Failed to open file " + file_path);
+    }
+
+    std::vector<uint8_t> buffer(static_cast<std::size_t>(std::min<uint64_t>(size, 1u << 20)));
+    while (size > 0) {
+        auto chunk = static_cast<std::size_t>(std::min<uint64_t>(size, buffer.size()));
+        if (file.read(reinterpret_cast<char*>(buffer.data()), chunk).fail()) {
+            throw std::ifstream::failure("File generation failed. Failed to read file " + file_path);
+        }
+        write(buffer.data(), chunk);
+        size -= chunk;
+    }
+}
+
+output_sink::~output_sink()
+{
+    release();
+}
+
+}// namespace wavegen
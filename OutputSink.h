@@ -0,0 +1,79 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   A sequential, non-seekable destination of a render: stdout, a named pipe or a TCP socket.
+ */
+#ifndef OUTPUT_SINK_H_
+#define OUTPUT_SINK_H_
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace wavegen
+{
+
+// The kind of destination an output sink writes to.
+enum class sink_kind
+{
+    stdout_stream,  // "-", the standard output of the process
+    pipe,           // an existing named pipe (FIFO), or \\.\pipe\<name> on Windows
+    tcp             // "tcp://<host>:<port>", a TCP connection to a listening peer
+};
+
+/**
+ * Returns true if the given output path names a sink rather than a regular file.
+ */
+bool is_sink_target(const std::string& target);
+
+/**
+ * Streams bytes to a destination which cannot seek, so everything written is final.
+ * Writes block until all bytes have been handed to the kernel; no user space buffering
+ * is added, so a block reaches the reader as soon as write() returns. Sockets are opened
+ * with Nagle's algorithm disabled for the same reason.
+ * Throws std::ofstream::failure if the destination cannot be opened or written, including
+ * when the reader goes away in the middle of a render.
+ */
+class output_sink
+{
+public:
+    explicit output_sink(const std::string& target);
+    ~output_sink();
+
+    output_sink(const output_sink&) = delete;
+    output_sink& operator=(const output_sink&) = delete;
+
+    /**
+     * Writes all size bytes of data.
+     */
+    void write(const uint8_t* data, std::size_t size);
+
+    /**
+     * Writes size bytes of the given file, starting at offset. On Linux the kernel copies them
+     * with sendfile, without passing through user space.
+     */
+    void write_file(const std::string& file_path, uint64_t offset, uint64_t size);
+
+    /**
+     * Closes the destination. The standard output is left open.
+     */
+    void close();
+
+    sink_kind kind() const { return m_kind; }
+
+private:
+    void release() noexcept;
+
+    sink_kind m_kind {sink_kind::stdout_stream};
+
+#if defined(_WIN32)
+    void* m_handle {};
+    uintptr_t m_socket {~uintptr_t{}};
+#else
+    int m_fd {-1};
+#endif
+};
+
+}// namespace wavegen
+
+#endif // OUTPUT_SINK_H_
@@ -0,0 +1,102 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   A lookup table holding one period of packed audio data, tiled into the output.
+ */
+#ifndef PERIOD_TABLE_H_
+#define PERIOD_TABLE_H_
+
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <algorithm>
+
+#include "SamplePacker.h"
+
+namespace wavegen
+{
+
+/**
+ * Returns the number of samples after which a wave of an integer frequency repeats exactly.
+ */
+inline uint32_t period_sample_count(uint32_t wave_frequency, uint32_t sample_rate)
+{
+    return sample_rate / std::gcd(wave_frequency, sample_rate);
+}
+
+/**
+ * Holds packed samples of a periodic wave, computed once, and fills the output by copying
+ * them, so generation becomes a memory bandwidth bound operation.
+ * Short periods are repeated in the table up to k_min_table_size bytes, so every copy
+ * moves a large chunk of memory.
+ */
+class period_table
+{
+public:
+    static constexpr std::size_t k_min_table_size {64 * 1024};
+
+    // period holds the samples of one period, starting at sample index 0
+    period_table(std::span<const int32_t> period, uint16_t bits_per_sample, sample_format format = sample_format::pcm)
+        : m_period_samples(static_cast<uint32_t>(period.size()))
+        , m_bytes_per_sample(bits_per_sample / 8)
+    {
+        resize_table();
+        pack_samples(period, bits_per_sample, m_table.data(), format);
+        tile_period();
+    }
+
+    // period holds one period of packed data, bytes_per_sample may also be the size of a whole frame
+    period_table(std::span<const uint8_t> period, std::size_t bytes_per_sample)
+        : m_period_samples(static_cast<uint32_t>(period.size() / bytes_per_sample))
+        , m_bytes_per_sample(bytes_per_sample)
+    {
+        resize_table();
+        std::memcpy(m_table.data(), period.data(), period.size());
+        tile_period();
+    }
+
+    /**
+     * Writes the packed samples [first_sample, first_sample + sample_count) to out.
+     */
+    void fill(uint64_t first_sample, uint64_t sample_count, uint8_t* out) const {
+        while (sample_count > 0) {
+            auto position = static_cast<std::size_t>(first_sample % m_period_samples);
+            auto count = std::min<uint64_t>(m_table_samples - position, sample_count);
+
+            std::memcpy(out, m_table.data() + position * m_bytes_per_sample, count * m_bytes_per_sample);
+
+            out += count * m_bytes_per_sample;
+            first_sample += count;
+            sample_count -= count;
+        }
+    }
+
+    uint32_t period_samples() const { return m_period_samples; }
+
+private:
+    void resize_table() {
+        std::size_t min_samples = (k_min_table_size + m_bytes_per_sample - 1) / m_bytes_per_sample;
+        m_table_samples = (min_samples + m_period_samples - 1) / m_period_samples * m_period_samples;
+        m_table.resize(m_table_samples * m_bytes_per_sample);
+    }
+
+    // repeats the period at the start of the table up to its end
+    void tile_period() {
+        auto period_size = m_period_samples * m_bytes_per_sample;
+        for (auto offset = period_size; offset < m_table.size(); offset += period_size) {
+            std::memcpy(m_table.data() + offset, m_table.data(), period_size);
+        }
+    }
+
+    uint32_t m_period_samples;
+    std::size_t m_bytes_per_sample;
+    std::size_t m_table_samples {};     // Whole periods held by the table
+    std::vector<uint8_t> m_table;
+};
+
+}// namespace wavegen
+
+#endif // PERIOD_TABLE_H_
@@ -0,0 +1,356 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   An on-disk cache of rendered files, addressed by their generation parameters.
+ */
+#include "RenderCache.h"
+
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
+namespace wavegen
+{
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+constexpr char k_cache_extension[] {".wav"};
+constexpr char k_key_extension[] {".key"};
+
+/**
+ * Hash of the key, as 16 hex digits.
+ */
+std::string hash_key(const std::string& key)
+{
+    char digits[17];
+    std::snprintf(digits, sizeof(digits), "%016llx", static_cast<unsigned long long>(hash_render_key(key)));
+    return digits;
+}
+
+/**
+ * A name no other thread or process writes to, for a file renamed into place once complete.
+ */
+fs::path get_temporary_path(const fs::path& path)
+{
+    auto ticks = std::chrono::steady_clock::now().time_since_epoch().count();
+    auto thread = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return path.string() + ".tmp-" + std::to_string(thread) + "-" + std::to_string(ticks);
+}
+
+// A cached render found in the directory.
+struct cache_file
+{
+    fs::path path;
+    uint64_t data_size;
+};
+
+/**
+ * Lists the cached renders of a hash in order of data size, parsed from names <hash>-<data size>.wav.
+ */
+std::vector<cache_file> list_cache_files(const fs::path& directory, const std::string& hash)
+{
+    std::vector<cache_file> files;
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(directory, error)) {
+        auto name = entry.path().filename().string();
+        if (entry.path().extension() != k_cache_extension || name.rfind(hash + "-", 0) != 0) {
+            continue;
+        }
+
+        try {
+            std::size_t end{};
+            auto size_text = entry.path().stem().string().substr(hash.size() + 1);
+            auto data_size = std::stoull(size_text, &end);
+            if (end == size_text.size()) {
+                files.push_back({entry.path(), data_size});
+            }
+        } catch (const std::exception& e) {
+            // not a cache entry
+        }
+    }
+
+    std::sort(files.begin(), files.end(), [](const cache_file& a, const cache_file& b) { return a.data_size < b.data_size; });
+    return files;
+}
+
+/**
+ * Reads the key file of a cached render, false if it is missing or belongs to another key with the same hash.
+ */
+bool read_key_file(const fs::path& path, const std::string& key, uint64_t& data_offset)
+{
+    std::ifstream file(path);
+    std::string stored_key;
+    return std::getline(file, stored_key) && stored_key == key && (file >> data_offset);
+}
+
+}// namespace
+
+uint64_t hash_render_key(const std::string& key)
+{
+    uint64_t hash {0xcbf29ce484222325};
+    for (unsigned char c : key) {
+        hash = (hash ^ c) * 0x100000001b3;
+    }
+    return hash;
+}
+
+render_cache::render_cache(const fs::path& directory, uint64_t size_limit, bool serve_prefixes)
+    : m_directory(directory)
+    , m_size_limit(size_limit)
+    , m_serve_prefixes(serve_prefixes)
+{
+    std::error_code error;
+    fs::create_directories(m_directory, error);
+    if (!fs::is_directory(m_directory)) {
+        throw std::ofstream::failure("File generation failed. Failed to create cache directory " + m_directory.string());
+    }
+}
+
+fs::path render_cache::entry_path(const std::string& key, uint64_t data_size, const char* extension) const
+{
+    return m_directory / (hash_key(key) + "-" + std::to_string(data_size) + extension);
+}
+
+bool render_cache::find(const std::string& key, uint64_t data_size, cached_render& render)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<cache_file> candidates;
+    if (m_serve_prefixes) {
+        for (auto& file : list_cache_files(m_directory, hash_key(key))) {
+            if (file.data_size >= data_size) {
+                candidates.push_back(file);
+            }
+        }
+    } else {
+        candidates.push_back({entry_path(key, data_size, k_cache_extension), data_size});
+    }
+
+    for (const auto& candidate : candidates) {
+        auto key_path = candidate.path;
+        key_path.replace_extension(k_key_extension);
+
+        uint64_t data_offset{};
+        std::error_code error;
+        if (!fs::is_regular_file(candidate.path, error) || !read_key_file(key_path, key, data_offset)) {
+            continue;
+        }
+
+        fs::last_write_time(key_path, fs::file_time_type::clock::now(), error);
+        render = {candidate.path, data_offset, candidate.data_size};
+        return true;
+    }
+
+    return false;
+}
+
+void render_cache::insert(const std::string& key, const fs::path& file_path, uint64_t data_offset, uint64_t data_size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (data_offset + data_size > m_size_limit) {
+        return;
+    }
+
+    auto shorter = list_cache_files(m_directory, hash_key(key));
+    if (m_serve_prefixes && !shorter.empty() && shorter.back().data_size >= data_size) {
+        return;
+    }
+
+    auto path = entry_path(key, data_size, k_cache_extension);
+    auto key_path = entry_path(key, data_size, k_key_extension);
+
+    // the audio data is renamed into place before its key file, so an entry is never found incomplete
+    auto temporary_path = get_temporary_path(path);
+    link_file(file_path, temporary_path);
+    fs::rename(temporary_path, path);
+
+    auto temporary_key_path = get_temporary_path(key_path);
+    {
+        std::ofstream key_file(temporary_key_path);
+        if ((key_file << key << '\n' << data_offset << '\n').flush().fail()) {
+            throw std::ofstream::failure("File generation failed. Failed to write cache entry " + key_path.string());
+        }
+    }
+    fs::rename(temporary_key_path, key_path);
+
+    // a longer render serves all prefixes, the shorter ones are not needed anymore
+    if (m_serve_prefixes) {
+        for (const auto& file : shorter) {
+            auto shorter_key_path = file.path;
+            std::error_code error;
+            fs::remove(shorter_key_path.replace_extension(k_key_extension), error);
+            fs::remove(file.path, error);
+        }
+    }
+
+    evict();
+}
+
+void render_cache::evict()
+{
+    struct entry
+    {
+        fs::path path;
+        uint64_t size;
+        fs::file_time_type last_use;
+    };
+
+    std::vector<entry> entries;
+    uint64_t total_size{};
+    std::error_code error;
+    for (const auto& file : fs::directory_iterator(m_directory, error)) {
+        if (file.path().extension() != k_cache_extension) {
+            continue;
+        }
+
+        auto key_path = file.path();
+        key_path.replace_extension(k_key_extension);
+        auto last_use = fs::last_write_time(key_path, error);
+        if (error) {
+            last_use = fs::last_write_time(file.path(), error);
+        }
+
+        auto size = fs::file_size(file.path(), error);
+        if (!error) {
+            entries.push_back({file.path(), size, last_use});
+            total_size += size;
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const entry& a, const entry& b) { return a.last_use < b.last_use; });
+    for (auto& entry : entries) {
+        if (total_size <= m_size_limit) {
+            break;
+        }
+
+        fs::remove(entry.path, error);
+        fs::remove(entry.path.replace_extension(k_key_extension), error);
+        total_size -= entry.size;
+    }
+}
+
+void link_file(const fs::path& source, const fs::path& target)
+{
+    std::error_code error;
+    fs::remove(target, error);
+
+#if defined(__linux__) && defined(FICLONE)
+    int source_fd = ::open(source.c_str(), O_RDONLY);
+    if (source_fd >= 0) {
+        int target_fd = ::open(target.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+        bool cloned = target_fd >= 0 && ::ioctl(target_fd, FICLONE, source_fd) == 0;
+        if (target_fd >= 0) {
+            ::close(target_fd);
+        }
+        ::close(source_fd);
+
+        if (cloned) {
+            return;
+        }
+        fs::remove(target, error);
+    }
+#endif
+
+    fs::create_hard_link(source, target, error);
+    if (!error) {
+        return;
+    }
+
+    if (!fs::copy_file(source, target, fs::copy_options::overwrite_existing, error)) {
+        throw std::ofstream::failure("File generation failed. Failed to copy " + source.string() + " to " + target.string());
+    }
+}
+
+void write_file_slice(const fs::path& target, std::span<const uint8_t> header, const fs::path& source, uint64_t offset, uint64_t size)
+{
+    file_slice slice {source, offset, size};
+    write_file_slices(target, header, {&slice, 1});
+}
+
+void write_file_slices(const fs::path& target, std::span<const uint8_t> header, std::span<const file_slice> slices)
+{
+    // a hard link to a cached render must not be written in place
+    std::error_code error;
+    fs::remove(target, error);
+
+#if defined(__linux__)
+    int target_fd = ::open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool copied = target_fd >= 0 && ::write(target_fd, header.data(), header.size()) == static_cast<ssize_t>(header.size());
+
+    for (const auto& slice : slices) {
+        int source_fd = copied ? ::open(slice.source.c_str(), O_RDONLY) : -1;
+        copied = source_fd >= 0;
+
+        auto source_offset = static_cast<off_t>(slice.offset);
+        for (auto remaining = slice.size; copied && remaining > 0; ) {
+            auto chunk = ::copy_file_range(source_fd, &source_offset, target_fd, nullptr,
+                                           static_cast<std::size_t>(std::min<uint64_t>(remaining, 1u << 30)), 0);
+            if (chunk < 0 && errno == EINTR) {
+                continue;
+            }
+            // not supported between these files, or failed: the copy below reports the error
+            copied = chunk > 0;
+            remaining -= copied ? static_cast<uint64_t>(chunk) : 0;
+        }
+
+        if (source_fd >= 0) {
+            ::close(source_fd);
+        }
+    }
+
+    if (target_fd >= 0 && ::close(target_fd) != 0) {
+        copied = false;
+    }
+    if (copied) {
+        return;
+    }
+#endif
+
+    std::ofstream output(target, std::ofstream::binary | std::ofstream::trunc);
+    if (!output.is_open()) {
+        throw std::ofstream::failure("File generation failed. Failed to open file " + target.string());
+    }
+
+    if (output.write(reinterpret_cast<const char*>(header.data()), header.size()).fail()) {
+        throw std::ofstream::failure("File generation failed. Failed to write header data to file.");
+    }
+
+    std::vector<char> buffer;
+    for (const auto& slice : slices) {
+        std::ifstream input(slice.source, std::ifstream::binary);
+        if (!input.is_open() || input.seekg(static_cast<std::streamoff>(slice.offset)).fail()) {
+            throw std::ofstream::failure("File generation failed. Failed to open file " + slice.source.string());
+        }
+
+        buffer.resize(static_cast<std::size_t>(std::min<uint64_t>(std::max<uint64_t>(slice.size, buffer.size()), 1u << 20)));
+        for (auto size = slice.size; size > 0; ) {
+            auto chunk = static_cast<std::size_t>(std::min<uint64_t>(size, buffer.size()));
+            if (input.read(buffer.data(), chunk).fail() || output.write(buffer.data(), chunk).fail()) {
+                throw std::ofstream::failure("File generation failed. Failed to write audio data to file.");
+            }
+            size -= chunk;
+        }
+    }
+
+    if (output.flush().fail()) {
+        throw std::ofstream::failure("File generation failed. Failed to write audio data to file.");
+    }
+}
+
+}// namespace wavegen
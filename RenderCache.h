@@ -0,0 +1,109 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   An on-disk cache of rendered files, addressed by their generation parameters.
+ */
+#ifndef RENDER_CACHE_H_
+#define RENDER_CACHE_H_
+
+#include <span>
+#include <mutex>
+#include <string>
+#include <cstdint>
+#include <filesystem>
+
+namespace wavegen
+{
+
+// A rendered file held by the cache.
+struct cached_render
+{
+    std::filesystem::path path;
+    uint64_t data_offset {};    // Bytes of header in front of the audio data
+    uint64_t data_size {};      // Bytes of audio data
+};
+
+/**
+ * Returns the 64 bit FNV-1a hash of a key, the same on every host.
+ */
+uint64_t hash_render_key(const std::string& key);
+
+/**
+ * Keeps rendered files in a directory, each under a hash of its key and its data size. The key
+ * describes every parameter the bytes of a render depend on, except for its length, so renders
+ * of the same key only differ in length, and the audio data of a shorter one is a prefix of the
+ * data of a longer one since samples only depend on their index.
+ *
+ * Every entry is a file <hash>-<data size>.wav next to a <hash>-<data size>.key file holding the
+ * key and the header size. The modification time of the key file marks the last use, the least
+ * recently used entries are removed once the files exceed the size limit. Entries are written
+ * under a temporary name and renamed, so processes sharing a directory never see a partial one.
+ * Thread safe.
+ */
+class render_cache
+{
+public:
+    /**
+     * Creates the directory if needed. With serve_prefixes set, renders are also served from
+     * longer cached renders of the same key.
+     */
+    render_cache(const std::filesystem::path& directory, uint64_t size_limit, bool serve_prefixes);
+
+    /**
+     * Looks up a render of the given key holding data_size bytes of audio data, or at least
+     * data_size bytes when serving prefixes, the shortest one if there are several.
+     * Returns false on a miss, otherwise marks the entry as used and fills in render.
+     */
+    bool find(const std::string& key, uint64_t data_size, cached_render& render);
+
+    /**
+     * Adds a rendered file, as a reflink or hard link where the file system allows, a copy
+     * otherwise. Nothing is added if the file exceeds the size limit, or when serving prefixes
+     * and a longer render is already cached.
+     */
+    void insert(const std::string& key, const std::filesystem::path& file_path, uint64_t data_offset, uint64_t data_size);
+
+    bool serves_prefixes() const { return m_serve_prefixes; }
+
+private:
+    std::filesystem::path entry_path(const std::string& key, uint64_t data_size, const char* extension) const;
+
+    // Removes the least recently used entries until the files fit into the size limit.
+    void evict();
+
+    std::filesystem::path m_directory;
+    uint64_t m_size_limit;
+    bool m_serve_prefixes;
+    std::mutex m_mutex;
+};
+
+/**
+ * Replaces target with the contents of source: a reflink (a copy on write clone) where the file
+ * system supports one, otherwise a hard link, otherwise a copy. A hard link shares the file, so
+ * it must not be written in place.
+ */
+void link_file(const std::filesystem::path& source, const std::filesystem::path& target);
+
+// size bytes of a file, starting at offset.
+struct file_slice
+{
+    std::filesystem::path source;
+    uint64_t offset {};
+    uint64_t size {};
+};
+
+/**
+ * Writes header, followed by size bytes of source from offset, to target. On Linux the kernel
+ * copies the bytes with copy_file_range, sharing extents where the file system allows.
+ */
+void write_file_slice(const std::filesystem::path& target, std::span<const uint8_t> header, const std::filesystem::path& source,
+                      uint64_t offset, uint64_t size);
+
+/**
+ * Writes header, followed by the slices in order, to target, copied like write_file_slice.
+ */
+void write_file_slices(const std::filesystem::path& target, std::span<const uint8_t> header, std::span<const file_slice> slices);
+
+}// namespace wavegen
+
+#endif // RENDER_CACHE_H_
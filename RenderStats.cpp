@@ -0,0 +1,94 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Lightweight scoped timers and counters of the render stages, for the --stats report.
+ */
+#include "RenderStats.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+namespace wavegen
+{
+
+namespace
+{
+
+constexpr auto k_stage_count = static_cast<std::size_t>(stats_stage::count);
+constexpr auto k_counter_count = static_cast<std::size_t>(stats_counter::count);
+
+// relaxed atomics: only totals are of interest, never the order of updates
+std::array<std::atomic<uint64_t>, k_stage_count> g_stage_ns {};
+std::array<std::atomic<uint64_t>, k_stage_count> g_stage_calls {};
+std::array<std::atomic<uint64_t>, k_counter_count> g_counters {};
+
+}// namespace
+
+void add_stats_time(stats_stage stage, std::chrono::steady_clock::duration elapsed)
+{
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    g_stage_ns[static_cast<std::size_t>(stage)].fetch_add(static_cast<uint64_t>(ns), std::memory_order_relaxed);
+    g_stage_calls[static_cast<std::size_t>(stage)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void add_stats_count(stats_counter counter, uint64_t value)
+{
+    g_counters[static_cast<std::size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+}
+
+stats_snapshot get_stats()
+{
+    stats_snapshot snapshot;
+    for (std::size_t stage{}; stage < k_stage_count; ++stage) {
+        snapshot.stage_sec[stage] = g_stage_ns[stage].load(std::memory_order_relaxed) * 1e-9;
+        snapshot.stage_calls[stage] = g_stage_calls[stage].load(std::memory_order_relaxed);
+    }
+    for (std::size_t counter{}; counter < k_counter_count; ++counter) {
+        snapshot.counters[counter] = g_counters[counter].load(std::memory_order_relaxed);
+    }
+
+    return snapshot;
+}
+
+const char* stats_stage_name(stats_stage stage)
+{
+    switch (stage) {
+        case stats_stage::header:       return "header";
+        case stats_stage::period_table: return "period_table";
+        case stats_stage::generate:     return "generate";
+        case stats_stage::resample:     return "resample";
+        case stats_stage::encode:       return "encode";
+        case stats_stage::write:        return "write";
+        default:                        return "unknown";
+    }
+}
+
+uint64_t get_peak_rss()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<uint64_t>(usage.ru_maxrss);          // bytes
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;   // kilobytes
+#endif
+#endif
+}
+
+}// namespace wavegen
@@ -0,0 +1,103 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Lightweight scoped timers and counters of the render stages, for the --stats report.
+ */
+#ifndef RENDER_STATS_H_
+#define RENDER_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Stats are compiled in unless WAVEGEN_STATS is defined to 0, in which case the
+// timer and counter macros expand to nothing.
+#if !defined(WAVEGEN_STATS)
+#define WAVEGEN_STATS 1
+#endif
+
+#define WAVEGEN_STATS_JOIN_(a, b) a##b
+#define WAVEGEN_STATS_JOIN(a, b) WAVEGEN_STATS_JOIN_(a, b)
+
+#if WAVEGEN_STATS
+#define WAVEGEN_STATS_SCOPE(stage) ::wavegen::scoped_stage_timer WAVEGEN_STATS_JOIN(wavegen_stage_timer_, __LINE__)(stage)
+#define WAVEGEN_STATS_COUNT(counter, value) ::wavegen::add_stats_count(counter, value)
+#else
+#define WAVEGEN_STATS_SCOPE(stage) static_cast<void>(0)
+#define WAVEGEN_STATS_COUNT(counter, value) static_cast<void>(0)
+#endif
+
+namespace wavegen
+{
+
+// Timed stages of a render. Stages of concurrent renders (batch workers) add up.
+enum class stats_stage
+{
+    header,         // create_wave_header
+    period_table,   // computing period tables
+    generate,       // create_wave_data, generating and packing samples
+    resample,       // filtering samples to further sample rates, and packing them
+    encode,         // compressing audio data, e.g. into FLAC frames
+    write,          // handing data to the file or waiting for its writes
+    count
+};
+
+enum class stats_counter
+{
+    files,          // Files completed
+    samples,        // Samples generated, over all channels
+    bytes_written,  // Bytes of header and audio data written
+    count
+};
+
+struct stats_snapshot
+{
+    std::array<double, static_cast<std::size_t>(stats_stage::count)> stage_sec {};
+    std::array<uint64_t, static_cast<std::size_t>(stats_stage::count)> stage_calls {};
+    std::array<uint64_t, static_cast<std::size_t>(stats_counter::count)> counters {};
+};
+
+void add_stats_time(stats_stage stage, std::chrono::steady_clock::duration elapsed);
+void add_stats_count(stats_counter counter, uint64_t value);
+
+/**
+ * Returns the times and counters collected since the start of the process.
+ */
+stats_snapshot get_stats();
+
+const char* stats_stage_name(stats_stage stage);
+
+/**
+ * Returns the peak resident set size of the process in bytes, 0 if unknown.
+ */
+uint64_t get_peak_rss();
+
+/**
+ * Adds the time from its construction to its destruction to a stage.
+ */
+class scoped_stage_timer
+{
+public:
+    explicit scoped_stage_timer(stats_stage stage)
+        : m_stage(stage)
+        , m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~scoped_stage_timer() {
+        add_stats_time(m_stage, std::chrono::steady_clock::now() - m_start);
+    }
+
+    scoped_stage_timer(const scoped_stage_timer&) = delete;
+    scoped_stage_timer& operator=(const scoped_stage_timer&) = delete;
+
+private:
+    stats_stage m_stage;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+}// namespace wavegen
+
+#endif // RENDER_STATS_H_
@@ -0,0 +1,331 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Polyphase windowed-sinc resampling of generated samples from one sample rate to another.
+ */
+#include "Resampler.h"
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include <initializer_list>
+
+#if defined(WAVEGEN_X86)
+#include <immintrin.h>
+#elif defined(WAVEGEN_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace wavegen
+{
+
+namespace
+{
+
+constexpr double k_PI {3.141592653589793};
+
+/**
+ * Returns the zeroth order modified Bessel function of the first kind, summed as its power series.
+ */
+double bessel_i0(double x)
+{
+    double sum {1.0};
+    double term {1.0};
+    for (int k{1}; term > sum * 1e-17; ++k) {
+        double factor = x / (2.0 * k);
+        term *= factor * factor;
+        sum += term;
+    }
+
+    return sum;
+}
+
+// Truncates a filtered value to a sample, saturating at the range of int32_t.
+inline int32_t to_sample(double value)
+{
+    constexpr double k_min = std::numeric_limits<int32_t>::min();
+    constexpr double k_max = std::numeric_limits<int32_t>::max();
+
+    return static_cast<int32_t>(std::clamp(value, k_min, k_max));
+}
+
+// Moves phase and input on to the next output sample.
+inline void advance(const resample_args& args, uint32_t& phase, const int32_t*& input)
+{
+    phase += args.down;
+    input += phase / args.up;
+    phase %= args.up;
+}
+
+void resample_scalar(const resample_args& args, const int32_t* input, int32_t* out, std::size_t count)
+{
+    auto phase = args.phase;
+
+    for (std::size_t i{}; i < count; ++i) {
+        const double* taps = args.taps + static_cast<std::size_t>(phase) * args.tap_count;
+        double sums[8] {};
+        for (uint32_t k{}; k < args.tap_count; k += 8) {
+            for (uint32_t lane{}; lane < 8; ++lane) {
+                sums[lane] += input[k + lane] * taps[k + lane];
+            }
+        }
+
+        // the order of the horizontal sums of the vector kernels
+        out[i] = to_sample(((sums[0] + sums[4]) + (sums[2] + sums[6])) + ((sums[1] + sums[5]) + (sums[3] + sums[7])));
+        advance(args, phase, input);
+    }
+}
+
+#if defined(WAVEGEN_X86)
+
+/**
+ * 8 taps per iteration, as two vectors of 4 partial sums. Two samples are summed at once, which
+ * hides the latency of the additions.
+ */
+WAVEGEN_TARGET("avx2")
+inline double reduce_avx2(__m256d low, __m256d high)
+{
+    __m256d sums = _mm256_add_pd(low, high);
+    __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(sums), _mm256_extractf128_pd(sums, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+WAVEGEN_TARGET("avx2")
+inline void accumulate_avx2(const int32_t* input, const double* taps, __m256d& low, __m256d& high)
+{
+    __m256i samples = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+    low = _mm256_add_pd(low, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(samples)), _mm256_loadu_pd(taps)));
+    high = _mm256_add_pd(high, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(samples, 1)), _mm256_loadu_pd(taps + 4)));
+}
+
+WAVEGEN_TARGET("avx2")
+void resample_avx2(const resample_args& args, const int32_t* input, int32_t* out, std::size_t count)
+{
+    auto phase = args.phase;
+
+    std::size_t i{};
+    for (; i + 2 <= count; i += 2) {
+        const double* taps = args.taps + static_cast<std::size_t>(phase) * args.tap_count;
+        const int32_t* first_input = input;
+        advance(args, phase, input);
+        const double* next_taps = args.taps + static_cast<std::size_t>(phase) * args.tap_count;
+
+        __m256d low = _mm256_setzero_pd(), high = _mm256_setzero_pd();
+        __m256d next_low = _mm256_setzero_pd(), next_high = _mm256_setzero_pd();
+        for (uint32_t k{}; k < args.tap_count; k += 8) {
+            accumulate_avx2(first_input + k, taps + k, low, high);
+            accumulate_avx2(input + k, next_taps + k, next_low, next_high);
+        }
+
+        out[i] = to_sample(reduce_avx2(low, high));
+        out[i + 1] = to_sample(reduce_avx2(next_low, next_high));
+        advance(args, phase, input);
+    }
+
+    if (i < count) {
+        const double* taps = args.taps + static_cast<std::size_t>(phase) * args.tap_count;
+        __m256d low = _mm256_setzero_pd(), high = _mm256_setzero_pd();
+        for (uint32_t k{}; k < args.tap_count; k += 8) {
+            accumulate_avx2(input + k, taps + k, low, high);
+        }
+        out[i] = to_sample(reduce_avx2(low, high));
+    }
+}
+
+/**
+ * 8 taps per iteration, as one vector of 8 partial sums, two samples at once like the AVX2 kernel.
+ */
+WAVEGEN_TARGET("avx512f")
+inline double reduce_avx512(__m512d partials)
+{
+    __m256d sums = _mm256_add_pd(_mm512_castpd512_pd256(partials), _mm512_extractf64x4_pd(partials, 1));
+    __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(sums), _mm256_extractf128_pd(sums, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+WAVEGEN_TARGET("avx512f")
+inline __m512d accumulate_avx512(const int32_t* input, const double* taps, __m512d partials)
+{
+    __m256i samples = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+    return _mm512_add_pd(partials, _mm512_mul_pd(_mm512_cvtepi32_pd(samples), _mm512_loadu_pd(taps)));
+}
+
+WAVEGEN_TARGET("avx512f")
+void resample_avx512(const resample_args& args, const int32_t* input, int32_t* out, std::size_t count)
+{
+    auto phase = args.phase;
+
+    std::size_t i{};
+    for (; i + 2 <= count; i += 2) {
+        const double* taps = args.taps + static_cast<std::size_t>(phase) * args.tap_count;
+        const int32_t* first_input = input;
+        advance(args, phase, input);
+        const double* next_taps = args.taps + static_cast<std::size_t>(phase) * args.tap_count;
+
+        __m512d partials = _mm512_setzero_pd(), next_partials = _mm512_setzero_pd();
+        for (uint32_t k{}; k < args.tap_count; k += 8) {
+            partials = accumulate_avx512(first_input + k, taps + k, partials);
+            next_partials = accumulate_avx512(input + k, next_taps + k, next_partials);
+        }
+
+        out[i] = to_sample(reduce_avx512(partials));
+        out[i + 1] = to_sample(reduce_avx512(next_partials));
+        advance(args, phase, input);
+    }
+
+    if (i < count) {
+        const double* taps = args.taps + static_cast<std::size_t>(phase) * args.tap_count;
+        __m512d partials = _mm512_setzero_pd();
+        for (uint32_t k{}; k < args.tap_count; k += 8) {
+            partials = accumulate_avx512(input + k, taps + k, partials);
+        }
+        out[i] = to_sample(reduce_avx512(partials));
+    }
+}
+
+#elif defined(WAVEGEN_NEON)
+
+/**
+ * 8 taps per iteration, as four vectors of 2 partial sums.
+ */
+void resample_neon(const resample_args& args, const int32_t* input, int32_t* out, std::size_t count)
+{
+    auto phase = args.phase;
+
+    for (std::size_t i{}; i < count; ++i) {
+        const double* taps = args.taps + static_cast<std::size_t>(phase) * args.tap_count;
+        float64x2_t partials[4] {vdupq_n_f64(0.0), vdupq_n_f64(0.0), vdupq_n_f64(0.0), vdupq_n_f64(0.0)};
+        for (uint32_t k{}; k < args.tap_count; k += 8) {
+            int32x4_t low = vld1q_s32(input + k);
+            int32x4_t high = vld1q_s32(input + k + 4);
+            partials[0] = vaddq_f64(partials[0], vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(low))), vld1q_f64(taps + k)));
+            partials[1] = vaddq_f64(partials[1], vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_high_s32(low))), vld1q_f64(taps + k + 2)));
+            partials[2] = vaddq_f64(partials[2], vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(high))), vld1q_f64(taps + k + 4)));
+            partials[3] = vaddq_f64(partials[3], vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_high_s32(high))), vld1q_f64(taps + k + 6)));
+        }
+
+        float64x2_t pair = vaddq_f64(vaddq_f64(partials[0], partials[2]), vaddq_f64(partials[1], partials[3]));
+        out[i] = to_sample(vgetq_lane_f64(pair, 0) + vgetq_lane_f64(pair, 1));
+        advance(args, phase, input);
+    }
+}
+
+#endif
+
+}// namespace
+
+resample_kernel get_resample_kernel(simd_isa isa)
+{
+    if (!cpu_supports(isa)) {
+        return nullptr;
+    }
+
+    switch (isa) {
+        case simd_isa::scalar: return resample_scalar;
+#if defined(WAVEGEN_X86)
+        case simd_isa::avx2:   return resample_avx2;
+        case simd_isa::avx512: return resample_avx512;
+#elif defined(WAVEGEN_NEON)
+        case simd_isa::neon:   return resample_neon;
+#endif
+        default:               return nullptr;
+    }
+}
+
+resample_kernel best_resample_kernel()
+{
+    for (auto isa : {simd_isa::avx512, simd_isa::avx2, simd_isa::neon}) {
+        if (auto kernel = get_resample_kernel(isa)) {
+            return kernel;
+        }
+    }
+
+    return resample_scalar;
+}
+
+polyphase_resampler::polyphase_resampler(uint32_t input_rate, uint32_t output_rate)
+    : m_input_rate(input_rate)
+    , m_output_rate(output_rate)
+    , m_kernel(best_resample_kernel())
+{
+    if (input_rate == 0 || output_rate == 0) {
+        throw std::invalid_argument("Invalid argument. Sample rates should be greater than 0.");
+    }
+
+    auto divisor = std::gcd(input_rate, output_rate);
+    m_up = output_rate / divisor;
+    m_down = input_rate / divisor;
+
+    // a lowpass of the lower rate spans more samples of a higher input rate
+    double span = k_base_tap_count * std::max(1.0, static_cast<double>(m_down) / m_up);
+    m_tap_count = (static_cast<uint32_t>(std::ceil(span)) + 7) / 8 * 8;
+    if (static_cast<uint64_t>(m_up) * m_tap_count > k_max_taps) {
+        throw std::invalid_argument("Invalid argument. The ratio of the sample rates " + std::to_string(input_rate) + " and "
+                                    + std::to_string(output_rate) + " is too fine for a polyphase filter.");
+    }
+
+    // Kaiser's design formulas, in cycles per input sample: the transition band ends at half of the lower rate
+    double transition = (k_stopband_db - 7.95) / (14.36 * m_tap_count);
+    double cutoff = 0.5 * std::min(1.0, static_cast<double>(m_up) / m_down) - transition / 2.0;
+    double beta = 0.1102 * (k_stopband_db - 8.7);
+    double half_span = m_tap_count / 2.0;
+
+    m_taps.resize(static_cast<std::size_t>(m_up) * m_tap_count);
+    for (uint32_t phase{}; phase < m_up; ++phase) {
+        double* taps = m_taps.data() + static_cast<std::size_t>(phase) * m_tap_count;
+        double sum {};
+        for (uint32_t k{}; k < m_tap_count; ++k) {
+            // the distance of input k of the phase from the output position, in input samples
+            double distance = static_cast<double>(phase) / m_up + half_span - 1.0 - k;
+            double x = 2.0 * cutoff * distance;
+            double sinc = x == 0.0 ? 1.0 : std::sin(k_PI * x) / (k_PI * x);
+            double u = distance / half_span;
+            double window = bessel_i0(beta * std::sqrt(std::max(0.0, 1.0 - u * u))) / bessel_i0(beta);
+
+            taps[k] = 2.0 * cutoff * sinc * window;
+            sum += taps[k];
+        }
+
+        // unity gain at 0 Hz for every phase
+        for (uint32_t k{}; k < m_tap_count; ++k) {
+            taps[k] /= sum;
+        }
+    }
+}
+
+uint64_t polyphase_resampler::get_position(uint64_t output_index, uint32_t& phase) const
+{
+    uint64_t remainder = output_index % m_up * m_down;
+    phase = static_cast<uint32_t>(remainder % m_up);
+    return output_index / m_up * m_down + remainder / m_up;
+}
+
+int64_t polyphase_resampler::get_first_input(uint64_t output_index) const
+{
+    uint32_t phase{};
+    return static_cast<int64_t>(get_position(output_index, phase)) - m_tap_count / 2 + 1;
+}
+
+uint64_t polyphase_resampler::get_output_end(int64_t input_end) const
+{
+    // the last input of output j is its position + tap_count / 2, the positions below position_end are
+    // those of the outputs j * down < position_end * up
+    int64_t position_end = input_end - m_tap_count / 2;
+    if (position_end <= 0) {
+        return 0;
+    }
+
+    auto end = static_cast<uint64_t>(position_end);
+    return end / m_down * m_up + (end % m_down * m_up + m_down - 1) / m_down;
+}
+
+void polyphase_resampler::resample(const int32_t* input, std::span<int32_t> out, uint64_t first_index) const
+{
+    uint32_t phase{};
+    get_position(first_index, phase);
+    m_kernel({m_taps.data(), m_tap_count, m_up, m_down, phase}, input, out.data(), out.size());
+}
+
+}// namespace wavegen
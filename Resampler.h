@@ -0,0 +1,109 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Polyphase windowed-sinc resampling of generated samples from one sample rate to another.
+ */
+#ifndef RESAMPLER_H_
+#define RESAMPLER_H_
+
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "CpuFeatures.h"
+
+namespace wavegen
+{
+
+/**
+ * Describes a run of output samples of a polyphase filter. Output sample i is the dot product of
+ * tap_count input samples with the taps of its phase, truncated to an integer. Sample 0 has the
+ * given phase and its inputs start at the input of the kernel. Every further sample adds down to
+ * the phase, and moves the inputs on by one sample per up it wraps the phase by.
+ */
+struct resample_args
+{
+    const double* taps;     // up phases of tap_count taps, phase after phase
+    uint32_t tap_count;     // A multiple of 8
+    uint32_t up;
+    uint32_t down;
+    uint32_t phase;         // In [0, up)
+};
+
+/**
+ * A resample kernel computes count output samples described by args from input.
+ * All kernels sum the products of a sample in eight interleaved partial sums, which are
+ * added up in the same order, so they produce the same samples.
+ */
+using resample_kernel = void (*)(const resample_args& args, const int32_t* input, int32_t* out, std::size_t count);
+
+/**
+ * Returns the kernel for the given instruction set, or nullptr if the kernel
+ * is not available on this platform or CPU.
+ */
+resample_kernel get_resample_kernel(simd_isa isa);
+
+/**
+ * Returns the fastest kernel supported by the running CPU.
+ */
+resample_kernel best_resample_kernel();
+
+/**
+ * Converts samples from input_rate to output_rate, the ratio reduced to up / down. Output sample j
+ * lies at input position j * down / up, and is the input filtered by a Kaiser windowed sinc
+ * lowpass below half of the lower of the two rates, evaluated at that position. The lowpass spans
+ * k_base_tap_count samples of the lower rate, its stopband is attenuated by k_stopband_db.
+ * The taps of the up phases are computed once, an output sample only depends on its index and
+ * on the inputs around its position, so outputs can be computed in any blocks (or threads).
+ */
+class polyphase_resampler
+{
+public:
+    static constexpr uint32_t k_base_tap_count {128};       // Taps of a phase, in samples of the lower rate
+    static constexpr double k_stopband_db {110.0};          // Attenuation of the Kaiser window
+    static constexpr std::size_t k_max_taps {1u << 22};     // Taps of all phases, 32 MiB
+
+    /**
+     * Throws std::invalid_argument for a rate of 0, or rates whose reduced ratio would need
+     * more than k_max_taps taps.
+     */
+    polyphase_resampler(uint32_t input_rate, uint32_t output_rate);
+
+    /**
+     * Returns the first input sample output sample output_index depends on, negative before the start of the input.
+     * The sample depends on the tap_count() input samples from there.
+     */
+    int64_t get_first_input(uint64_t output_index) const;
+
+    /**
+     * Returns the end of the output samples which only depend on input samples before input_end.
+     */
+    uint64_t get_output_end(int64_t input_end) const;
+
+    /**
+     * Computes the output samples from first_index on into out. input holds the input samples from
+     * get_first_input(first_index) on, up to the last one the last output sample depends on.
+     */
+    void resample(const int32_t* input, std::span<int32_t> out, uint64_t first_index) const;
+
+    uint32_t input_rate() const { return m_input_rate; }
+    uint32_t output_rate() const { return m_output_rate; }
+    uint32_t tap_count() const { return m_tap_count; }
+
+private:
+    // Returns floor(index * down / up) and the phase (index * down) % up, without overflow.
+    uint64_t get_position(uint64_t output_index, uint32_t& phase) const;
+
+    uint32_t m_input_rate;
+    uint32_t m_output_rate;
+    uint32_t m_up;
+    uint32_t m_down;
+    uint32_t m_tap_count;
+    std::vector<double> m_taps;
+    resample_kernel m_kernel;
+};
+
+}// namespace wavegen
+
+#endif // RESAMPLER_H_
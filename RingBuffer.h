@@ -0,0 +1,115 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   A lock-free ring buffer for one producer and one consumer thread.
+ */
+#ifndef RING_BUFFER_H_
+#define RING_BUFFER_H_
+
+#include <bit>
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+namespace wavegen
+{
+
+/**
+ * Fixed-capacity ring of elements, written by exactly one producer thread and read by exactly
+ * one consumer thread. Neither side ever locks, allocates or waits: writes and reads are two
+ * memcpy at most and one release store, so the consumer can be a real-time audio callback.
+ *
+ * Read and write positions count elements since construction and only ever grow, so a full
+ * and an empty ring are told apart without a spare element. Each side caches the position of
+ * the other one and only reloads it when the cached value says the ring is full (or empty),
+ * which keeps the two cache lines from bouncing between cores on every call.
+ */
+template <typename T>
+class spsc_ring_buffer
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Elements are copied with memcpy.");
+    static_assert(std::atomic<std::size_t>::is_always_lock_free, "The positions have to be lock-free.");
+
+public:
+    // The capacity is rounded up to a power of two.
+    explicit spsc_ring_buffer(std::size_t capacity)
+        : m_data(std::bit_ceil(std::max<std::size_t>(capacity, 1)))
+        , m_mask(m_data.size() - 1)
+    {
+    }
+
+    spsc_ring_buffer(const spsc_ring_buffer&) = delete;
+    spsc_ring_buffer& operator=(const spsc_ring_buffer&) = delete;
+
+    std::size_t capacity() const { return m_data.size(); }
+
+    /**
+     * Producer only. Writes all count elements, or none of them if they do not fit.
+     */
+    bool try_write(const T* data, std::size_t count) {
+        auto write_pos = m_write_pos.load(std::memory_order_relaxed);
+        if (write_pos + count - m_cached_read_pos > capacity()) {
+            m_cached_read_pos = m_read_pos.load(std::memory_order_acquire);
+            if (write_pos + count - m_cached_read_pos > capacity()) {
+                return false;
+            }
+        }
+
+        copy_in(write_pos & m_mask, data, count);
+        m_write_pos.store(write_pos + count, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer only. Reads up to count elements and returns how many were read.
+     */
+    std::size_t read(T* data, std::size_t count) {
+        auto read_pos = m_read_pos.load(std::memory_order_relaxed);
+        if (m_cached_write_pos - read_pos < count) {
+            m_cached_write_pos = m_write_pos.load(std::memory_order_acquire);
+            count = std::min(count, m_cached_write_pos - read_pos);
+        }
+
+        copy_out(read_pos & m_mask, data, count);
+        m_read_pos.store(read_pos + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Elements ready to be read. Exact on the consumer side, a lower bound anywhere else.
+     */
+    std::size_t read_available() const {
+        return m_write_pos.load(std::memory_order_acquire) - m_read_pos.load(std::memory_order_acquire);
+    }
+
+private:
+    void copy_in(std::size_t index, const T* data, std::size_t count) {
+        auto first = std::min(count, capacity() - index);
+        std::memcpy(m_data.data() + index, data, first * sizeof(T));
+        std::memcpy(m_data.data(), data + first, (count - first) * sizeof(T));
+    }
+
+    void copy_out(std::size_t index, T* data, std::size_t count) const {
+        auto first = std::min(count, capacity() - index);
+        std::memcpy(data, m_data.data() + index, first * sizeof(T));
+        std::memcpy(data + first, m_data.data(), (count - first) * sizeof(T));
+    }
+
+    std::vector<T> m_data;
+    std::size_t m_mask;
+
+    // written by the producer
+    alignas(64) std::atomic<std::size_t> m_write_pos {};
+    std::size_t m_cached_read_pos {};
+
+    // written by the consumer
+    alignas(64) std::atomic<std::size_t> m_read_pos {};
+    std::size_t m_cached_write_pos {};
+};
+
+}// namespace wavegen
+
+#endif // RING_BUFFER_H_
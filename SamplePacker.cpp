@@ -0,0 +1,272 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Converts generated samples into packed little-endian PCM or IEEE float data.
+ */
+#include "SamplePacker.h"
+
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <initializer_list>
+
+#if defined(WAVEGEN_X86)
+#include <immintrin.h>
+#elif defined(WAVEGEN_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace wavegen
+{
+
+namespace
+{
+
+void pack_8_scalar(const int32_t* samples, std::size_t count, uint8_t* out)
+{
+    for (std::size_t i{}; i < count; ++i) {
+        out[i] = static_cast<uint8_t>(samples[i] + 0x80);
+    }
+}
+
+void pack_16_scalar(const int32_t* samples, std::size_t count, uint8_t* out)
+{
+    for (std::size_t i{}; i < count; ++i, out += 2) {
+        out[0] = samples[i] & 0xFF;
+        out[1] = (samples[i] >> 8) & 0xFF;
+    }
+}
+
+void pack_24_scalar(const int32_t* samples, std::size_t count, uint8_t* out)
+{
+    for (std::size_t i{}; i < count; ++i, out += 3) {
+        out[0] = samples[i] & 0xFF;
+        out[1] = (samples[i] >> 8) & 0xFF;
+        out[2] = (samples[i] >> 16) & 0xFF;
+    }
+}
+
+void pack_32_scalar(const int32_t* samples, std::size_t count, uint8_t* out)
+{
+    for (std::size_t i{}; i < count; ++i, out += 4) {
+        out[0] = samples[i] & 0xFF;
+        out[1] = (samples[i] >> 8) & 0xFF;
+        out[2] = (samples[i] >> 16) & 0xFF;
+        out[3] = (samples[i] >> 24) & 0xFF;
+    }
+}
+
+void pack_float_scalar(const int32_t* samples, std::size_t count, uint8_t* out)
+{
+    for (std::size_t i{}; i < count; ++i, out += 4) {
+        uint32_t bits{};
+        float sample = std::clamp(static_cast<float>(samples[i]) * (1.0f / k_float_full_scale), -1.0f, 1.0f);
+        std::memcpy(&bits, &sample, 4);
+
+        out[0] = bits & 0xFF;
+        out[1] = (bits >> 8) & 0xFF;
+        out[2] = (bits >> 16) & 0xFF;
+        out[3] = (bits >> 24) & 0xFF;
+    }
+}
+
+#if defined(WAVEGEN_X86)
+
+/**
+ * 16 samples per iteration: pshufb drops the top byte of each of four samples,
+ * the four 12 byte results are then merged into three full 16 byte stores.
+ */
+WAVEGEN_TARGET("ssse3")
+void pack_24_ssse3(const int32_t* samples, std::size_t count, uint8_t* out)
+{
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+    std::size_t i{};
+    for (; i + 16 <= count; i += 16, out += 48) {
+        __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i)), shuffle);
+        __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i + 4)), shuffle);
+        __m128i c = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i + 8)), shuffle);
+        __m128i d = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i + 12)), shuffle);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),      _mm_or_si128(a, _mm_slli_si128(b, 12)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_or_si128(_mm_srli_si128(b, 4), _mm_slli_si128(c, 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 32), _mm_or_si128(_mm_srli_si128(c, 8), _mm_slli_si128(d, 4)));
+    }
+
+    pack_24_scalar(samples + i, count - i, out);
+}
+
+/**
+ * 8 samples per shuffle: vpshufb packs 12 bytes in each 128 bit lane,
+ * vpermd moves both halves next to each other.
+ */
+WAVEGEN_TARGET("avx2")
+void pack_24_avx2(const int32_t* samples, std::size_t count, uint8_t* out)
+{
+    const __m256i shuffle = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                             0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const __m256i compact = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+    std::size_t i{};
+    for (; i + 8 <= count; i += 8, out += 24) {
+        __m256i packed = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + i)), shuffle);
+        packed = _mm256_permutevar8x32_epi32(packed, compact);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16), _mm256_extracti128_si256(packed, 1));
+    }
+
+    pack_24_scalar(samples + i, count - i, out);
+}
+
+/**
+ * 16 samples per shuffle: vpshufb packs 12 bytes in each 128 bit lane,
+ * vpermd compacts the lanes and a masked store writes the 48 packed bytes.
+ */
+WAVEGEN_TARGET("avx512f,avx512bw")
+void pack_24_avx512(const int32_t* samples, std::size_t count, uint8_t* out)
+{
+    const __m512i shuffle = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+    const __m512i compact = _mm512_setr_epi32(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15);
+    const __mmask64 store_mask {0x0000'FFFF'FFFF'FFFFULL};
+
+    std::size_t i{};
+    for (; i + 16 <= count; i += 16, out += 48) {
+        __m512i packed = _mm512_shuffle_epi8(_mm512_loadu_si512(samples + i), shuffle);
+        _mm512_mask_storeu_epi8(out, store_mask, _mm512_permutexvar_epi32(compact, packed));
+    }
+
+    pack_24_scalar(samples + i, count - i, out);
+}
+
+WAVEGEN_TARGET("avx2")
+void pack_float_avx2(const int32_t* samples, std::size_t count, uint8_t* out)
+{
+    const __m256 scale = _mm256_set1_ps(1.0f / k_float_full_scale);
+    const __m256 high = _mm256_set1_ps(1.0f);
+    const __m256 low = _mm256_set1_ps(-1.0f);
+
+    std::size_t i{};
+    for (; i + 8 <= count; i += 8, out += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + i));
+        __m256 value = _mm256_mul_ps(_mm256_cvtepi32_ps(block), scale);
+        _mm256_storeu_ps(reinterpret_cast<float*>(out), _mm256_max_ps(_mm256_min_ps(value, high), low));
+    }
+
+    pack_float_scalar(samples + i, count - i, out);
+}
+
+WAVEGEN_TARGET("avx512f")
+void pack_float_avx512(const int32_t* samples, std::size_t count, uint8_t* out)
+{
+    const __m512 scale = _mm512_set1_ps(1.0f / k_float_full_scale);
+    const __m512 high = _mm512_set1_ps(1.0f);
+    const __m512 low = _mm512_set1_ps(-1.0f);
+
+    std::size_t i{};
+    for (; i + 16 <= count; i += 16, out += 64) {
+        __m512i block = _mm512_loadu_si512(samples + i);
+        __m512 value = _mm512_mul_ps(_mm512_cvtepi32_ps(block), scale);
+        _mm512_storeu_ps(out, _mm512_max_ps(_mm512_min_ps(value, high), low));
+    }
+
+    pack_float_scalar(samples + i, count - i, out);
+}
+
+#elif defined(WAVEGEN_NEON)
+
+/**
+ * 16 samples per iteration: vld4 splits the samples into byte planes,
+ * vst3 interleaves the low three planes back into packed 24 bit samples.
+ */
+void pack_24_neon(const int32_t* samples, std::size_t count, uint8_t* out)
+{
+    std::size_t i{};
+    for (; i + 16 <= count; i += 16, out += 48) {
+        uint8x16x4_t planes = vld4q_u8(reinterpret_cast<const uint8_t*>(samples + i));
+        vst3q_u8(out, uint8x16x3_t{{planes.val[0], planes.val[1], planes.val[2]}});
+    }
+
+    pack_24_scalar(samples + i, count - i, out);
+}
+
+void pack_float_neon(const int32_t* samples, std::size_t count, uint8_t* out)
+{
+    const float32x4_t high = vdupq_n_f32(1.0f);
+    const float32x4_t low = vdupq_n_f32(-1.0f);
+
+    std::size_t i{};
+    for (; i + 4 <= count; i += 4, out += 16) {
+        float32x4_t block = vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(samples + i)), 1.0f / k_float_full_scale);
+        vst1q_f32(reinterpret_cast<float*>(out), vmaxq_f32(vminq_f32(block, high), low));
+    }
+
+    pack_float_scalar(samples + i, count - i, out);
+}
+
+#endif
+
+}// namespace
+
+pack_kernel get_pack_kernel(uint16_t bits_per_sample, simd_isa isa, sample_format format)
+{
+    if (!cpu_supports(isa)) {
+        return nullptr;
+    }
+
+    if (format == sample_format::ieee_float) {
+        if (bits_per_sample != 32) {
+            return nullptr;
+        }
+
+        switch (isa) {
+            case simd_isa::scalar: return pack_float_scalar;
+#if defined(WAVEGEN_X86)
+            case simd_isa::avx2:   return pack_float_avx2;
+            case simd_isa::avx512: return pack_float_avx512;
+#elif defined(WAVEGEN_NEON)
+            case simd_isa::neon:   return pack_float_neon;
+#endif
+            default:               return nullptr;
+        }
+    }
+
+    if (isa == simd_isa::scalar) {
+        switch (bits_per_sample) {
+            case 8:  return pack_8_scalar;
+            case 16: return pack_16_scalar;
+            case 24: return pack_24_scalar;
+            case 32: return pack_32_scalar;
+            default: return nullptr;
+        }
+    }
+
+    if (bits_per_sample == 24) {
+        switch (isa) {
+#if defined(WAVEGEN_X86)
+            case simd_isa::ssse3:  return pack_24_ssse3;
+            case simd_isa::avx2:   return pack_24_avx2;
+            case simd_isa::avx512: return pack_24_avx512;
+#elif defined(WAVEGEN_NEON)
+            case simd_isa::neon:   return pack_24_neon;
+#endif
+            default:               return nullptr;
+        }
+    }
+
+    return nullptr;
+}
+
+pack_kernel best_pack_kernel(uint16_t bits_per_sample, sample_format format)
+{
+    for (auto isa : {simd_isa::avx512, simd_isa::avx2, simd_isa::ssse3, simd_isa::neon, simd_isa::scalar}) {
+        if (auto kernel = get_pack_kernel(bits_per_sample, isa, format)) {
+            return kernel;
+        }
+    }
+
+    throw std::invalid_argument("Invalid argument. Unsupported bits per sample " + std::to_string(bits_per_sample) + ".");
+}
+
+}// namespace wavegen
@@ -0,0 +1,60 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Converts generated samples into packed little-endian PCM or IEEE float data.
+ */
+#ifndef SAMPLE_PACKER_H_
+#define SAMPLE_PACKER_H_
+
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+#include "CpuFeatures.h"
+
+namespace wavegen
+{
+
+// The encoding of packed samples.
+enum class sample_format
+{
+    pcm,            // signed integer (unsigned for 8 bits)
+    ieee_float      // 32 bit IEEE 754 floating point
+};
+
+// Float samples are scaled so that the amplitude of the generators (k_amplitude) maps to 1.0.
+constexpr float k_float_full_scale {30'000'000.0f};
+
+/**
+ * A pack kernel converts count samples into packed little-endian PCM and writes
+ * count * bits_per_sample / 8 bytes to out. Samples are expected in the signed range
+ * of the bit depth, only their low bits are stored. 8 bit PCM is unsigned (WAVE format),
+ * so its samples are offset by 128. Float kernels write samples / k_float_full_scale, clamped to [-1, 1].
+ */
+using pack_kernel = void (*)(const int32_t* samples, std::size_t count, uint8_t* out);
+
+/**
+ * Returns the kernel packing the given bit depth (8, 16, 24 or 32 for PCM, 32 for float) with
+ * the given instruction set, or nullptr if there is no such kernel on this platform or CPU.
+ */
+pack_kernel get_pack_kernel(uint16_t bits_per_sample, simd_isa isa, sample_format format = sample_format::pcm);
+
+/**
+ * Returns the fastest kernel packing the given bit depth on the running CPU.
+ * Throws std::invalid_argument for an unsupported bit depth.
+ */
+pack_kernel best_pack_kernel(uint16_t bits_per_sample, sample_format format = sample_format::pcm);
+
+/**
+ * Packs samples to the given bit depth into out, which has to hold
+ * samples.size() * bits_per_sample / 8 bytes.
+ */
+inline void pack_samples(std::span<const int32_t> samples, uint16_t bits_per_sample, uint8_t* out, 
+                         sample_format format = sample_format::pcm)
+{
+    best_pack_kernel(bits_per_sample, format)(samples.data(), samples.size(), out);
+}
+
+}// namespace wavegen
+
+#endif // SAMPLE_PACKER_H_
@@ -0,0 +1,366 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Vectorised polynomial sine kernels which fill a block of samples at once.
+ */
+#include "SineKernels.h"
+
+#include <cmath>
+#include <algorithm>
+#include <initializer_list>
+
+#if defined(WAVEGEN_X86)
+#include <immintrin.h>
+#elif defined(WAVEGEN_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace wavegen
+{
+
+namespace
+{
+
+constexpr double k_two_pi {6.283185307179586};
+
+// Taylor coefficients of sin(x) = x * (c1 + c3*x^2 + ... + c17*x^16). The argument is
+// reduced to [0, pi/2], where the first omitted term (x^19/19!) stays below 5e-14.
+constexpr double k_c1  { 1.0};
+constexpr double k_c3  {-1.0 / 6.0};
+constexpr double k_c5  { 1.0 / 120.0};
+constexpr double k_c7  {-1.0 / 5'040.0};
+constexpr double k_c9  { 1.0 / 362'880.0};
+constexpr double k_c11 {-1.0 / 39'916'800.0};
+constexpr double k_c13 { 1.0 / 6'227'020'800.0};
+constexpr double k_c15 {-1.0 / 1'307'674'368'000.0};
+constexpr double k_c17 { 1.0 / 355'687'428'096'000.0};
+
+/**
+ * Evaluates sin(2 * pi * turns) for a single sample.
+ * - the integer part is dropped:          r in [-0.5, 0.5]
+ * - sin(2pi r) = sign(r) * sin(2pi |r|) and sin(2pi a) = sin(2pi (0.5 - a)),
+ *   so the polynomial is only evaluated on [0, pi/2].
+ */
+inline double sin_turns(double turns)
+{
+    double r = turns - std::nearbyint(turns);
+    double a = std::fabs(r);
+    double x = k_two_pi * std::fmin(a, 0.5 - a);
+    double x2 = x * x;
+
+    double p = k_c17;
+    p = p * x2 + k_c15;
+    p = p * x2 + k_c13;
+    p = p * x2 + k_c11;
+    p = p * x2 + k_c9;
+    p = p * x2 + k_c7;
+    p = p * x2 + k_c5;
+    p = p * x2 + k_c3;
+    p = p * x2 + k_c1;
+
+    return std::copysign(p * x, r);
+}
+
+/**
+ * True if the block has a chirp or an amplitude ramp, i.e. needs the modulated path.
+ */
+inline bool is_modulated(const sine_block_args& args)
+{
+    return args.phase_acceleration != 0.0 || args.amplitude_slope != 0.0;
+}
+
+template <bool Modulated>
+void sine_scalar_block(const sine_block_args& args, int32_t* samples, std::size_t count)
+{
+    for (std::size_t i{}; i < count; ++i) {
+        if constexpr (Modulated) {
+            double x = args.offset + i;
+            double amplitude = args.amplitude + x * args.amplitude_slope;
+            samples[i] = static_cast<int32_t>(amplitude * sin_turns(args.phase + x * (args.phase_increment + x * args.phase_acceleration)));
+        } else {
+            samples[i] = static_cast<int32_t>(args.amplitude * sin_turns(args.phase + (args.offset + i) * args.phase_increment));
+        }
+    }
+}
+
+void sine_scalar(const sine_block_args& args, int32_t* samples, std::size_t count)
+{
+    is_modulated(args) ? sine_scalar_block<true>(args, samples, count) : sine_scalar_block<false>(args, samples, count);
+}
+
+#if defined(WAVEGEN_X86)
+
+WAVEGEN_TARGET("avx2,fma")
+inline __m256d sin_turns_avx2(__m256d turns)
+{
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+
+    __m256d r = _mm256_sub_pd(turns, _mm256_round_pd(turns, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    __m256d sign = _mm256_and_pd(r, sign_mask);
+    __m256d a = _mm256_andnot_pd(sign_mask, r);
+    __m256d x = _mm256_mul_pd(_mm256_set1_pd(k_two_pi), _mm256_min_pd(a, _mm256_sub_pd(_mm256_set1_pd(0.5), a)));
+    __m256d x2 = _mm256_mul_pd(x, x);
+
+    __m256d p = _mm256_set1_pd(k_c17);
+    p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(k_c15));
+    p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(k_c13));
+    p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(k_c11));
+    p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(k_c9));
+    p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(k_c7));
+    p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(k_c5));
+    p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(k_c3));
+    p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(k_c1));
+
+    return _mm256_xor_pd(_mm256_mul_pd(p, x), sign);
+}
+
+WAVEGEN_TARGET("avx2,fma")
+inline __m128i sine_avx2(__m256d index, __m256d phase, __m256d phase_increment, __m256d amplitude)
+{
+    __m256d value = _mm256_mul_pd(amplitude, sin_turns_avx2(_mm256_fmadd_pd(index, phase_increment, phase)));
+    return _mm256_cvttpd_epi32(value);
+}
+
+WAVEGEN_TARGET("avx2,fma")
+inline __m128i sine_modulated_avx2(__m256d index, __m256d phase, __m256d phase_increment, __m256d amplitude, 
+                                   __m256d phase_acceleration, __m256d amplitude_slope)
+{
+    __m256d turns = _mm256_fmadd_pd(index, _mm256_fmadd_pd(index, phase_acceleration, phase_increment), phase);
+    __m256d value = _mm256_mul_pd(_mm256_fmadd_pd(index, amplitude_slope, amplitude), sin_turns_avx2(turns));
+    return _mm256_cvttpd_epi32(value);
+}
+
+template <bool Modulated>
+WAVEGEN_TARGET("avx2,fma")
+void sine_block_avx2(const sine_block_args& args, int32_t* samples, std::size_t count)
+{
+    const __m256d amplitude = _mm256_set1_pd(args.amplitude);
+    const __m256d phase = _mm256_set1_pd(args.phase);
+    const __m256d phase_increment = _mm256_set1_pd(args.phase_increment);
+    const __m256d phase_acceleration = _mm256_set1_pd(args.phase_acceleration);
+    const __m256d amplitude_slope = _mm256_set1_pd(args.amplitude_slope);
+    const __m256d lane_step = _mm256_set1_pd(4.0);
+
+    auto sine = [&](__m256d index) WAVEGEN_TARGET("avx2,fma") {
+        if constexpr (Modulated) {
+            return sine_modulated_avx2(index, phase, phase_increment, amplitude, phase_acceleration, amplitude_slope);
+        } else {
+            return sine_avx2(index, phase, phase_increment, amplitude);
+        }
+    };
+
+    __m256d index = _mm256_add_pd(_mm256_set1_pd(args.offset), _mm256_setr_pd(0.0, 1.0, 2.0, 3.0));
+    std::size_t i{};
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(samples + i), sine(index));
+        index = _mm256_add_pd(index, lane_step);
+    }
+
+    // the last partial vector is evaluated in full, so a sample does not depend on where a block ends
+    if (i < count) {
+        alignas(16) int32_t tail[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(tail), sine(index));
+        std::copy_n(tail, count - i, samples + i);
+    }
+}
+
+void sine_avx2(const sine_block_args& args, int32_t* samples, std::size_t count)
+{
+    is_modulated(args) ? sine_block_avx2<true>(args, samples, count) : sine_block_avx2<false>(args, samples, count);
+}
+
+WAVEGEN_TARGET("avx512f,avx512bw")
+inline __m512d sin_turns_avx512(__m512d turns)
+{
+    const __m512i sign_mask = _mm512_set1_epi64(static_cast<long long>(0x8000'0000'0000'0000ULL));
+
+    __m512d r = _mm512_sub_pd(turns, _mm512_roundscale_pd(turns, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    __m512i sign = _mm512_and_epi64(_mm512_castpd_si512(r), sign_mask);
+    __m512d a = _mm512_abs_pd(r);
+    __m512d x = _mm512_mul_pd(_mm512_set1_pd(k_two_pi), _mm512_min_pd(a, _mm512_sub_pd(_mm512_set1_pd(0.5), a)));
+    __m512d x2 = _mm512_mul_pd(x, x);
+
+    __m512d p = _mm512_set1_pd(k_c17);
+    p = _mm512_fmadd_pd(p, x2, _mm512_set1_pd(k_c15));
+    p = _mm512_fmadd_pd(p, x2, _mm512_set1_pd(k_c13));
+    p = _mm512_fmadd_pd(p, x2, _mm512_set1_pd(k_c11));
+    p = _mm512_fmadd_pd(p, x2, _mm512_set1_pd(k_c9));
+    p = _mm512_fmadd_pd(p, x2, _mm512_set1_pd(k_c7));
+    p = _mm512_fmadd_pd(p, x2, _mm512_set1_pd(k_c5));
+    p = _mm512_fmadd_pd(p, x2, _mm512_set1_pd(k_c3));
+    p = _mm512_fmadd_pd(p, x2, _mm512_set1_pd(k_c1));
+
+    return _mm512_castsi512_pd(_mm512_xor_epi64(_mm512_castpd_si512(_mm512_mul_pd(p, x)), sign));
+}
+
+WAVEGEN_TARGET("avx512f,avx512bw")
+inline __m256i sine_avx512(__m512d index, __m512d phase, __m512d phase_increment, __m512d amplitude)
+{
+    __m512d value = _mm512_mul_pd(amplitude, sin_turns_avx512(_mm512_fmadd_pd(index, phase_increment, phase)));
+    return _mm512_cvttpd_epi32(value);
+}
+
+WAVEGEN_TARGET("avx512f,avx512bw")
+inline __m256i sine_modulated_avx512(__m512d index, __m512d phase, __m512d phase_increment, __m512d amplitude, 
+                                     __m512d phase_acceleration, __m512d amplitude_slope)
+{
+    __m512d turns = _mm512_fmadd_pd(index, _mm512_fmadd_pd(index, phase_acceleration, phase_increment), phase);
+    __m512d value = _mm512_mul_pd(_mm512_fmadd_pd(index, amplitude_slope, amplitude), sin_turns_avx512(turns));
+    return _mm512_cvttpd_epi32(value);
+}
+
+template <bool Modulated>
+WAVEGEN_TARGET("avx512f,avx512bw")
+void sine_block_avx512(const sine_block_args& args, int32_t* samples, std::size_t count)
+{
+    const __m512d amplitude = _mm512_set1_pd(args.amplitude);
+    const __m512d phase = _mm512_set1_pd(args.phase);
+    const __m512d phase_increment = _mm512_set1_pd(args.phase_increment);
+    const __m512d phase_acceleration = _mm512_set1_pd(args.phase_acceleration);
+    const __m512d amplitude_slope = _mm512_set1_pd(args.amplitude_slope);
+    const __m512d lane_step = _mm512_set1_pd(8.0);
+
+    auto sine = [&](__m512d index) WAVEGEN_TARGET("avx512f,avx512bw") {
+        if constexpr (Modulated) {
+            return sine_modulated_avx512(index, phase, phase_increment, amplitude, phase_acceleration, amplitude_slope);
+        } else {
+            return sine_avx512(index, phase, phase_increment, amplitude);
+        }
+    };
+
+    __m512d index = _mm512_add_pd(_mm512_set1_pd(args.offset), _mm512_setr_pd(0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0));
+    std::size_t i{};
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(samples + i), sine(index));
+        index = _mm512_add_pd(index, lane_step);
+    }
+
+    // the last partial vector is evaluated in full, so a sample does not depend on where a block ends
+    if (i < count) {
+        alignas(32) int32_t tail[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(tail), sine(index));
+        std::copy_n(tail, count - i, samples + i);
+    }
+}
+
+void sine_avx512(const sine_block_args& args, int32_t* samples, std::size_t count)
+{
+    is_modulated(args) ? sine_block_avx512<true>(args, samples, count) : sine_block_avx512<false>(args, samples, count);
+}
+
+#elif defined(WAVEGEN_NEON)
+
+inline float64x2_t sin_turns_neon(float64x2_t turns)
+{
+    const uint64x2_t sign_mask = vdupq_n_u64(0x8000'0000'0000'0000ULL);
+
+    float64x2_t r = vsubq_f64(turns, vrndnq_f64(turns));
+    uint64x2_t sign = vandq_u64(vreinterpretq_u64_f64(r), sign_mask);
+    float64x2_t a = vabsq_f64(r);
+    float64x2_t x = vmulq_n_f64(vminq_f64(a, vsubq_f64(vdupq_n_f64(0.5), a)), k_two_pi);
+    float64x2_t x2 = vmulq_f64(x, x);
+
+    float64x2_t p = vdupq_n_f64(k_c17);
+    p = vfmaq_f64(vdupq_n_f64(k_c15), p, x2);
+    p = vfmaq_f64(vdupq_n_f64(k_c13), p, x2);
+    p = vfmaq_f64(vdupq_n_f64(k_c11), p, x2);
+    p = vfmaq_f64(vdupq_n_f64(k_c9), p, x2);
+    p = vfmaq_f64(vdupq_n_f64(k_c7), p, x2);
+    p = vfmaq_f64(vdupq_n_f64(k_c5), p, x2);
+    p = vfmaq_f64(vdupq_n_f64(k_c3), p, x2);
+    p = vfmaq_f64(vdupq_n_f64(k_c1), p, x2);
+
+    return vreinterpretq_f64_u64(veorq_u64(vreinterpretq_u64_f64(vmulq_f64(p, x)), sign));
+}
+
+inline int32x2_t sine_neon(float64x2_t index, float64x2_t phase, float64x2_t phase_increment, double amplitude)
+{
+    float64x2_t value = vmulq_n_f64(sin_turns_neon(vfmaq_f64(phase, index, phase_increment)), amplitude);
+    return vmovn_s64(vcvtq_s64_f64(value));
+}
+
+inline int32x2_t sine_modulated_neon(float64x2_t index, float64x2_t phase, float64x2_t phase_increment, double amplitude,
+                                     float64x2_t phase_acceleration, float64x2_t amplitude_slope)
+{
+    float64x2_t turns = vfmaq_f64(phase, index, vfmaq_f64(phase_increment, index, phase_acceleration));
+    float64x2_t value = vmulq_f64(sin_turns_neon(turns), vfmaq_f64(vdupq_n_f64(amplitude), index, amplitude_slope));
+    return vmovn_s64(vcvtq_s64_f64(value));
+}
+
+template <bool Modulated>
+void sine_block_neon(const sine_block_args& args, int32_t* samples, std::size_t count)
+{
+    const float64x2_t phase = vdupq_n_f64(args.phase);
+    const float64x2_t phase_increment = vdupq_n_f64(args.phase_increment);
+    const float64x2_t phase_acceleration = vdupq_n_f64(args.phase_acceleration);
+    const float64x2_t amplitude_slope = vdupq_n_f64(args.amplitude_slope);
+    const float64x2_t lane_step = vdupq_n_f64(4.0);
+
+    auto sine = [&](float64x2_t index) {
+        if constexpr (Modulated) {
+            return sine_modulated_neon(index, phase, phase_increment, args.amplitude, phase_acceleration, amplitude_slope);
+        } else {
+            return sine_neon(index, phase, phase_increment, args.amplitude);
+        }
+    };
+
+    // two vectors per iteration to hide the latency of the polynomial
+    float64x2_t index_lo = vaddq_f64(vdupq_n_f64(args.offset), float64x2_t{0.0, 1.0});
+    float64x2_t index_hi = vaddq_f64(vdupq_n_f64(args.offset), float64x2_t{2.0, 3.0});
+    std::size_t i{};
+    for (; i + 4 <= count; i += 4) {
+        vst1q_s32(samples + i, vcombine_s32(sine(index_lo), sine(index_hi)));
+        index_lo = vaddq_f64(index_lo, lane_step);
+        index_hi = vaddq_f64(index_hi, lane_step);
+    }
+
+    // the last partial vector is evaluated in full, so a sample does not depend on where a block ends
+    if (i < count) {
+        int32_t tail[4];
+        vst1q_s32(tail, vcombine_s32(sine(index_lo), sine(index_hi)));
+        std::copy_n(tail, count - i, samples + i);
+    }
+}
+
+void sine_neon(const sine_block_args& args, int32_t* samples, std::size_t count)
+{
+    is_modulated(args) ? sine_block_neon<true>(args, samples, count) : sine_block_neon<false>(args, samples, count);
+}
+
+#endif
+
+}// namespace
+
+sine_kernel get_sine_kernel(simd_isa isa)
+{
+    if (!cpu_supports(isa)) {
+        return nullptr;
+    }
+
+    switch (isa) {
+        case simd_isa::scalar: return sine_scalar;
+#if defined(WAVEGEN_X86)
+        case simd_isa::avx2:   return sine_avx2;
+        case simd_isa::avx512: return sine_avx512;
+#elif defined(WAVEGEN_NEON)
+        case simd_isa::neon:   return sine_neon;
+#endif
+        default:               return nullptr;
+    }
+}
+
+sine_kernel best_sine_kernel()
+{
+    static const sine_kernel kernel = [] {
+        for (auto isa : {simd_isa::avx512, simd_isa::avx2, simd_isa::neon}) {
+            if (auto kernel = get_sine_kernel(isa)) {
+                return kernel;
+            }
+        }
+        return sine_scalar;
+    }();
+
+    return kernel;
+}
+
+}// namespace wavegen
@@ -0,0 +1,72 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Vectorised polynomial sine kernels which fill a block of samples at once.
+ */
+#ifndef SINE_KERNELS_H_
+#define SINE_KERNELS_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "CpuFeatures.h"
+
+namespace wavegen
+{
+
+/**
+ * Describes a block of sine samples. With x = offset + i, sample i of the block is
+ * (amplitude + x * amplitude_slope) * sin(2 * pi * (phase + x * (phase_increment + x * phase_acceleration))),
+ * truncated to an integer. Phases are given in turns (periods), so the kernels reduce the argument
+ * exactly by dropping the integer part. The offset lets a block start in the middle of another
+ * one and still produce the very same samples.
+ * The quadratic phase term renders a linear chirp and the amplitude slope a linear ramp, at two
+ * multiply-adds per sample. Blocks without them take the plain path.
+ */
+struct sine_block_args
+{
+    double amplitude;
+    double phase;
+    double phase_increment;
+    double offset;
+    double phase_acceleration {};   // Turns per sample squared
+    double amplitude_slope {};      // Amplitude change per sample
+};
+
+/**
+ * Returns (x * y) mod 1 for a non-negative x, e.g. the phase in turns of sample x of a wave advancing
+ * y turns per sample. The rounding error of the product is recovered with an fma, so the result
+ * stays accurate for large sample indices.
+ */
+inline double fractional_product(double x, double y)
+{
+    double product = x * y;
+    double error = std::fma(x, y, -product);
+    double fraction = (product - std::floor(product)) + error;
+
+    return fraction - std::floor(fraction);
+}
+
+/**
+ * A sine kernel fills count samples described by args.
+ * The polynomial is accurate to ~5e-14 of the amplitude on all kernels, so samples
+ * differ from a std::sin based computation by at most 1 LSB (only where the exact
+ * value lies that close to an integer).
+ */
+using sine_kernel = void (*)(const sine_block_args& args, int32_t* samples, std::size_t count);
+
+/**
+ * Returns the kernel for the given instruction set, or nullptr if the kernel
+ * is not available on this platform or CPU.
+ */
+sine_kernel get_sine_kernel(simd_isa isa);
+
+/**
+ * Returns the fastest kernel supported by the running CPU.
+ */
+sine_kernel best_sine_kernel();
+
+}// namespace wavegen
+
+#endif // SINE_KERNELS_H_
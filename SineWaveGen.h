@@ -6,37 +6,208 @@
 #ifndef SINE_WAVE_GEN_H_
 #define SINE_WAVE_GEN_H_
 
+#include <span>
 #include <cstdint>
 #include <cmath>
+#include <algorithm>
+
+#include "SineKernels.h"
 
 namespace wavegen
 {
 
 constexpr double    k_PI {3.141592653589793};
 
+/**
+ * Selects how a generator evaluates the sine function.
+ *
+ * - exact:     std::sin is evaluated for every sample.
+ * - recursive: sample n+1 is produced from sample n by rotating a unit phasor by the
+ *              per-sample phase increment (two multiplies and an add per component).
+ *              The phasor is resynchronised with the exact path every k_resync_interval
+ *              samples (also when samples are requested out of order), so rounding
+ *              errors cannot accumulate. Each rotation adds at most ~3 ulp of error, so
+ *              the deviation from the exact path stays below
+ *              k_resync_interval * 3 * 2^-53 (~3.4e-13) of the amplitude, plus the rounding
+ *              of the exact path's own argument (~phase * 2^-53, e.g. ~4e-10 after ten minutes
+ *              at 1 kHz). Both are far below one LSB of a 24 bit sample, but as samples are
+ *              truncated to integers, a sample whose value lies within that distance of an
+ *              integer may differ by 1.
+ * - polynomial: samples are evaluated by the vectorised polynomial kernel of the running
+ *              CPU (see SineKernels.h), a block at a time when filled with generate().
+ *              The phase of every kernel block is reduced exactly with integer arithmetic.
+ *              Samples differ from the exact path by at most 1 LSB.
+ * - integer:   the phase of every sample is reduced with integer arithmetic first,
+ *              (sample_index * frequency) % sample_rate in 1 / sample_rate turns, so std::sin
+ *              only ever sees an argument in [0, 2 pi). The wave repeats exactly after every
+ *              period, and a sample is as accurate after days of audio as at the start, where
+ *              the argument of the exact path grows with the index and loses its precision
+ *              (and makes std::sin reduce it, the slow path for large arguments).
+ */
+enum class oscillator_mode
+{
+    exact,
+    recursive,
+    polynomial,
+    integer
+};
+
 /** 
  * sinusoidal sound generator 
  **/
 class sine_wave_generator
 {
 public:
-    sine_wave_generator(uint32_t wave_amplitude, uint32_t wave_frequency, uint32_t sample_rate) 
+    static constexpr uint32_t k_resync_interval {1'024};   // Samples between two resynchronisations of the recursive path
+    static constexpr uint32_t k_kernel_block {4'096};      // Samples per polynomial kernel call, each starts from an exact phase
+
+    sine_wave_generator(uint32_t wave_amplitude, uint32_t wave_frequency, uint32_t sample_rate,
+                        oscillator_mode mode = oscillator_mode::exact) 
         : m_amplitude(wave_amplitude)
         , m_frequency(wave_frequency)
         , m_sample_rate(sample_rate) 
+        , m_mode(mode)
+        , m_time_increment(1.0/sample_rate)
+        , m_angular_frequency(2.0 * k_PI * wave_frequency)
+        , m_radians_per_step(2.0 * k_PI / sample_rate)
+        , m_rotation_re(std::cos(m_angular_frequency * m_time_increment))
+        , m_rotation_im(std::sin(m_angular_frequency * m_time_increment))
+        , m_kernel(best_sine_kernel())
     {
     }
 
-    int32_t get_sample(uint32_t sample_index) {
-        double time_increment = 1.0/m_sample_rate;
-        auto sample_time = sample_index * time_increment;
-        return static_cast<int32_t>(m_amplitude * std::sin(2.0 * k_PI  * m_frequency * sample_time));
+    int32_t get_sample(uint64_t sample_index) {
+        if (m_mode == oscillator_mode::recursive) {
+            return get_recursive_sample(sample_index);
+        }
+
+        if (m_mode == oscillator_mode::polynomial) {
+            int32_t sample{};
+            auto block_offset = sample_index % k_kernel_block;
+            m_kernel(kernel_args(sample_index - block_offset, block_offset), &sample, 1);
+            return sample;
+        }
+
+        if (m_mode == oscillator_mode::integer) {
+            return static_cast<int32_t>(m_amplitude * std::sin(reduced_phase_of(sample_index)));
+        }
+
+        return static_cast<int32_t>(m_amplitude * std::sin(phase_of(sample_index)));
     }
 
+    /**
+     * Fills the given block with consecutive samples, starting at first_index.
+     */
+    void generate(std::span<int32_t> samples, uint64_t first_index) {
+        if (m_mode == oscillator_mode::integer) {
+            generate_integer(samples, first_index);
+            return;
+        }
+
+        if (m_mode != oscillator_mode::polynomial) {
+            for (auto& sample : samples) {
+                sample = get_sample(first_index++);
+            }
+            return;
+        }
+
+        // kernel blocks are aligned to absolute sample indices, so a sample does not depend on
+        // how the output is split into blocks (or threads)
+        for (std::size_t offset{}; offset < samples.size(); ) {
+            auto sample_index = first_index + offset;
+            auto block_offset = static_cast<uint32_t>(sample_index % k_kernel_block);
+            auto count = std::min<std::size_t>(k_kernel_block - block_offset, samples.size() - offset);
+
+            m_kernel(kernel_args(sample_index - block_offset, block_offset), samples.data() + offset, count);
+            offset += count;
+        }
+    }
+
+    oscillator_mode mode() const { return m_mode; }
+
 private:
+    double phase_of(uint64_t sample_index) const {
+        auto sample_time = sample_index * m_time_increment;
+        return m_angular_frequency * sample_time;
+    }
+
+    // the phase of sample_index in 1 / m_sample_rate turns, without overflow for any index
+    uint64_t phase_numerator_of(uint64_t sample_index) const {
+        return sample_index % m_sample_rate * m_frequency % m_sample_rate;
+    }
+
+    double reduced_phase_of(uint64_t sample_index) const {
+        return static_cast<double>(phase_numerator_of(sample_index)) * m_radians_per_step;
+    }
+
+    // the integer path of generate(): the phase numerator is stepped instead of reduced per sample
+    void generate_integer(std::span<int32_t> samples, uint64_t first_index) const {
+        auto phase_numerator = phase_numerator_of(first_index);
+        auto step = m_frequency % m_sample_rate;
+
+        for (auto& sample : samples) {
+            sample = static_cast<int32_t>(m_amplitude * std::sin(static_cast<double>(phase_numerator) * m_radians_per_step));
+            phase_numerator += step;
+            if (phase_numerator >= m_sample_rate) {
+                phase_numerator -= m_sample_rate;
+            }
+        }
+    }
+
+    sine_block_args kernel_args(uint64_t block_index, uint32_t block_offset) const {
+        auto phase_numerator = phase_numerator_of(block_index);
+        return {static_cast<double>(m_amplitude),
+                static_cast<double>(phase_numerator) / m_sample_rate,
+                static_cast<double>(m_frequency) / m_sample_rate,
+                static_cast<double>(block_offset)};
+    }
+
+    int32_t get_recursive_sample(uint64_t sample_index) {
+        if (sample_index != m_next_index || sample_index % k_resync_interval == 0) {
+            // seed at the last resynchronisation point, so a sample only depends on its index
+            // and not on the order (or the thread) it is generated in
+            auto seed_index = sample_index - sample_index % k_resync_interval;
+            auto phase = phase_of(seed_index);
+            m_phasor_re = std::cos(phase);
+            m_phasor_im = std::sin(phase);
+
+            for (; seed_index < sample_index; ++seed_index) {
+                rotate_phasor();
+            }
+        }
+
+        auto sample = static_cast<int32_t>(m_amplitude * m_phasor_im);
+
+        rotate_phasor();
+        m_next_index = sample_index + 1;
+
+        return sample;
+    }
+
+    // rotates the phasor by one sample
+    void rotate_phasor() {
+        auto re = m_phasor_re * m_rotation_re - m_phasor_im * m_rotation_im;
+        m_phasor_im = m_phasor_re * m_rotation_im + m_phasor_im * m_rotation_re;
+        m_phasor_re = re;
+    }
+
     uint32_t m_amplitude;
     uint32_t m_frequency;
     uint32_t m_sample_rate;
+    oscillator_mode m_mode;
+
+    double m_time_increment;        // Seconds per sample
+    double m_angular_frequency;     // Radians per second
+    double m_radians_per_step;      // Radians per 1 / m_sample_rate turns of the integer path
+
+    // State of the recursive path
+    double m_rotation_re;           // cos of the per-sample phase increment
+    double m_rotation_im;           // sin of the per-sample phase increment
+    double m_phasor_re {1.0};
+    double m_phasor_im {};
+    uint64_t m_next_index {};       // The sample index the phasor currently points at
+
+    sine_kernel m_kernel;           // Kernel of the polynomial path
 };
 
 }
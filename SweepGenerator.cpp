@@ -0,0 +1,183 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   A sinusoidal generator with fractional frequencies, frequency sweeps (chirps)
+ *          and an amplitude envelope.
+ */
+#include "SweepGenerator.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+
+namespace wavegen
+{
+
+sweep_generator::sweep_generator(double amplitude, const frequency_sweep& sweep, const std::vector<envelope_point>& envelope,
+                                 uint32_t sample_rate)
+    : m_amplitude(amplitude)
+    , m_shape(sweep.shape)
+    , m_start_increment(sweep.start_frequency / sample_rate)
+    , m_end_increment(sweep.shape == sweep_shape::none ? m_start_increment : sweep.end_frequency / sample_rate)
+    , m_sweep_length(static_cast<uint64_t>(std::llround(std::max(0.0, sweep.duration_sec) * sample_rate)))
+    , m_block_size(sweep.shape == sweep_shape::exponential ? k_exponential_block_size : k_block_size)
+    , m_kernel(best_sine_kernel())
+{
+    if (!(m_start_increment > 0.0 && m_start_increment <= 0.5 && m_end_increment > 0.0 && m_end_increment <= 0.5)) {
+        throw std::invalid_argument("Invalid argument. Sweep frequencies should be greater than 0 and at most half of the sample rate.");
+    }
+
+    if (!(sweep.duration_sec >= 0.0)) {
+        throw std::invalid_argument("Invalid argument. Sweep duration should not be negative.");
+    }
+
+    if (m_sweep_length == 0 || m_end_increment == m_start_increment) {
+        m_shape = sweep_shape::none;
+        m_end_increment = m_start_increment;
+    }
+
+    // the samples are laid out so that phase_at(n) = m_start_increment * n + m_acceleration * n^2 for a linear chirp,
+    // and m_start_increment * (exp(n * m_log_ratio) - 1) / m_log_ratio for an exponential one
+    if (m_shape == sweep_shape::linear) {
+        m_acceleration = (m_end_increment - m_start_increment) / (2.0 * m_sweep_length);
+    } else if (m_shape == sweep_shape::exponential) {
+        m_log_ratio = std::log(m_end_increment / m_start_increment) / m_sweep_length;
+    }
+
+    if (m_shape != sweep_shape::none) {
+        m_end_phase = sweep_phase(static_cast<double>(m_sweep_length));
+        m_cuts.push_back(m_sweep_length);
+    }
+
+    for (const auto& point : envelope) {
+        if (!(point.gain >= 0.0 && point.gain <= 1.0)) {
+            throw std::invalid_argument("Invalid argument. Envelope gains should be between 0 and 1.");
+        }
+
+        auto breakpoint = static_cast<uint64_t>(std::llround(std::max(0.0, point.time_sec) * sample_rate));
+        if (!m_breakpoints.empty() && breakpoint <= m_breakpoints.back()) {
+            throw std::invalid_argument("Invalid argument. Envelope breakpoints should be in increasing order of time.");
+        }
+
+        m_breakpoints.push_back(breakpoint);
+        m_gains.push_back(point.gain);
+        m_cuts.push_back(breakpoint);
+    }
+
+    std::sort(m_cuts.begin(), m_cuts.end());
+}
+
+double sweep_generator::phase_at(uint64_t sample_index) const
+{
+    if (m_shape == sweep_shape::none) {
+        return fractional_product(static_cast<double>(sample_index), m_start_increment);
+    }
+
+    if (sample_index >= m_sweep_length) {
+        double phase = m_end_phase + fractional_product(static_cast<double>(sample_index - m_sweep_length), m_end_increment);
+        return phase - std::floor(phase);
+    }
+
+    return sweep_phase(static_cast<double>(sample_index));
+}
+
+double sweep_generator::sweep_phase(double index) const
+{
+    if (m_shape == sweep_shape::linear) {
+        // n^2 * a mod 1 equals n * (n * a mod 1) mod 1
+        double phase = fractional_product(index, m_start_increment) + fractional_product(index, fractional_product(index, m_acceleration));
+        return phase - std::floor(phase);
+    }
+
+    double phase = m_start_increment * std::expm1(index * m_log_ratio) / m_log_ratio;
+    return phase - std::floor(phase);
+}
+
+double sweep_generator::gain_at(uint64_t sample_index) const
+{
+    if (m_gains.empty()) {
+        return 1.0;
+    }
+
+    auto next = std::upper_bound(m_breakpoints.begin(), m_breakpoints.end(), sample_index);
+    if (next == m_breakpoints.begin()) {
+        return m_gains.front();
+    }
+    if (next == m_breakpoints.end()) {
+        return m_gains.back();
+    }
+
+    auto point = static_cast<std::size_t>(next - m_breakpoints.begin()) - 1;
+    double position = static_cast<double>(sample_index - m_breakpoints[point]) / (m_breakpoints[point + 1] - m_breakpoints[point]);
+    return m_gains[point] + position * (m_gains[point + 1] - m_gains[point]);
+}
+
+void sweep_generator::get_block(uint64_t sample_index, uint64_t& block_index, uint64_t& block_end) const
+{
+    block_index = sample_index - sample_index % m_block_size;
+    block_end = block_index + m_block_size;
+
+    auto next_cut = std::upper_bound(m_cuts.begin(), m_cuts.end(), sample_index);
+    if (next_cut != m_cuts.end()) {
+        block_end = std::min(block_end, *next_cut);
+    }
+    if (next_cut != m_cuts.begin()) {
+        block_index = std::max(block_index, *(next_cut - 1));
+    }
+}
+
+sine_block_args sweep_generator::block_args(uint64_t block_index, uint64_t block_length) const
+{
+    sine_block_args args {m_amplitude * gain_at(block_index), phase_at(block_index), m_start_increment, 0.0};
+
+    // the gain is linear between two breakpoints, and blocks never span a breakpoint
+    auto next = std::upper_bound(m_breakpoints.begin(), m_breakpoints.end(), block_index);
+    if (next != m_breakpoints.begin() && next != m_breakpoints.end()) {
+        auto point = static_cast<std::size_t>(next - m_breakpoints.begin()) - 1;
+        args.amplitude_slope = m_amplitude * (m_gains[point + 1] - m_gains[point]) / (m_breakpoints[point + 1] - m_breakpoints[point]);
+    }
+
+    if (m_shape == sweep_shape::none) {
+        return args;
+    }
+
+    if (block_index >= m_sweep_length) {
+        args.phase_increment = m_end_increment;
+        return args;
+    }
+
+    if (m_shape == sweep_shape::linear) {
+        args.phase_increment = m_start_increment + 2.0 * m_acceleration * block_index;
+        args.phase_acceleration = m_acceleration;
+        return args;
+    }
+
+    // fits b * x + c * x^2 through the phase advances to the middle and the end of the block,
+    // the advances are computed from the instantaneous increment at the start, without cancellation
+    double increment = m_start_increment * std::exp(block_index * m_log_ratio);
+    double half_length = block_length / 2.0;
+    double half_advance = increment * std::expm1(half_length * m_log_ratio) / m_log_ratio;
+    double full_advance = increment * std::expm1(block_length * m_log_ratio) / m_log_ratio;
+
+    args.phase_increment = (4.0 * half_advance - full_advance) / (2.0 * half_length);
+    args.phase_acceleration = (full_advance - 2.0 * half_advance) / (2.0 * half_length * half_length);
+    return args;
+}
+
+void sweep_generator::generate(std::span<int32_t> samples, uint64_t first_index) const
+{
+    for (std::size_t offset{}; offset < samples.size(); ) {
+        uint64_t sample_index = first_index + static_cast<uint64_t>(offset);
+        uint64_t block_index{}, block_end{};
+        get_block(sample_index, block_index, block_end);
+
+        auto args = block_args(block_index, block_end - block_index);
+        args.offset = static_cast<double>(sample_index - block_index);
+        auto count = std::min<std::size_t>(block_end - sample_index, samples.size() - offset);
+
+        m_kernel(args, samples.data() + offset, count);
+        offset += count;
+    }
+}
+
+}// namespace wavegen
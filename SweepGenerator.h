@@ -0,0 +1,115 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   A sinusoidal generator with fractional frequencies, frequency sweeps (chirps)
+ *          and an amplitude envelope.
+ */
+#ifndef SWEEP_GENERATOR_H_
+#define SWEEP_GENERATOR_H_
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+#include "SineKernels.h"
+
+namespace wavegen
+{
+
+// How the frequency moves from the start to the end frequency of a sweep.
+enum class sweep_shape
+{
+    none,           // constant start frequency
+    linear,         // the frequency changes by the same number of Hz per second
+    exponential     // the frequency changes by the same ratio (octaves) per second
+};
+
+// A frequency sweep, the end frequency is held once the sweep is over.
+struct frequency_sweep
+{
+    double start_frequency {};  // Hz, may be fractional
+    double end_frequency {};    // Hz
+    double duration_sec {};
+    sweep_shape shape {sweep_shape::none};
+};
+
+// A breakpoint of an amplitude envelope.
+struct envelope_point
+{
+    double time_sec;
+    double gain;        // Factor of the amplitude, between 0 and 1
+
+    bool operator==(const envelope_point&) const = default;
+};
+
+/**
+ * Renders amplitude * gain(t) * sin(2 * pi * phase(t)), where phase(t) integrates the frequency
+ * of the sweep exactly, so the wave stays continuous through the whole sweep, and gain(t)
+ * interpolates linearly between the envelope breakpoints (holding the first and last gain).
+ *
+ * The samples are split into blocks of k_block_size (k_exponential_block_size for an exponential
+ * chirp), aligned to absolute sample indices and cut at the end of the sweep and at every
+ * breakpoint. The phase, instantaneous frequency and
+ * gain of a block are computed exactly (in closed form) at its start, and the polynomial
+ * kernel then advances a quadratic phase and a linear gain across the block at two extra
+ * multiply-adds per sample. So a sample only depends on its index, no error accumulates from
+ * block to block, and rendering stays vectorised.
+ *
+ * Within a block a constant tone, a linear chirp and the envelope are exact. An exponential
+ * chirp is interpolated by the parabola through the phases at the start, middle and end of
+ * the block, which deviates from the exact phase by at most
+ *     0.008 * k_exponential_block_size^3 * (f_max / sample_rate) * (ln(f_end / f_start) / sweep_samples)^2
+ * turns, e.g. ~3e-9 turns (0.15 LSB at 24 bit full scale) for 20 Hz to 20 kHz in 10 seconds.
+ * The closed forms are evaluated with fma-corrected products, their phase error grows with the
+ * sample index roughly like index * 2^-53 turns.
+ */
+class sweep_generator
+{
+public:
+    static constexpr uint32_t k_block_size {64};                // Samples per kernel block
+    static constexpr uint32_t k_exponential_block_size {16};    // Samples per kernel block of an exponential chirp
+
+    /**
+     * Throws std::invalid_argument for frequencies outside (0, sample_rate / 2], a negative duration,
+     * gains outside [0, 1] or breakpoints out of order.
+     */
+    sweep_generator(double amplitude, const frequency_sweep& sweep, const std::vector<envelope_point>& envelope,
+                    uint32_t sample_rate);
+
+    /**
+     * Fills the given block with consecutive samples, starting at first_index.
+     */
+    void generate(std::span<int32_t> samples, uint64_t first_index) const;
+
+private:
+    // Phase of the given sample in turns, reduced to [0, 1).
+    double phase_at(uint64_t sample_index) const;
+    // Phase of a sample of the sweep by its closed form, which also holds at the end of the sweep (index m_sweep_length).
+    double sweep_phase(double index) const;
+    double gain_at(uint64_t sample_index) const;
+
+    // The block holding the given sample, cut at the end of the sweep and at the breakpoints.
+    void get_block(uint64_t sample_index, uint64_t& block_index, uint64_t& block_end) const;
+
+    sine_block_args block_args(uint64_t block_index, uint64_t block_length) const;
+
+    double m_amplitude;
+    sweep_shape m_shape;
+    double m_start_increment;       // Turns per sample at the start of the sweep
+    double m_end_increment;         // Turns per sample at the end of the sweep
+    uint64_t m_sweep_length;        // Samples of the sweep
+    double m_acceleration {};       // Linear chirp: turns per sample squared
+    double m_log_ratio {};          // Exponential chirp: ln of the increment ratio per sample
+    double m_end_phase {};          // Phase at the end of the sweep, in turns reduced to [0, 1)
+
+    std::vector<uint64_t> m_breakpoints;    // Sample indices of the envelope breakpoints
+    std::vector<double> m_gains;
+    std::vector<uint64_t> m_cuts;           // Sorted indices where blocks end: the end of the sweep and the breakpoints
+    uint32_t m_block_size;
+
+    sine_kernel m_kernel;
+};
+
+}// namespace wavegen
+
+#endif // SWEEP_GENERATOR_H_
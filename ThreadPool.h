@@ -0,0 +1,167 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   A fixed-size pool of worker threads which run one task on all workers at a time.
+ */
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+#include "NumaMemory.h"
+
+namespace wavegen
+{
+
+/**
+ * Runs a task on a fixed number of workers and waits for all of them to finish.
+ * The calling thread takes part as worker 0, so a pool of size 1 starts no threads.
+ * An exception thrown by any worker is rethrown by run() once all workers are done.
+ * A pinned pool pins every worker to a CPU of get_worker_cpu(), so worker i always runs on the same
+ * NUMA node and the memory it first writes, e.g. its range of for_each_range, is allocated there.
+ * The calling thread is only pinned while it runs its part of a task, run() restores its CPUs.
+ */
+class thread_pool
+{
+public:
+    // Thread count 0 selects one worker per hardware thread.
+    explicit thread_pool(unsigned thread_count, bool pin_threads = false)
+        : m_size(thread_count ? thread_count : std::max(1u, std::thread::hardware_concurrency()))
+        , m_pinned(pin_threads)
+    {
+        m_threads.reserve(m_size - 1);
+        for (unsigned worker_index{1}; worker_index < m_size; ++worker_index) {
+            m_threads.emplace_back([this, worker_index] {
+                if (m_pinned) {
+                    pin_current_thread(get_worker_cpu(worker_index, m_size));
+                }
+                worker_loop(worker_index);
+            });
+        }
+    }
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_task_ready.notify_all();
+
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    unsigned size() const { return m_size; }
+    bool pinned() const { return m_pinned; }
+
+    /**
+     * Runs task(worker_index) once on every worker.
+     */
+    void run(const std::function<void(unsigned)>& task) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_task = &task;
+            m_pending = m_size - 1;
+            m_error = nullptr;
+            ++m_generation;
+        }
+        m_task_ready.notify_all();
+
+        // the pool outlives the renders of a context, the calling thread must not stay pinned after them
+        {
+            std::optional<thread_pin> caller_pin;
+            if (m_pinned) {
+                caller_pin.emplace(get_worker_cpu(0, m_size));
+            }
+            execute(0);
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_task_done.wait(lock, [this] { return m_pending == 0; });
+        m_task = nullptr;
+
+        if (m_error) {
+            std::rethrow_exception(m_error);
+        }
+    }
+
+    /**
+     * Splits [0, count) into one contiguous, disjoint range per worker
+     * and runs task(worker_index, begin, end) on each of them.
+     */
+    void for_each_range(std::size_t count, const std::function<void(unsigned, std::size_t, std::size_t)>& task) {
+        auto range_task = [&](unsigned worker_index) {
+            std::size_t begin = count * worker_index / m_size;
+            std::size_t end = count * (worker_index + 1) / m_size;
+            if (begin < end) {
+                task(worker_index, begin, end);
+            }
+        };
+        // a reference fits into std::function without a heap allocation
+        run(std::cref(range_task));
+    }
+
+private:
+    void worker_loop(unsigned worker_index) {
+        uint64_t seen_generation {};
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_task_ready.wait(lock, [&] { return m_stopping || m_generation != seen_generation; });
+                if (m_stopping) {
+                    return;
+                }
+                seen_generation = m_generation;
+            }
+
+            execute(worker_index);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_pending == 0) {
+                m_task_done.notify_one();
+            }
+        }
+    }
+
+    void execute(unsigned worker_index) {
+        try {
+            (*m_task)(worker_index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+        }
+    }
+
+    unsigned m_size;
+    bool m_pinned;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_task_ready;
+    std::condition_variable m_task_done;
+
+    const std::function<void(unsigned)>* m_task {};
+    unsigned m_pending {};          // Workers (besides the caller) still running the current task
+    uint64_t m_generation {};       // Incremented for every task, wakes up the workers
+    std::exception_ptr m_error;
+    bool m_stopping {};
+};
+
+}// namespace wavegen
+
+#endif // THREAD_POOL_H_
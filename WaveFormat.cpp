@@ -0,0 +1,128 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   The format of a Wave file, and the construction and parsing of its header.
+ */
+#include "WaveFormat.h"
+
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+namespace wavegen
+{
+
+namespace
+{
+
+// The serializer runs at compile time, these check it against the layout of the header structs.
+constexpr bool is_serialized_like(wave_container container, std::size_t field_offset, uint64_t field_value, std::size_t field_size)
+{
+    wave_format format {container, sample_format::pcm, 2, 48'000, 24};
+    auto header = get_wave_header(format, 48'000 * 6);
+
+    uint64_t value{};
+    for (std::size_t i{}; i < field_size; ++i) {
+        value |= static_cast<uint64_t>(header.bytes[field_offset + i]) << (8 * i);
+    }
+    return header.size() == get_wave_header_size(container) && value == field_value;
+}
+
+static_assert(is_serialized_like(wave_container::riff, offsetof(wave::WaveHeader, file_size), 44 + 288'000 - 8, 4));
+static_assert(is_serialized_like(wave_container::riff, offsetof(wave::WaveHeader, bytes_per_sec), 288'000, 4));
+static_assert(is_serialized_like(wave_container::riff, offsetof(wave::WaveHeader, data_size), 288'000, 4));
+static_assert(is_serialized_like(wave_container::rf64, offsetof(wave::RF64Header, sample_count), 48'000, 8));
+static_assert(is_serialized_like(wave_container::rf64, offsetof(wave::RF64Header, bytes_per_bloc), 6, 2));
+static_assert(is_serialized_like(wave_container::w64, offsetof(wave::Wave64Header, bloc_size), 40, 8));
+static_assert(is_serialized_like(wave_container::w64, offsetof(wave::Wave64Header, data_size), 24 + 288'000, 8));
+
+}// namespace
+
+std::vector<uint8_t> create_wave_header(const wave_format& format, uint64_t data_size)
+{
+    auto header = get_wave_header(format, data_size);
+    return {header.data(), header.data() + header.size()};
+}
+
+wave_file_layout parse_wave_header(std::span<const uint8_t> header, uint64_t file_size)
+{
+    auto get_le = [&](std::size_t offset, std::size_t size) {
+        uint64_t value{};
+        for (std::size_t i{}; i < size; ++i) {
+            value |= static_cast<uint64_t>(header[offset + i]) << (8 * i);
+        }
+        return value;
+    };
+    auto has_id = [&](std::size_t offset, const void* id, std::size_t size) {
+        return std::memcmp(header.data() + offset, id, size) == 0;
+    };
+
+    wave_file_layout layout;
+    auto& format = layout.format;
+    std::size_t format_offset{};
+    std::size_t data_chunk_offset{};
+    if (header.size() >= wave::k_w64_header_size && has_id(0, wave::k_w64_guid_riff, 16) && has_id(24, wave::k_w64_guid_wave, 16)
+        && has_id(40, wave::k_w64_guid_fmt, 16)) {
+        format.container = wave_container::w64;
+        format_offset = 64;
+        data_chunk_offset = 80;
+    } else if (header.size() >= wave::k_rf64_header_size && has_id(0, "RF64", 4) && has_id(8, "WAVE", 4) && has_id(12, "ds64", 4)
+               && has_id(48, "fmt ", 4)) {
+        format.container = wave_container::rf64;
+        format_offset = 56;
+        data_chunk_offset = 72;
+    } else if (header.size() >= wave::k_header_size && has_id(0, "RIFF", 4) && has_id(8, "WAVE", 4) && has_id(12, "fmt ", 4)) {
+        format.container = wave_container::riff;
+        format_offset = 20;
+        data_chunk_offset = 36;
+    } else {
+        throw std::invalid_argument("Invalid argument. Not a RIFF, RF64 or Wave64 header as written by wavegen.");
+    }
+
+    // a shard chunk lies in front of the data chunk
+    bool is_w64 = format.container == wave_container::w64;
+    auto shard_size = get_wave_shard_chunk_size(format.container);
+    if (header.size() >= get_wave_header_size(format.container, true)
+        && (is_w64 ? has_id(data_chunk_offset, wave::k_w64_guid_shard, 16) : has_id(data_chunk_offset, "wgsh", 4))) {
+        auto shard_offset = data_chunk_offset + (is_w64 ? wave::k_w64_chunk_header_size : 8);
+        layout.has_shard = true;
+        layout.shard = {get_le(shard_offset, 8), get_le(shard_offset + 8, 8), get_le(shard_offset + 16, 8), get_le(shard_offset + 24, 8)};
+        data_chunk_offset += shard_size;
+    }
+
+    if (!(is_w64 ? has_id(data_chunk_offset, wave::k_w64_guid_data, 16) : has_id(data_chunk_offset, "data", 4))) {
+        throw std::invalid_argument("Invalid argument. Not a RIFF, RF64 or Wave64 header as written by wavegen.");
+    }
+
+    uint64_t data_size{};
+    if (is_w64) {
+        data_size = get_le(data_chunk_offset + 16, 8) - std::min<uint64_t>(get_le(data_chunk_offset + 16, 8), wave::k_w64_chunk_header_size);
+    } else {
+        data_size = format.container == wave_container::rf64 ? get_le(28, 8) : get_le(data_chunk_offset + 4, 4);
+    }
+
+    auto audio_format = get_le(format_offset, 2);
+    if (audio_format != wave::k_audio_format_PCM && audio_format != wave::k_audio_format_IEEE_754) {
+        throw std::invalid_argument("Invalid argument. Only PCM and IEEE float audio data is supported.");
+    }
+    format.sample_format = audio_format == wave::k_audio_format_PCM ? sample_format::pcm : sample_format::ieee_float;
+    format.channel_count = static_cast<uint16_t>(get_le(format_offset + 2, 2));
+    format.sample_rate = static_cast<uint32_t>(get_le(format_offset + 4, 4));
+    format.bits_per_sample = static_cast<uint16_t>(get_le(format_offset + 14, 2));
+
+    layout.data_offset = get_wave_header_size(format.container, layout.has_shard);
+    layout.data_size = std::min(data_size, file_size - std::min<uint64_t>(file_size, layout.data_offset));
+
+    return layout;
+}
+
+uint64_t get_max_data_size(const wave_format& format, bool has_shard)
+{
+    uint64_t frame_size = static_cast<uint64_t>(format.channel_count) * format.bits_per_sample / 8;
+    uint64_t header_size = get_wave_header_size(format.container, has_shard);
+    uint64_t max_size = format.container == wave_container::riff ? UINT32_MAX - header_size + 8 : INT64_MAX - header_size;
+
+    return max_size - max_size % frame_size;
+}
+
+}// namespace wavegen
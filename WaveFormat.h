@@ -0,0 +1,276 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   The format of a Wave file, and the construction and parsing of its header.
+ */
+#ifndef WAVE_FORMAT_H_
+#define WAVE_FORMAT_H_
+
+#include <span>
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "WaveHeader.h"
+#include "SamplePacker.h"
+
+namespace wavegen
+{
+
+// The container format of a Wave file.
+enum class wave_container
+{
+    riff,       // classic RIFF/WAVE, audio data is limited to 4 GiB
+    rf64,       // RIFF with a ds64 chunk holding 64-bit sizes
+    w64         // Sony Wave64, chunks identified by GUIDs with 64-bit sizes
+};
+
+// Container and layout of the audio data of a Wave file.
+struct wave_format
+{
+    wave_container container {wave_container::riff};
+    wavegen::sample_format sample_format {wavegen::sample_format::pcm};
+    uint16_t channel_count {1};
+    uint32_t sample_rate {48'000};
+    uint16_t bits_per_sample {24};
+
+    bool operator==(const wave_format&) const = default;
+};
+
+// Which frames of a render a shard holds, and of which render, kept in a private "wgsh" chunk
+// between the format and the data chunk, so merges can check their shards belong together.
+struct wave_shard
+{
+    uint64_t first_frame {};
+    uint64_t end_frame {};          // One past the last frame of the shard
+    uint64_t frame_count {};        // Frames of the whole render
+    uint64_t render_key {};         // Hash of the settings of the render
+
+    bool operator==(const wave_shard&) const = default;
+};
+
+/**
+ * Returns the bytes of the shard chunk of a container.
+ */
+constexpr std::size_t get_wave_shard_chunk_size(wave_container container)
+{
+    return (container == wave_container::w64 ? wave::k_w64_chunk_header_size : 8) + wave::k_shard_bloc_size;
+}
+
+// The largest header of all containers, with a shard chunk
+constexpr std::size_t k_max_wave_header_size {wave::k_w64_header_size + wave::k_w64_chunk_header_size + wave::k_shard_bloc_size};
+
+// The bytes of a header, held without a heap allocation.
+struct wave_header_bytes
+{
+    std::array<uint8_t, k_max_wave_header_size> bytes {};
+    std::size_t length {};
+
+    constexpr uint8_t* data() { return bytes.data(); }
+    constexpr const uint8_t* data() const { return bytes.data(); }
+    constexpr std::size_t size() const { return length; }
+    constexpr bool empty() const { return length == 0; }
+
+    constexpr operator std::span<uint8_t>() { return {bytes.data(), length}; }
+    constexpr operator std::span<const uint8_t>() const { return {bytes.data(), length}; }
+};
+
+namespace detail
+{
+
+// Writes value to out in little endian, whatever the byte order of the host.
+template <typename Integer>
+constexpr void put_le(std::span<uint8_t> out, std::size_t offset, Integer value)
+{
+    for (std::size_t i{}; i < sizeof(Integer); ++i) {
+        out[offset + i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i));
+    }
+}
+
+template <std::size_t Size>
+constexpr void put_id(std::span<uint8_t> out, std::size_t offset, const uint8_t (&id)[Size])
+{
+    for (std::size_t i{}; i < Size; ++i) {
+        out[offset + i] = id[i];
+    }
+}
+
+template <std::size_t Size>
+constexpr void put_id(std::span<uint8_t> out, std::size_t offset, const char (&id)[Size])
+{
+    for (std::size_t i{}; i + 1 < Size; ++i) {
+        out[offset + i] = static_cast<uint8_t>(id[i]);
+    }
+}
+
+// Writes the 16 bytes of the format fields shared by all containers.
+constexpr void put_format(std::span<uint8_t> out, std::size_t offset, const wave_format& format)
+{
+    uint16_t bytes_per_bloc = static_cast<uint16_t>(format.channel_count * format.bits_per_sample / 8);
+    put_le<uint16_t>(out, offset, format.sample_format == sample_format::ieee_float ? wave::k_audio_format_IEEE_754 : wave::k_audio_format_PCM);
+    put_le<uint16_t>(out, offset + 2, format.channel_count);
+    put_le<uint32_t>(out, offset + 4, format.sample_rate);
+    put_le<uint32_t>(out, offset + 8, format.sample_rate * bytes_per_bloc);
+    put_le<uint16_t>(out, offset + 12, bytes_per_bloc);
+    put_le<uint16_t>(out, offset + 14, format.bits_per_sample);
+}
+
+// Writes the shard chunk of a container.
+constexpr void put_shard(std::span<uint8_t> out, std::size_t offset, wave_container container, const wave_shard& shard)
+{
+    if (container == wave_container::w64) {
+        put_id(out, offset, wave::k_w64_guid_shard);
+        put_le<uint64_t>(out, offset + 16, wave::k_w64_chunk_header_size + wave::k_shard_bloc_size);
+        offset += wave::k_w64_chunk_header_size;
+    } else {
+        put_id(out, offset, "wgsh");
+        put_le<uint32_t>(out, offset + 4, wave::k_shard_bloc_size);
+        offset += 8;
+    }
+    put_le<uint64_t>(out, offset, shard.first_frame);
+    put_le<uint64_t>(out, offset + 8, shard.end_frame);
+    put_le<uint64_t>(out, offset + 16, shard.frame_count);
+    put_le<uint64_t>(out, offset + 24, shard.render_key);
+}
+
+}// namespace detail
+
+/**
+ * Returns the bytes of the header of a container, with a shard chunk or without.
+ */
+constexpr std::size_t get_wave_header_size(wave_container container, bool has_shard = false)
+{
+    return (container == wave_container::rf64 ? wave::k_rf64_header_size
+            : container == wave_container::w64 ? wave::k_w64_header_size
+            : wave::k_header_size) + (has_shard ? get_wave_shard_chunk_size(container) : 0);
+}
+
+/**
+ * Patches the size fields of a header in place for data_size bytes of audio data, every other
+ * byte is left as it is. A streaming render writes its header up front and patches it once the
+ * data has been written, in its buffer or straight in the mapped file, without a second header.
+ * Throws std::overflow_error if the data does not fit the container.
+ */
+constexpr void patch_wave_header(const wave_format& format, uint64_t data_size, std::span<uint8_t> header, bool has_shard = false)
+{
+    // the shard chunk lies in front of the data chunk
+    std::size_t shard_size = has_shard ? get_wave_shard_chunk_size(format.container) : 0;
+    uint64_t header_size = get_wave_header_size(format.container, has_shard);
+
+    if (format.container == wave_container::rf64) {
+        uint64_t frame_size = static_cast<uint64_t>(format.channel_count) * format.bits_per_sample / 8;
+        detail::put_le<uint64_t>(header, 20, header_size + data_size - 8);
+        detail::put_le<uint64_t>(header, 28, data_size);
+        detail::put_le<uint64_t>(header, 36, data_size / frame_size);
+        return;
+    }
+
+    if (format.container == wave_container::w64) {
+        detail::put_le<uint64_t>(header, 16, header_size + data_size);
+        detail::put_le<uint64_t>(header, 96 + shard_size, wave::k_w64_chunk_header_size + data_size);
+        return;
+    }
+
+    if (data_size > UINT32_MAX - header_size + 8) {
+        throw std::overflow_error("File generation failed. Data size exceeds the maximum limit of RIFF, use the rf64 or w64 container.");
+    }
+    detail::put_le<uint32_t>(header, 4, static_cast<uint32_t>(header_size + data_size - 8));
+    detail::put_le<uint32_t>(header, 40 + shard_size, static_cast<uint32_t>(data_size));
+}
+
+/**
+ * Serializes the header for a Wave file holding data_size bytes of audio data into out, field by
+ * field in little endian, so neither the struct layout nor the byte order of the host matters.
+ * The header of a shard also holds its shard chunk. out must hold get_wave_header_size() bytes,
+ * it may be the start of an output buffer or of a mapped file. Returns the bytes written.
+ * Throws std::overflow_error if the data does not fit the container.
+ */
+constexpr std::size_t write_wave_header(const wave_format& format, uint64_t data_size, std::span<uint8_t> out,
+                                        const wave_shard* shard = nullptr)
+{
+    auto header = out.first(get_wave_header_size(format.container, shard != nullptr));
+    std::size_t shard_size = shard ? get_wave_shard_chunk_size(format.container) : 0;
+
+    if (format.container == wave_container::rf64) {
+        detail::put_id(header, 0, "RF64");
+        detail::put_le<uint32_t>(header, 4, wave::k_rf64_size_placeholder);
+        detail::put_id(header, 8, "WAVE");
+        detail::put_id(header, 12, "ds64");
+        detail::put_le<uint32_t>(header, 16, wave::k_ds64_bloc_size);
+        detail::put_le<uint32_t>(header, 44, 0);
+        detail::put_id(header, 48, "fmt ");
+        detail::put_le<uint32_t>(header, 52, wave::k_header_bloc_size);
+        detail::put_format(header, 56, format);
+        detail::put_id(header, 72 + shard_size, "data");
+        detail::put_le<uint32_t>(header, 76 + shard_size, wave::k_rf64_size_placeholder);
+    } else if (format.container == wave_container::w64) {
+        detail::put_id(header, 0, wave::k_w64_guid_riff);
+        detail::put_id(header, 24, wave::k_w64_guid_wave);
+        detail::put_id(header, 40, wave::k_w64_guid_fmt);
+        detail::put_le<uint64_t>(header, 56, wave::k_w64_chunk_header_size + wave::k_header_bloc_size);
+        detail::put_format(header, 64, format);
+        detail::put_id(header, 80 + shard_size, wave::k_w64_guid_data);
+    } else {
+        detail::put_id(header, 0, "RIFF");
+        detail::put_id(header, 8, "WAVE");
+        detail::put_id(header, 12, "fmt ");
+        detail::put_le<uint32_t>(header, 16, wave::k_header_bloc_size);
+        detail::put_format(header, 20, format);
+        detail::put_id(header, 36 + shard_size, "data");
+    }
+    if (shard) {
+        // in front of the data chunk
+        std::size_t shard_offset = format.container == wave_container::rf64 ? 72 : format.container == wave_container::w64 ? 80 : 36;
+        detail::put_shard(header, shard_offset, format.container, *shard);
+    }
+    patch_wave_header(format, data_size, header, shard != nullptr);
+
+    return header.size();
+}
+
+/**
+ * Returns the header for a Wave file holding data_size bytes of audio data, without allocating.
+ * Throws std::overflow_error if the data does not fit the container.
+ */
+constexpr wave_header_bytes get_wave_header(const wave_format& format, uint64_t data_size, const wave_shard* shard = nullptr)
+{
+    wave_header_bytes header;
+    header.length = write_wave_header(format, data_size, header.bytes, shard);
+    return header;
+}
+
+/**
+ * Generates the header for a Wave file holding data_size bytes of audio data. 
+ * Throws std::overflow_error if the data does not fit the container.
+ */
+std::vector<uint8_t> create_wave_header(const wave_format& format, uint64_t data_size);
+
+// Where the audio data of a Wave file lies, as described by its header.
+struct wave_file_layout
+{
+    wave_format format;
+    uint64_t data_offset {};    // Bytes of the header
+    uint64_t data_size {};      // Bytes of audio data in the file
+    bool has_shard {};          // The header holds a shard chunk
+    wave_shard shard;
+};
+
+/**
+ * Parses a header as written by write_wave_header, with its shard chunk if it has one, from the
+ * first bytes of a file of file_size bytes. The data size is limited to the bytes the file holds, so a streaming header yields the data actually written.
+ * Throws std::invalid_argument if the bytes do not start with such a header.
+ */
+wave_file_layout parse_wave_header(std::span<const uint8_t> header, uint64_t file_size);
+
+/**
+ * Returns the largest whole number of frames, in bytes, the container can hold after a header with a shard chunk or without.
+ * A header created with this size serves as the header of a stream whose length is not known,
+ * readers of pipes and sockets then simply read until the stream ends.
+ */
+uint64_t get_max_data_size(const wave_format& format, bool has_shard = false);
+
+}// namespace wavegen
+
+#endif // WAVE_FORMAT_H_
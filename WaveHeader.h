@@ -35,6 +35,66 @@ struct WaveHeader
     uint32_t data_size;             // Size of the audio data in bytes
 };
 
+#pragma pack(push, 1)
+
+// RF64 file header (80 bytes), the 64-bit extension of RIFF (EBU Tech 3306).
+// The 32-bit sizes are set to 0xFFFFFFFF, the real sizes are held by the "ds64" chunk.
+struct RF64Header
+{
+    // RF64 header
+    uint8_t  file_type_bloc_id[4];  // Identifier "RF64"
+    uint32_t file_size;             // 0xFFFFFFFF
+    uint8_t  file_format_id[4];     // Format "WAVE"
+
+    // Chunk holding the 64-bit sizes
+    uint8_t  ds64_bloc_id[4];       // Identifier "ds64"
+    uint32_t ds64_bloc_size;        // Size of the ds64 chunk (28 bytes)
+    uint64_t riff_size;             // Overall file size minus 8 bytes
+    uint64_t data_size;             // Size of the audio data in bytes
+    uint64_t sample_count;          // Number of samples per channel
+    uint32_t table_length;          // Entries of the (unused) chunk size table
+
+    // Chunk describing the data format
+    uint8_t format_bloc_id[4];      // Identifier "fmt "
+    uint32_t bloc_size;             // Size of the format chunk (16 bytes)
+    uint16_t audio_format;          // Audio format (1: PCM integer, 3: IEEE 754 float)
+    uint16_t channel_count;         // Number of channels (1: mono, 2: stereo)
+    uint32_t sample_rate;           // Sample Rate (Samples per second in hertz)
+    uint32_t bytes_per_sec;         // Number of bytes to read per second (sample_rate * bytes_per_bloc)
+    uint16_t bytes_per_bloc;        // Number of bytes per block (channel_count * bits_per_sample / 8)
+    uint16_t bits_per_sample;       // Number of bits per sample
+
+    // Chunk containing the sampled data
+    uint8_t data_bloc_id[4];        // Identifier "data"
+    uint32_t data_size_32;          // 0xFFFFFFFF
+};
+
+// Sony Wave64 file header (104 bytes).
+// Chunks are identified by GUIDs and their 64-bit sizes include the 24 bytes of the chunk header.
+struct Wave64Header
+{
+    // RIFF header
+    uint8_t  file_type_guid[16];    // GUID of "riff"
+    uint64_t file_size;             // Overall file size
+    uint8_t  file_format_guid[16];  // GUID of "wave"
+
+    // Chunk describing the data format
+    uint8_t  format_guid[16];       // GUID of "fmt "
+    uint64_t bloc_size;             // Size of the format chunk including its header (40 bytes)
+    uint16_t audio_format;          // Audio format (1: PCM integer, 3: IEEE 754 float)
+    uint16_t channel_count;         // Number of channels (1: mono, 2: stereo)
+    uint32_t sample_rate;           // Sample Rate (Samples per second in hertz)
+    uint32_t bytes_per_sec;         // Number of bytes to read per second (sample_rate * bytes_per_bloc)
+    uint16_t bytes_per_bloc;        // Number of bytes per block (channel_count * bits_per_sample / 8)
+    uint16_t bits_per_sample;       // Number of bits per sample
+
+    // Chunk containing the sampled data
+    uint8_t  data_guid[16];         // GUID of "data"
+    uint64_t data_size;             // Size of the audio data plus the 24 bytes of the chunk header
+};
+
+#pragma pack(pop)
+
 constexpr uint16_t k_header_size = sizeof(WaveHeader)/sizeof(char);
 
 constexpr uint32_t k_header_bloc_size = 0x10; // 16 bytes
@@ -45,6 +105,20 @@ constexpr uint16_t k_channel_count_stereo = 0x02; // Stereo
 constexpr uint16_t k_audio_format_PCM = 0x01; // PCM
 constexpr uint16_t k_audio_format_IEEE_754 = 0x03; // IEEE 754
 
+constexpr uint16_t k_rf64_header_size = sizeof(RF64Header);
+constexpr uint16_t k_w64_header_size = sizeof(Wave64Header);
+
+constexpr uint32_t k_ds64_bloc_size = 0x1C; // 28 bytes
+constexpr uint32_t k_rf64_size_placeholder = 0xFFFFFFFF; // Size held by the ds64 chunk
+constexpr uint64_t k_w64_chunk_header_size = 0x18; // 24 bytes, GUID and size
+constexpr uint32_t k_shard_bloc_size = 0x20; // 32 bytes, the frame range and key of a shard ("wgsh" chunk)
+
+constexpr uint8_t k_w64_guid_riff[16] = {0x72, 0x69, 0x66, 0x66, 0x2E, 0x91, 0xCF, 0x11, 0xA5, 0xD6, 0x28, 0xDB, 0x04, 0xC1, 0x00, 0x00};
+constexpr uint8_t k_w64_guid_wave[16] = {0x77, 0x61, 0x76, 0x65, 0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+constexpr uint8_t k_w64_guid_fmt[16]  = {0x66, 0x6D, 0x74, 0x20, 0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+constexpr uint8_t k_w64_guid_data[16] = {0x64, 0x61, 0x74, 0x61, 0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+constexpr uint8_t k_w64_guid_shard[16] = {0x77, 0x67, 0x73, 0x68, 0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+
 }// namespace wave
 
 #endif // WAVE_HEADER_H_
\ No newline at end of file
@@ -0,0 +1,1855 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   The wavegen library: renders Wave files to files, sinks, playback devices,
+ *          callbacks or caller-provided memory, reusing buffers and generators through a context.
+ */
+#include "WaveRender.h"
+
+#include <cmath>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <limits>
+#include <cstring>
+#include <numeric>
+#include <fstream>
+#include <sstream>
+#include <optional>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+
+#include "Resampler.h"
+#include "FlacEncoder.h"
+#include "MappedFile.h"
+#include "OutputSink.h"
+#include "RenderStats.h"
+#include "GpuGenerator.h"
+#include "AudioPlayback.h"
+#include "OscillatorBank.h"
+#include "AsyncFileWriter.h"
+
+namespace wavegen
+{
+
+namespace
+{
+
+constexpr double k_max_sample_count {9'007'199'254'740'992.0};    // 2^53 samples per channel, which generators index exactly in double precision
+
+// Produces the next block of audio data. An empty block marks the end of the data.
+using block_source = std::function<std::span<const uint8_t>()>;
+
+/**
+ * Returns the number of samples per channel of a file of the given length and sample rate.
+ */
+uint64_t get_sample_count(double file_length_sec, uint32_t sample_rate)
+{
+    return static_cast<uint64_t>(sample_rate * file_length_sec);
+}
+
+// The frames [first, end) of a render.
+struct frame_range
+{
+    uint64_t first;
+    uint64_t end;
+
+    uint64_t size() const { return end - first; }
+};
+
+/**
+ * Returns the frames of a file of the given length a render writes.
+ */
+frame_range get_frame_range(double file_length_sec, const render_options& options)
+{
+    auto sample_count = get_sample_count(file_length_sec, options.sample_rate);
+    auto end = options.end_frame == 0 ? sample_count : std::min(options.end_frame, sample_count);
+    return {std::min(options.first_frame, end), end};
+}
+
+/**
+ * Returns the bits per sample of the sample format of a render.
+ */
+uint16_t get_bits_per_sample(const render_options& options)
+{
+    return options.sample_format == sample_format::ieee_float ? 32 : k_bits_per_sample;
+}
+
+/**
+ * Returns the bytes of one frame, i.e. one sample of every channel.
+ */
+uint32_t get_frame_size(const render_options& options)
+{
+    return options.channel_count * get_bits_per_sample(options) / 8u;
+}
+
+/**
+ * Returns the format of the file of a render.
+ */
+wave_format get_wave_format(const render_options& options)
+{
+    return {options.container, options.sample_format, options.channel_count, options.sample_rate, get_bits_per_sample(options)};
+}
+
+/**
+ * True if the render sweeps its frequency or follows an envelope.
+ */
+bool is_modulated(const render_options& options)
+{
+    return options.sweep != sweep_shape::none || !options.envelope.empty();
+}
+
+/**
+ * Creates the generator of the samples of a single channel.
+ * With more than one harmonic, the partials k * wave_frequency (up to half of the sample rate)
+ * are summed with amplitudes falling off as 1/k, scaled so that the sum stays within k_amplitude.
+ * Sweeps, envelopes and fractional frequencies are rendered by a sweep generator, which always uses
+ * the polynomial kernel. Square, saw and triangle waves are rendered band-limited by a waveform generator.
+ */
+channel_source create_channel_source(const frequency_sweep& sweep, const render_options& options)
+{
+    double wave_frequency = sweep.start_frequency;
+    // dithered samples keep a fraction, which the dither source rounds away
+    uint32_t amplitude = options.dither == dither_mode::none ? k_amplitude : k_amplitude << k_dither_fraction_bits;
+    if (options.waveform != waveform::sine) {
+        if (is_modulated(options) || options.harmonic_count > 1) {
+            throw std::invalid_argument("Invalid argument. Square, saw and triangle waves are rendered without sweeps, envelopes or harmonics.");
+        }
+
+        auto generator = std::make_shared<const waveform_generator>(amplitude, options.waveform, wave_frequency, options.sample_rate);
+        return [generator](std::span<int32_t> samples, uint64_t first_index) {
+            generator->generate(samples, first_index);
+        };
+    }
+
+    if (options.harmonic_count > 1) {
+        if (is_modulated(options)) {
+            throw std::invalid_argument("Invalid argument. Sweeps and envelopes are rendered without harmonics.");
+        }
+
+        uint32_t partial_count = std::max(1u, std::min(options.harmonic_count, 
+                                                       static_cast<uint32_t>(options.sample_rate / 2 / std::max(1.0, wave_frequency))));
+
+        double amplitude_sum {};
+        for (uint32_t harmonic{1}; harmonic <= partial_count; ++harmonic) {
+            amplitude_sum += 1.0 / harmonic;
+        }
+
+        auto bank = std::make_shared<oscillator_bank>(options.sample_rate);
+        for (uint32_t harmonic{1}; harmonic <= partial_count; ++harmonic) {
+            bank->add_partial(static_cast<double>(harmonic) * wave_frequency, amplitude / (harmonic * amplitude_sum));
+        }
+
+        return [bank](std::span<int32_t> samples, uint64_t first_index) {
+            bank->generate(samples, first_index);
+        };
+    }
+
+    if (is_modulated(options) || wave_frequency != std::floor(wave_frequency)) {
+        auto generator = std::make_shared<const sweep_generator>(amplitude, sweep, options.envelope, options.sample_rate);
+        return [generator](std::span<int32_t> samples, uint64_t first_index) {
+            generator->generate(samples, first_index);
+        };
+    }
+
+    sine_wave_generator generator(amplitude, static_cast<uint32_t>(wave_frequency), options.sample_rate, options.oscillator);
+    return [generator](std::span<int32_t> samples, uint64_t first_index) mutable {
+        generator.generate(samples, first_index);
+    };
+}
+
+/**
+ * Returns a source rounding the samples of source, generated with k_dither_fraction_bits bits
+ * of fraction, to whole samples with the dither of the given channel.
+ * The noise shaping starts over at multiples of k_dither_shaping_span, a block starting in between
+ * first regenerates the samples since then, so the error feedback does not depend on the blocks.
+ * The source keeps the error feedback after its last block, so a later block of the same span only
+ * regenerates the samples in between, and a block continuing the last one none at all.
+ */
+channel_source create_dither_source(channel_source source, dither_mode mode, uint16_t channel)
+{
+    if (mode == dither_mode::tpdf) {
+        auto kernel = best_dither_kernel();
+        return [source = std::move(source), kernel, channel](std::span<int32_t> samples, uint64_t first_index) {
+            source(samples, first_index);
+            kernel(samples.data(), samples.size(), channel, first_index, samples.data());
+        };
+    }
+
+    return [source = std::move(source), channel, state = noise_shaper_state(), next_index = uint64_t{},
+            lead_in = std::vector<int32_t>()](std::span<int32_t> samples, uint64_t first_index) mutable {
+        // the state after sample next_index - 1 only carries on within its span
+        auto span_start = first_index - first_index % k_dither_shaping_span;
+        if (next_index > first_index || next_index < span_start) {
+            state = {};
+            next_index = span_start;
+        }
+
+        // the lead-in is regenerated in pieces of the block size
+        while (next_index < first_index) {
+            lead_in.resize(static_cast<std::size_t>(std::min<uint64_t>(first_index - next_index, std::max<std::size_t>(samples.size(), 1))));
+            source(lead_in, next_index);
+            shape_noise(lead_in.data(), lead_in.size(), channel, next_index, lead_in.data(), state);
+            next_index += lead_in.size();
+        }
+
+        source(samples, first_index);
+        shape_noise(samples.data(), samples.size(), channel, first_index, samples.data(), state);
+        next_index = first_index + samples.size();
+    };
+}
+
+/**
+ * Returns the wave frequency of the given channel.
+ */
+double get_channel_frequency(double wave_frequency, const render_options& options, uint16_t channel)
+{
+    return wave_frequency + channel * options.channel_step;
+}
+
+/**
+ * Returns the sweep of the given channel, from its wave frequency to the end frequency plus its channel step.
+ */
+frequency_sweep get_channel_sweep(double wave_frequency, const render_options& options, uint16_t channel)
+{
+    return {get_channel_frequency(wave_frequency, options, channel), get_channel_frequency(options.sweep_end_frequency, options, channel),
+            options.sweep_duration_sec, options.sweep};
+}
+
+/**
+ * True if a render is a range of the frames of its file, a shard, whose header records the range.
+ */
+bool is_shard(const render_options& options)
+{
+    return options.first_frame != 0 || options.end_frame != 0;
+}
+
+/**
+ * Returns the key of a render in the render cache: every setting the bytes of a file depend on,
+ * except for its length, which only goes into the header of a shard. Floating point values are
+ * written in hex, so they round trip exactly. The version goes up whenever a generator changes its output.
+ */
+std::string get_cache_key(double wave_frequency, double file_length_sec, const render_options& options)
+{
+    std::ostringstream key;
+    key << std::hexfloat << "wavegen-1 rate=" << options.sample_rate << " amplitude=" << k_amplitude << " frequency=" << wave_frequency
+        << " oscillator=" << static_cast<int>(options.oscillator) << " container=" << static_cast<int>(options.container)
+        << " format=" << static_cast<int>(options.sample_format) << " bits=" << get_bits_per_sample(options)
+        << " channels=" << options.channel_count << " step=" << options.channel_step << " header=" << static_cast<int>(options.header)
+        << " period_table=" << options.period_table << " harmonics=" << options.harmonic_count
+        << " waveform=" << static_cast<int>(options.waveform) << " sweep=" << static_cast<int>(options.sweep);
+
+    if (options.dither != dither_mode::none) {
+        key << " dither=" << static_cast<int>(options.dither);
+    }
+    // a shard is cached like a file starting at its first frame, shorter shards are prefixes of longer ones
+    if (options.first_frame != 0) {
+        key << " first_frame=" << options.first_frame;
+    }
+    if (is_shard(options)) {
+        key << " shard_of=" << get_sample_count(file_length_sec, options.sample_rate);
+    }
+    if (options.sweep != sweep_shape::none) {
+        key << " sweep_to=" << options.sweep_end_frequency << " sweep_time=" << options.sweep_duration_sec;
+    }
+    for (const auto& point : options.envelope) {
+        key << " envelope=" << point.time_sec << ':' << point.gain;
+    }
+
+    return key.str();
+}
+
+/**
+ * Creates the generator and packer of the audio frames. Every call returns an independent writer,
+ * so each worker can own one.
+ * Every channel has its own generator, identical channels (a channel step of 0) share one and are
+ * generated once, unless they are dithered with noise of their own.
+ * Common output configurations get a writer specialized at compile time.
+ */
+frame_writer create_frame_writer(double wave_frequency, const render_options& options)
+{
+    bool same_channels = options.channel_step == 0.0 && options.dither == dither_mode::none;
+    std::vector<channel_source> channel_sources;
+    for (uint16_t channel{}; channel < (same_channels ? 1 : options.channel_count); ++channel) {
+        auto source = create_channel_source(get_channel_sweep(wave_frequency, options, channel), options);
+        if (options.dither != dither_mode::none) {
+            source = create_dither_source(std::move(source), options.dither, channel);
+        }
+        channel_sources.push_back(std::move(source));
+    }
+
+    return make_frame_writer(options.sample_format, get_bits_per_sample(options), options.channel_count, std::move(channel_sources));
+}
+
+/**
+ * True if the generators of two renders produce the same samples for the same wave frequency.
+ */
+bool is_same_generator(const render_options& a, const render_options& b)
+{
+    return a.oscillator == b.oscillator && a.sample_format == b.sample_format && a.channel_count == b.channel_count
+        && a.channel_step == b.channel_step && a.harmonic_count == b.harmonic_count && a.waveform == b.waveform
+        && a.sweep == b.sweep && a.sweep_end_frequency == b.sweep_end_frequency && a.sweep_duration_sec == b.sweep_duration_sec
+        && a.envelope == b.envelope && a.dither == b.dither && a.sample_rate == b.sample_rate;
+}
+
+/**
+ * Creates the period table of a wave if enabled in the options, nullptr otherwise.
+ * Tables are kept in the context and reused by later renders of the same frequency.
+ */
+std::shared_ptr<const period_table> create_period_table(double wave_frequency, const render_options& options, render_context& context)
+{
+    if (!options.period_table) {
+        return nullptr;
+    }
+
+    if (is_modulated(options) || wave_frequency != std::floor(wave_frequency) || options.channel_step != std::floor(options.channel_step)) {
+        throw std::invalid_argument("Invalid argument. A period table needs constant integer frequencies.");
+    }
+
+    if (options.dither != dither_mode::none) {
+        throw std::invalid_argument("Invalid argument. Dither noise does not repeat, it cannot be rendered from a period table.");
+    }
+
+    auto& table = context.get_period_table(wave_frequency, options);
+    if (!table) {
+        WAVEGEN_STATS_SCOPE(stats_stage::period_table);
+
+        // the frames repeat once every channel has completed a whole number of periods
+        uint32_t period_frame_count {1};
+        for (uint16_t channel{}; channel < options.channel_count; ++channel) {
+            auto channel_frequency = static_cast<uint32_t>(get_channel_frequency(wave_frequency, options, channel));
+            period_frame_count = std::lcm(period_frame_count, period_sample_count(channel_frequency, options.sample_rate));
+        }
+
+        std::vector<uint8_t> period(static_cast<std::size_t>(period_frame_count) * get_frame_size(options));
+        std::vector<int32_t> scratch;
+        create_frame_writer(wave_frequency, options)(0, period_frame_count, period.data(), scratch);
+
+        table = std::make_shared<const period_table>(period, get_frame_size(options));
+    }
+
+    return table;
+}
+
+/**
+ * Generates the audio data of a Wave file block by block, rotating through buffer_count buffers
+ * of the context. A block therefore stays valid until buffer_count more blocks have been
+ * generated, and memory use does not depend on the file length. The buffers are only ever grown.
+ * Writers get it through std::ref, so handing it over does not allocate.
+ */
+class block_generator
+{
+public:
+    block_generator(double wave_frequency, double file_length_sec, const render_options& options, render_context& context,
+                    unsigned buffer_count = 1)
+        : m_context(context)
+        , m_pool(context.get_pool(options.thread_count, options.pin_threads))
+        , m_frame_writers(context.get_frame_writers(wave_frequency, options, m_pool.size()))
+        , m_table(create_period_table(wave_frequency, options, context))
+        // every worker generates and packs its own disjoint part of a block, using its own generator
+        , m_block_sample_count(options.block_sample_count * m_pool.size())
+        , m_end_index(get_frame_range(file_length_sec, options).end)
+        , m_frame_size(get_frame_size(options))
+        , m_channel_count(options.channel_count)
+        , m_buffer_count(buffer_count)
+        , m_sample_index(get_frame_range(file_length_sec, options).first)
+    {
+        auto& blocks = m_context.blocks;
+        blocks.resize(std::max<std::size_t>(blocks.size(), buffer_count));
+        auto block_size = static_cast<std::size_t>(m_block_sample_count) * m_frame_size;
+        for (auto& block : blocks) {
+            // a new buffer is first written by the workers, so each part of it gets allocated on its worker's node
+            if (block.size() < block_size) {
+                block = page_buffer(block_size, options.pin_threads ? m_pool.size() : 1);
+            }
+        }
+        m_context.samples.resize(std::max<std::size_t>(m_context.samples.size(), m_pool.size()));
+    }
+
+    // Returns the next block, empty once all audio data has been generated.
+    std::span<const uint8_t> operator()()
+    {
+        WAVEGEN_STATS_SCOPE(stats_stage::generate);
+
+        auto block_size = static_cast<uint32_t>(std::min<uint64_t>(m_block_sample_count, m_end_index - m_sample_index));
+        auto& block = m_context.blocks[m_buffer_index];
+        m_buffer_index = (m_buffer_index + 1) % m_buffer_count;
+        WAVEGEN_STATS_COUNT(stats_counter::samples, static_cast<uint64_t>(block_size) * m_channel_count);
+
+        if (m_table) {
+            m_table->fill(m_sample_index, block_size, block.data());
+        } else {
+            auto write_range = [&](unsigned worker_index, std::size_t begin, std::size_t end) {
+                m_frame_writers[worker_index](m_sample_index + begin, end - begin, block.data() + begin * m_frame_size,
+                                              m_context.samples[worker_index]);
+            };
+            m_pool.for_each_range(block_size, std::cref(write_range));
+        }
+        m_sample_index += block_size;
+
+        return {block.data(), static_cast<std::size_t>(block_size) * m_frame_size};
+    }
+
+private:
+    render_context& m_context;
+    thread_pool& m_pool;
+    std::vector<frame_writer>& m_frame_writers;
+    std::shared_ptr<const period_table> m_table;
+    uint32_t m_block_sample_count;
+    uint64_t m_end_index;
+    uint32_t m_frame_size;
+    uint16_t m_channel_count;
+    unsigned m_buffer_count;
+    uint64_t m_sample_index;
+    unsigned m_buffer_index {};
+};
+
+/**
+ * Encodes the blocks of a block_generator into a FLAC stream on the workers of the render, see
+ * FlacEncoder.h. The header of the stream comes first, then the frames completed by every block;
+ * a block is only returned once it holds frames, the last one once all frames have been encoded.
+ * Writers get it through std::ref like the block_generator.
+ */
+class flac_block_source
+{
+public:
+    flac_block_source(double wave_frequency, double file_length_sec, const render_options& options, render_context& context)
+        : m_samples(wave_frequency, file_length_sec, options, context)
+        , m_encoder(get_wave_format(options), options.header == header_mode::exact ? get_frame_range(file_length_sec, options).size() : 0,
+                    context.get_pool(options.thread_count, options.pin_threads))
+    {
+    }
+
+    // Returns the next block, empty once the stream has been encoded.
+    std::span<const uint8_t> operator()()
+    {
+        if (!m_header_returned) {
+            m_header_returned = true;
+            return m_encoder.header();
+        }
+
+        while (!m_finished) {
+            auto block = m_samples();
+
+            WAVEGEN_STATS_SCOPE(stats_stage::encode);
+            m_finished = block.empty();
+            auto frames = m_finished ? m_encoder.finish() : m_encoder.encode(block);
+            if (!frames.empty()) {
+                return frames;
+            }
+        }
+
+        return {};
+    }
+
+private:
+    block_generator m_samples;
+    flac_encoder m_encoder;
+    bool m_header_returned {};
+    bool m_finished {};
+};
+
+/**
+ * Generates data for a Wave file straight into the given memory, e.g. a mapped file.
+ * Every worker generates its own disjoint range of samples, block by block.
+ * data receives the frames of the range of the options, starting with its first one.
+ */
+void create_wave_data(double wave_frequency, double file_length_sec, const render_options& options, render_context& context,
+                      uint8_t* data)
+{
+    WAVEGEN_STATS_SCOPE(stats_stage::generate);
+
+    auto& pool = context.get_pool(options.thread_count, options.pin_threads);
+    auto& frame_writers = context.get_frame_writers(wave_frequency, options, pool.size());
+    auto frame_size = get_frame_size(options);
+    auto range = get_frame_range(file_length_sec, options);
+    auto table = create_period_table(wave_frequency, options, context);
+    WAVEGEN_STATS_COUNT(stats_counter::samples, static_cast<uint64_t>(range.size()) * options.channel_count);
+
+    context.samples.resize(std::max<std::size_t>(context.samples.size(), pool.size()));
+
+    auto write_range = [&](unsigned worker_index, std::size_t begin, std::size_t end) {
+        if (table) {
+            table->fill(range.first + begin, end - begin, data + begin * frame_size);
+            return;
+        }
+
+        for (auto offset = begin; offset < end; offset += options.block_sample_count) {
+            std::size_t block_size = std::min<std::size_t>(options.block_sample_count, end - offset);
+            frame_writers[worker_index](range.first + offset, block_size, data + offset * frame_size,
+                                        context.samples[worker_index]);
+        }
+    };
+    pool.for_each_range(range.size(), std::cref(write_range));
+}
+
+/**
+ * The header of a render, serialized into the output or into a buffer on the stack.
+ * A raw render has an empty header, a streaming one always holds the maximum sizes of the container.
+ */
+struct render_header
+{
+    wave_format format;
+    header_mode mode {header_mode::exact};
+    std::optional<wave_shard> shard {};     // The frames of a shard, none for a whole file
+
+    std::size_t size() const
+    {
+        return mode == header_mode::raw ? 0 : get_wave_header_size(format.container, shard.has_value());
+    }
+
+    // Serializes the header of data_size bytes of audio data into out, which must hold size() bytes.
+    void write(uint64_t data_size, std::span<uint8_t> out) const
+    {
+        WAVEGEN_STATS_SCOPE(stats_stage::header);
+        if (mode != header_mode::raw) {
+            write_wave_header(format, mode == header_mode::streaming ? get_max_data_size(format, shard.has_value()) : data_size, out,
+                              shard ? &*shard : nullptr);
+        }
+    }
+
+    wave_header_bytes get(uint64_t data_size) const
+    {
+        wave_header_bytes header;
+        header.length = size();
+        write(data_size, header);
+        return header;
+    }
+
+    // Patches the sizes of a header written before the data size was known.
+    void patch(uint64_t data_size, std::span<uint8_t> header) const
+    {
+        if (mode == header_mode::exact) {
+            patch_wave_header(format, data_size, header, shard.has_value());
+        }
+    }
+};
+
+/**
+ * Returns the header of a render, recording the range of a shard and the key of its render:
+ * the hash of the cache key of the whole file, which is the same for all of its shards on every host
+ * whatever their header modes, since a merge writes a header of its own.
+ */
+render_header get_render_header(double wave_frequency, double file_length_sec, const render_options& options)
+{
+    render_header header {get_wave_format(options), options.header};
+    if (is_shard(options)) {
+        render_options whole_file = options;
+        whole_file.first_frame = whole_file.end_frame = 0;
+        whole_file.header = header_mode::exact;
+
+        auto range = get_frame_range(file_length_sec, options);
+        header.shard = wave_shard {range.first, range.end, get_sample_count(file_length_sec, options.sample_rate),
+                                   hash_render_key(get_cache_key(wave_frequency, file_length_sec, whole_file))};
+    }
+    return header;
+}
+
+/**
+ * Writes header and audio data to a given file.
+ * Audio data is streamed block by block, each block is written as soon as it is generated.
+ * The header is patched with the size of the data written at the end.
+ */
+render_timing write_to_file(const render_header& header, const block_source& next_block, const std::string& file_path)
+{
+    render_timing timing{};
+    std::ofstream file(file_path, std::fstream::binary);
+
+    if (!file.is_open()) {
+        throw std::ofstream::failure("File generation failed. Failed to open file " + file_path);
+    }
+
+    try {
+        auto header_bytes = header.get(0);
+        if(file.write((const char*)header_bytes.data(), header_bytes.size()).fail()) {
+            throw std::ofstream::failure("File generation failed. Failed to write header data to file.");
+        }
+        WAVEGEN_STATS_COUNT(stats_counter::bytes_written, header_bytes.size());
+
+        uint64_t data_size{};
+        for (;;) {
+            auto start = std::chrono::steady_clock::now();
+            auto block = next_block();
+            timing.compute_sec += seconds_since(start);
+            if (block.empty()) {
+                break;
+            }
+
+            start = std::chrono::steady_clock::now();
+            {
+                WAVEGEN_STATS_SCOPE(stats_stage::write);
+                if (file.write((const char*)block.data(), block.size()).fail()) {
+                    throw std::ofstream::failure("File generation failed. Failed to write audio data to file.");
+                }
+            }
+            data_size += block.size();
+            timing.io_wait_sec += seconds_since(start);
+            WAVEGEN_STATS_COUNT(stats_counter::bytes_written, block.size());
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        header.patch(data_size, header_bytes);
+        if (file.seekp(0).write((const char*)header_bytes.data(), header_bytes.size()).fail()) {
+            throw std::ofstream::failure("File generation failed. Failed to patch header data of file.");
+        }
+        timing.io_wait_sec += seconds_since(start);
+    } catch (...) {
+        file.close(); // ensure file is closed on exception
+        throw;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        WAVEGEN_STATS_SCOPE(stats_stage::write);
+        file.close();
+    }
+    timing.io_wait_sec += seconds_since(start);
+
+    return timing;
+}
+
+/**
+ * Writes header and audio data to a given file through a memory mapping.
+ * The file is pre-sized, the header is serialized and fill_data generates the audio data straight into the mapped pages.
+ */
+render_timing write_to_mapped_file(const render_header& header, uint64_t data_size, const std::function<void(uint8_t*)>& fill_data, 
+                                   const std::string& file_path)
+{
+    render_timing timing{};
+    mapped_file file(file_path, header.size() + data_size);
+
+    auto start = std::chrono::steady_clock::now();
+    header.write(data_size, {file.data(), header.size()});
+    fill_data(file.data() + header.size());
+    timing.compute_sec = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    {
+        WAVEGEN_STATS_SCOPE(stats_stage::write);
+        file.close();
+    }
+    timing.io_wait_sec = seconds_since(start);
+    WAVEGEN_STATS_COUNT(stats_counter::bytes_written, header.size() + data_size);
+
+    return timing;
+}
+
+/**
+ * Writes header and audio data to a given file with asynchronous I/O.
+ * next_block has to rotate through buffer_count buffers: while a block is being written, 
+ * the following ones are generated into the other buffers.
+ */
+render_timing write_to_file_async(const render_header& header, const block_source& next_block, unsigned buffer_count, 
+                                  const std::string& file_path)
+{
+    render_timing timing{};
+
+    // one slot per buffer, plus one for the header
+    async_file_writer file(file_path, buffer_count + 1);
+    // a raw render has no header to write
+    auto header_bytes = header.get(0);
+    if (!header_bytes.empty()) {
+        file.write(buffer_count, header_bytes.data(), header_bytes.size(), 0);
+    }
+
+    uint64_t offset = header_bytes.size();
+    for (unsigned slot{};; slot = (slot + 1) % buffer_count) {
+        // the buffer of this slot gets overwritten by the next block
+        auto start = std::chrono::steady_clock::now();
+        {
+            WAVEGEN_STATS_SCOPE(stats_stage::write);
+            file.wait(slot);
+        }
+        timing.io_wait_sec += seconds_since(start);
+
+        start = std::chrono::steady_clock::now();
+        auto block = next_block();
+        timing.compute_sec += seconds_since(start);
+        if (block.empty()) {
+            break;
+        }
+
+        file.write(slot, block.data(), block.size(), offset);
+        offset += block.size();
+    }
+
+    // patch the header with the size of the data written
+    auto start = std::chrono::steady_clock::now();
+    {
+        WAVEGEN_STATS_SCOPE(stats_stage::write);
+        file.wait(buffer_count);
+        header.patch(offset - header_bytes.size(), header_bytes);
+        if (!header_bytes.empty()) {
+            file.write(buffer_count, header_bytes.data(), header_bytes.size(), 0);
+        }
+        file.close();
+    }
+    timing.io_wait_sec += seconds_since(start);
+    WAVEGEN_STATS_COUNT(stats_counter::bytes_written, offset);
+
+    return timing;
+}
+
+/**
+ * Passes header and audio data on to a callback, every block as soon as it is ready.
+ * The time to the first block is measured from start.
+ */
+render_timing write_to_callback(std::span<const uint8_t> header, const block_source& next_block, const output_callback& write_output,
+                                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now())
+{
+    render_timing timing{};
+
+    write_output(header);
+    WAVEGEN_STATS_COUNT(stats_counter::bytes_written, header.size());
+
+    for (;;) {
+        auto block_start = std::chrono::steady_clock::now();
+        auto block = next_block();
+        timing.compute_sec += seconds_since(block_start);
+        if (block.empty()) {
+            break;
+        }
+
+        block_start = std::chrono::steady_clock::now();
+        {
+            WAVEGEN_STATS_SCOPE(stats_stage::write);
+            write_output(block);
+        }
+        timing.io_wait_sec += seconds_since(block_start);
+        if (timing.first_block_sec < 0.0) {
+            timing.first_block_sec = seconds_since(start);
+        }
+        WAVEGEN_STATS_COUNT(stats_counter::bytes_written, block.size());
+    }
+
+    return timing;
+}
+
+/**
+ * Writes header and audio data to a sink: stdout, a named pipe or a TCP connection.
+ * A sink cannot seek, so the header is final and written before the first block is generated,
+ * and every block is passed on as soon as it is ready.
+ */
+render_timing write_to_sink(const render_header& header, uint64_t data_size, const block_source& next_block,
+                            const std::string& target)
+{
+    auto start = std::chrono::steady_clock::now();
+    output_sink sink(target);
+
+    auto timing = write_to_callback(header.get(data_size), next_block, [&sink](std::span<const uint8_t> data) {
+        sink.write(data.data(), data.size());
+    }, start);
+
+    sink.close();
+
+    return timing;
+}
+
+/**
+ * Plays audio data on a device instead of writing it.
+ * This thread generates blocks into a lock-free ring buffer holding a few device buffers, the audio
+ * callback of the device copies them out of it. Playback starts once the ring has been filled.
+ */
+render_timing play_on_device(const block_source& next_block, const wave_format& format, const render_options& options)
+{
+    render_timing timing{};
+    uint32_t frame_size = format.channel_count * format.bits_per_sample / 8u;
+    auto latency_frames = std::max<std::size_t>(1, static_cast<std::size_t>(format.sample_rate * options.playback_latency_sec));
+
+    spsc_ring_buffer<uint8_t> ring(4 * latency_frames * frame_size);
+    audio_playback device(options.playback_device, format, options.playback_latency_sec, ring);
+    auto poll_interval = std::chrono::duration<double>(options.playback_latency_sec / 4);
+
+    bool started{};
+    for (;;) {
+        auto start = std::chrono::steady_clock::now();
+        auto block = next_block();
+        timing.compute_sec += seconds_since(start);
+        if (block.empty()) {
+            break;
+        }
+
+        // hands the block over in pieces of one device buffer, waiting while the ring is full
+        start = std::chrono::steady_clock::now();
+        {
+            WAVEGEN_STATS_SCOPE(stats_stage::write);
+            for (std::size_t offset{}; offset < block.size();) {
+                auto size = std::min<std::size_t>(latency_frames * frame_size, block.size() - offset);
+                while (!ring.try_write(block.data() + offset, size)) {
+                    if (!started) {
+                        device.start();
+                        started = true;
+                    } else if (device.failed()) {
+                        device.finish();
+                    } else {
+                        std::this_thread::sleep_for(poll_interval);
+                    }
+                }
+                offset += size;
+            }
+        }
+        timing.io_wait_sec += seconds_since(start);
+        WAVEGEN_STATS_COUNT(stats_counter::bytes_written, block.size());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        WAVEGEN_STATS_SCOPE(stats_stage::write);
+        device.finish();
+    }
+    timing.io_wait_sec += seconds_since(start);
+    timing.underrun_count = device.underrun_count();
+
+    return timing;
+}
+
+/**
+ * Writes a cached render holding at least data_size bytes of audio data to a file or a sink.
+ * A render of the same length is linked into place (or sent to the sink as it is), a longer one
+ * gets a new header and is cut after data_size bytes, the kernel copying the data either way.
+ */
+render_timing write_cached_render(const cached_render& render, const render_header& header, uint64_t data_size,
+                                  const std::string& target)
+{
+    render_timing timing{};
+    timing.cache_hit = true;
+    auto start = std::chrono::steady_clock::now();
+    {
+        WAVEGEN_STATS_SCOPE(stats_stage::write);
+        bool whole_file = render.data_size == data_size;
+        auto header_bytes = whole_file ? wave_header_bytes{} : header.get(data_size);
+
+        if (is_sink_target(target)) {
+            output_sink sink(target);
+            sink.write(header_bytes.data(), header_bytes.size());
+            sink.write_file(render.path.string(), whole_file ? 0 : render.data_offset, (whole_file ? render.data_offset : 0) + data_size);
+            timing.first_block_sec = seconds_since(start);
+            sink.close();
+        } else if (whole_file) {
+            link_file(render.path, target);
+        } else {
+            write_file_slice(target, header_bytes, render.path, render.data_offset, data_size);
+        }
+        WAVEGEN_STATS_COUNT(stats_counter::bytes_written, (whole_file ? render.data_offset : header_bytes.size()) + data_size);
+    }
+    timing.io_wait_sec = seconds_since(start);
+
+    WAVEGEN_STATS_COUNT(stats_counter::files, 1);
+    return timing;
+}
+
+/**
+ * Returns the highest frequency of the fundamentals of a render, over its channels and its sweep.
+ */
+double get_highest_frequency(double wave_frequency, const render_options& options)
+{
+    return get_channel_frequency(std::max(wave_frequency, options.sweep != sweep_shape::none ? options.sweep_end_frequency : 0.0),
+                                 options, options.channel_count - 1);
+}
+
+/**
+ * Throws std::invalid_argument (or std::overflow_error for a file too long) if a render cannot be made.
+ */
+void validate_render(double wave_frequency, double file_length_sec, const render_options& options)
+{
+    if (file_length_sec <= 0.0) {
+        throw std::invalid_argument("Invalid argument. File length should be greater than 0.");
+    }
+
+    if (options.channel_count == 0) {
+        throw std::invalid_argument("Invalid argument. Channel count should be greater than 0.");
+    }
+
+    if (options.block_sample_count == 0) {
+        throw std::invalid_argument("Invalid argument. Block size should be greater than 0.");
+    }
+
+    if (options.sample_rate == 0 || options.sample_rate > k_max_sample_rate) {
+        throw std::invalid_argument("Invalid argument. Sample rate should be between 1 Hz and 768 kHz.");
+    }
+
+    if (get_frame_size(options) > UINT16_MAX) {
+        throw std::invalid_argument("Invalid argument. Too many channels, a frame should not exceed 65535 bytes.");
+    }
+
+    if (!(wave_frequency >= 0.0) || !(options.channel_step >= 0.0)) {
+        throw std::invalid_argument("Invalid argument. Wave frequency and channel step should not be negative.");
+    }
+
+    if (get_highest_frequency(wave_frequency, options) > options.sample_rate/2.0) {
+        throw std::invalid_argument("Invalid argument. Wave frequency should be less than or equal to half of the sample rate.");
+    }
+
+    if (options.sample_rate * file_length_sec >= k_max_sample_count) {
+        throw std::overflow_error("File generation failed. File length exceeds the maximum limit.");
+    }
+
+    // a file shorter than a sample is written empty, a range is only checked when one was given
+    auto sample_count = get_sample_count(file_length_sec, options.sample_rate);
+    auto end_frame = options.end_frame == 0 ? sample_count : options.end_frame;
+    if (is_shard(options) && (options.first_frame >= end_frame || end_frame > sample_count)) {
+        throw std::invalid_argument("Invalid argument. The frame range should be a non-empty part of the frames of the file.");
+    }
+
+    if (options.encoding == output_encoding::flac) {
+        if (options.sample_format != sample_format::pcm || options.channel_count > k_flac_max_channel_count) {
+            throw std::invalid_argument("Invalid argument. FLAC encodes 24 bit PCM of 1 to 8 channels.");
+        }
+        if (options.header == header_mode::raw) {
+            throw std::invalid_argument("Invalid argument. A FLAC stream starts with its header, it cannot be raw.");
+        }
+        if (options.writer != output_writer::stream || options.cache || !options.playback_device.empty()) {
+            throw std::invalid_argument("Invalid argument. FLAC is written with the stream writer, it is neither cached nor played.");
+        }
+    }
+}
+
+/**
+ * Throws std::invalid_argument for a FLAC render, whose size is only known once it has been encoded.
+ */
+void check_known_size(const render_options& options)
+{
+    if (options.encoding != output_encoding::wave) {
+        throw std::invalid_argument("Invalid argument. The size of a FLAC render is only known once it has been encoded.");
+    }
+}
+
+/**
+ * Returns the options of a render of the given length: a sweep without a duration lasts as long as the file.
+ * The options are only copied (into resolved) if the sweep needs its duration.
+ */
+const render_options& resolve_options(const render_options& options, double file_length_sec, render_options& resolved)
+{
+    if (options.sweep == sweep_shape::none || options.sweep_duration_sec > 0.0) {
+        return options;
+    }
+
+    resolved = options;
+    resolved.sweep_duration_sec = file_length_sec;
+    return resolved;
+}
+
+/**
+ * The channels of a render at its own sample rate, generated block by block into buffers which
+ * keep the samples the files derived from them still need. Samples outside of the file are zero.
+ */
+class master_stream
+{
+public:
+    master_stream(double wave_frequency, const render_options& options, uint64_t sample_count)
+        : m_sample_count(static_cast<int64_t>(sample_count))
+    {
+        // identical channels are generated once, the files dither every channel on its own
+        uint16_t source_count = options.channel_step == 0.0 ? 1 : options.channel_count;
+        for (uint16_t channel{}; channel < source_count; ++channel) {
+            m_sources.push_back(create_channel_source(get_channel_sweep(wave_frequency, options, channel), options));
+        }
+        m_samples.resize(source_count);
+    }
+
+    int64_t end() const { return m_end; }
+
+    // Starts the stream at first_index, negative to start before the file.
+    void start(int64_t first_index)
+    {
+        m_first = first_index;
+        m_end = first_index;
+    }
+
+    // Generates the next count samples of every channel, the channels spread over the workers.
+    void extend(std::size_t count, thread_pool& pool)
+    {
+        auto first = std::clamp<int64_t>(m_end, 0, m_sample_count);
+        auto last = std::clamp<int64_t>(m_end + static_cast<int64_t>(count), 0, m_sample_count);
+
+        auto write_range = [&](unsigned, std::size_t begin, std::size_t end) {
+            for (auto source = begin; source < end; ++source) {
+                auto& samples = m_samples[source];
+                samples.resize(samples.size() + count);
+                if (first < last) {
+                    m_sources[source]({samples.data() + (first - m_first), static_cast<std::size_t>(last - first)}, static_cast<uint64_t>(first));
+                }
+            }
+        };
+        pool.for_each_range(m_sources.size(), std::cref(write_range));
+
+        WAVEGEN_STATS_COUNT(stats_counter::samples, static_cast<uint64_t>(last - first) * m_sources.size());
+        m_end += static_cast<int64_t>(count);
+    }
+
+    // Drops the samples before first_index.
+    void drop_before(int64_t first_index)
+    {
+        first_index = std::min(first_index, m_end);
+        if (first_index > m_first) {
+            for (auto& samples : m_samples) {
+                samples.erase(samples.begin(), samples.begin() + (first_index - m_first));
+            }
+            m_first = first_index;
+        }
+    }
+
+    // Returns the samples of a channel from sample_index on, which the stream has to hold.
+    const int32_t* get_samples(uint16_t channel, int64_t sample_index) const
+    {
+        return m_samples[channel % m_samples.size()].data() + (sample_index - m_first);
+    }
+
+private:
+    std::vector<channel_source> m_sources;
+    std::vector<std::vector<int32_t>> m_samples;    // The samples [m_first, m_end) of every source
+    int64_t m_sample_count;
+    int64_t m_first {};
+    int64_t m_end {};
+};
+
+/**
+ * A file written from a master stream, at the rate of the stream or resampled to another one.
+ * Its frames are packed by a frame writer whose sources read the stream, dithering them like
+ * the sources of a render. The header is patched with the size of the data at the end.
+ */
+class stream_file
+{
+public:
+    stream_file(const master_stream& stream, const render_options& options, uint32_t sample_rate, uint64_t sample_count,
+                const std::string& file_path)
+        : m_header {get_wave_format(options), options.header}
+        , m_sample_count(sample_count)
+        , m_frame_size(get_frame_size(options))
+        , m_dither(options.dither)
+        , m_file_path(file_path)
+    {
+        m_header.format.sample_rate = sample_rate;
+        if (sample_rate != options.sample_rate) {
+            m_resampler = std::make_unique<const polyphase_resampler>(options.sample_rate, sample_rate);
+        }
+
+        bool same_channels = options.channel_step == 0.0 && options.dither == dither_mode::none;
+        std::vector<channel_source> sources;
+        for (uint16_t channel{}; channel < (same_channels ? 1 : options.channel_count); ++channel) {
+            channel_source source;
+            if (m_resampler) {
+                source = [&stream, resampler = m_resampler.get(), channel](std::span<int32_t> samples, uint64_t first_index) {
+                    resampler->resample(stream.get_samples(channel, resampler->get_first_input(first_index)), samples, first_index);
+                };
+            } else {
+                source = [&stream, channel](std::span<int32_t> samples, uint64_t first_index) {
+                    std::copy_n(stream.get_samples(channel, static_cast<int64_t>(first_index)), samples.size(), samples.begin());
+                };
+            }
+
+            if (options.dither != dither_mode::none) {
+                source = create_dither_source(std::move(source), options.dither, channel);
+            }
+            sources.push_back(std::move(source));
+        }
+
+        m_writer = make_frame_writer(options.sample_format, get_bits_per_sample(options), options.channel_count, std::move(sources));
+    }
+
+    bool is_done() const { return m_next_index == m_sample_count; }
+
+    // Returns the first sample of the stream the frames still to be packed depend on.
+    int64_t get_first_needed() const
+    {
+        // shaped dither regenerates the samples since the start of the span of the next one
+        auto first_index = m_dither == dither_mode::shaped ? m_next_index - m_next_index % k_dither_shaping_span : m_next_index;
+        return m_resampler ? m_resampler->get_first_input(first_index) : static_cast<int64_t>(first_index);
+    }
+
+    // Creates the file and writes the header, not knowing the size of the data yet.
+    void open()
+    {
+        m_file.open(m_file_path, std::fstream::binary);
+        if (!m_file.is_open()) {
+            throw std::ofstream::failure("File generation failed. Failed to open file " + m_file_path);
+        }
+
+        m_header_bytes = m_header.get(0);
+        if (m_file.write((const char*)m_header_bytes.data(), m_header_bytes.size()).fail()) {
+            throw std::ofstream::failure("File generation failed. Failed to write header data to file.");
+        }
+        WAVEGEN_STATS_COUNT(stats_counter::bytes_written, m_header_bytes.size());
+    }
+
+    // Packs the frames up to the end of the samples the stream holds, or of the file.
+    void pack(const master_stream& stream)
+    {
+        auto end_index = m_resampler ? m_resampler->get_output_end(stream.end()) : static_cast<uint64_t>(std::max<int64_t>(stream.end(), 0));
+        m_frame_count = static_cast<std::size_t>(std::max(std::min(end_index, m_sample_count), m_next_index) - m_next_index);
+        if (m_frame_count > 0) {
+            m_block.resize(std::max(m_block.size(), m_frame_count * m_frame_size));
+            m_writer(m_next_index, m_frame_count, m_block.data(), m_scratch);
+        }
+    }
+
+    // Writes the frames packed last.
+    void write()
+    {
+        auto size = m_frame_count * m_frame_size;
+        if (m_file.write((const char*)m_block.data(), static_cast<std::streamsize>(size)).fail()) {
+            throw std::ofstream::failure("File generation failed. Failed to write audio data to file.");
+        }
+        m_next_index += m_frame_count;
+        m_frame_count = 0;
+        WAVEGEN_STATS_COUNT(stats_counter::bytes_written, size);
+    }
+
+    // Patches the header with the size of the data written, and closes the file.
+    void close()
+    {
+        m_header.patch(m_sample_count * m_frame_size, m_header_bytes);
+        if (m_file.seekp(0).write((const char*)m_header_bytes.data(), m_header_bytes.size()).fail()) {
+            throw std::ofstream::failure("File generation failed. Failed to patch header data of file.");
+        }
+        m_file.close();
+        WAVEGEN_STATS_COUNT(stats_counter::files, 1);
+    }
+
+    uint64_t get_data_size() const { return m_sample_count * m_frame_size; }
+    const render_header& header() const { return m_header; }
+
+private:
+    render_header m_header;
+    uint64_t m_sample_count;
+    uint32_t m_frame_size;
+    dither_mode m_dither;
+    std::string m_file_path;
+    std::unique_ptr<const polyphase_resampler> m_resampler;     // None for the rate of the stream
+    frame_writer m_writer;
+    std::ofstream m_file;
+    wave_header_bytes m_header_bytes;
+    uint64_t m_next_index {};
+    std::size_t m_frame_count {};       // Frames packed into the block, not written yet
+    std::vector<uint8_t> m_block;
+    std::vector<int32_t> m_scratch;
+};
+
+constexpr uint32_t k_gpu_batch_file_count {64};     // Files generated at once on an OpenCL device
+constexpr uint32_t k_gpu_chunk_frames {65'536};     // Frames of every file per chunk, 24 MiB for 64 stereo files
+
+/**
+ * The OpenCL device only evaluates sine_wave_generator: a plain sine wave of a whole frequency in every channel.
+ */
+bool is_gpu_job(const batch_job& job, const render_options& options)
+{
+    for (uint16_t channel{}; channel < options.channel_count; ++channel) {
+        auto frequency = get_channel_frequency(job.wave_frequency, options, channel);
+        if (frequency != std::floor(frequency) || frequency > std::numeric_limits<uint32_t>::max()) {
+            return false;
+        }
+    }
+
+    return !is_sink_target(job.file_path);
+}
+
+/**
+ * Renders the jobs of a batch on an OpenCL device, k_gpu_batch_file_count files at a time.
+ * The chunks of frames of a group of files alternate between two slots of the generator: the next chunk
+ * is enqueued into one slot before the frames of the last one, in the other slot, are written to the files,
+ * so the device generates while this thread waits for the disk. Jobs the device cannot render are
+ * rendered on the CPU at the end.
+ */
+batch_report create_wave_files_on_gpu(const std::vector<batch_job>& jobs, const render_options& options)
+{
+    if (options.waveform != waveform::sine || options.harmonic_count > 1 || is_modulated(options) || options.dither != dither_mode::none
+        || options.period_table || options.cache || !options.playback_device.empty() || options.first_frame != 0 || options.end_frame != 0
+        || options.encoding != output_encoding::wave) {
+        throw std::invalid_argument("Invalid argument. The OpenCL backend renders plain sine waves to Wave files, without harmonics, sweeps,"
+                                    " envelopes, dither, period tables, caching, playback or ranges.");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    batch_report report;
+    report.file_count = jobs.size();
+    auto fail = [&](const batch_job& job, const std::string& reason) {
+        ++report.failed_count;
+        report.errors.push_back(job.file_path + ": " + reason);
+    };
+
+    gpu_device device;
+    gpu_wave_settings settings {k_amplitude, options.sample_rate, options.channel_count, options.sample_format, options.oscillator};
+    gpu_batch_generator generator(device, settings, k_gpu_batch_file_count, k_gpu_chunk_frames);
+    render_header header {get_wave_format(options), options.header};
+    auto frame_size = get_frame_size(options);
+
+    struct gpu_file
+    {
+        const batch_job* job {};
+        std::vector<uint32_t> frequencies;      // Of every channel
+        std::ofstream stream;
+        uint64_t next_frame {};     // The first frame of the next chunk
+        uint64_t end_frame {};
+        bool failed {};
+    };
+
+    std::vector<const batch_job*> cpu_jobs;
+    for (std::size_t next_job{}; next_job < jobs.size();) {
+        std::vector<gpu_file> files;
+        files.reserve(k_gpu_batch_file_count);
+        while (files.size() < k_gpu_batch_file_count && next_job < jobs.size()) {
+            const auto& job = jobs[next_job++];
+            try {
+                validate_render(job.wave_frequency, job.file_length_sec, options);
+                if (!is_gpu_job(job, options)) {
+                    cpu_jobs.push_back(&job);
+                    continue;
+                }
+
+                auto& file = files.emplace_back();
+                file.job = &job;
+                for (uint16_t channel{}; channel < options.channel_count; ++channel) {
+                    file.frequencies.push_back(static_cast<uint32_t>(get_channel_frequency(job.wave_frequency, options, channel)));
+                }
+                file.end_frame = get_sample_count(job.file_length_sec, options.sample_rate);
+
+                auto header_bytes = header.get(file.end_frame * frame_size);
+                file.stream.open(job.file_path, std::fstream::binary);
+                if (!file.stream.is_open() || file.stream.write((const char*)header_bytes.data(), header_bytes.size()).fail()) {
+                    files.pop_back();
+                    throw std::ofstream::failure("File generation failed. Failed to open file " + job.file_path);
+                }
+                WAVEGEN_STATS_COUNT(stats_counter::bytes_written, header_bytes.size());
+            } catch (const std::exception& e) {
+                fail(job, e.what());
+            }
+        }
+
+        // the files of the waves of the chunks in the two slots
+        std::vector<std::size_t> slot_files[2];
+        for (unsigned slot{};; slot = 1 - slot) {
+            std::vector<gpu_chunk_wave> waves;
+            slot_files[slot].clear();
+            {
+                WAVEGEN_STATS_SCOPE(stats_stage::generate);
+                for (std::size_t index{}; index < files.size(); ++index) {
+                    auto& file = files[index];
+                    if (!file.failed && file.next_frame < file.end_frame) {
+                        auto frame_count = static_cast<uint32_t>(std::min<uint64_t>(k_gpu_chunk_frames, file.end_frame - file.next_frame));
+                        waves.push_back({file.frequencies.data(), file.next_frame, frame_count});
+                        slot_files[slot].push_back(index);
+                        file.next_frame += frame_count;
+                        WAVEGEN_STATS_COUNT(stats_counter::samples, static_cast<uint64_t>(frame_count) * options.channel_count);
+                    }
+                }
+                generator.enqueue(slot, waves);
+                generator.wait(1 - slot);
+            }
+
+            const auto& written_files = slot_files[1 - slot];
+            for (std::size_t wave_index{}; wave_index < written_files.size(); ++wave_index) {
+                auto& file = files[written_files[wave_index]];
+                auto frames = generator.get_frames(1 - slot, wave_index);
+                WAVEGEN_STATS_SCOPE(stats_stage::write);
+                if (!file.failed && file.stream.write((const char*)frames.data(), frames.size()).fail()) {
+                    file.failed = true;
+                    fail(*file.job, "File generation failed. Failed to write audio data to file.");
+                }
+                WAVEGEN_STATS_COUNT(stats_counter::bytes_written, frames.size());
+            }
+
+            if (waves.empty() && written_files.empty()) {
+                break;
+            }
+        }
+
+        for (auto& file : files) {
+            WAVEGEN_STATS_SCOPE(stats_stage::write);
+            file.stream.close();
+            if (!file.failed && file.stream.fail()) {
+                fail(*file.job, "File generation failed. Failed to write audio data to file.");
+            } else if (!file.failed) {
+                WAVEGEN_STATS_COUNT(stats_counter::files, 1);
+            }
+        }
+    }
+
+    render_options cpu_options = options;
+    cpu_options.backend = compute_backend::cpu;
+    render_context context;
+    for (const auto* job : cpu_jobs) {
+        try {
+            cpu_options.file_path = job->file_path;
+            create_wave_file(job->wave_frequency, job->file_length_sec, cpu_options, context);
+        } catch (const std::exception& e) {
+            fail(*job, e.what());
+        }
+    }
+
+    report.elapsed_sec = seconds_since(start);
+    return report;
+}
+
+/**
+ * The coroutine of render_blocks, on settings validated already. Generators and buffers are only
+ * set up once the first block of audio data is pulled.
+ */
+lazy_generator<std::span<const uint8_t>> generate_blocks(double wave_frequency, double file_length_sec, render_options render_settings,
+                                                         render_context& context,
+                             unsigned buffer_count)
+{
+    render_options resolved;
+    const auto& options = resolve_options(render_settings, file_length_sec, resolved);
+
+    if (options.encoding == output_encoding::flac) {
+        flac_block_source frames(wave_frequency, file_length_sec, options, context);
+        for (auto block = frames(); !block.empty(); block = frames()) {
+            co_yield block;
+        }
+    } else {
+        uint64_t data_size = static_cast<uint64_t>(get_frame_range(file_length_sec, options).size()) * get_frame_size(options);
+        auto header = get_render_header(wave_frequency, file_length_sec, options).get(data_size);
+        if (!header.empty()) {
+            co_yield std::span<const uint8_t>(header);
+        }
+
+        block_generator samples(wave_frequency, file_length_sec, options, context, buffer_count);
+        for (auto block = samples(); !block.empty(); block = samples()) {
+            co_yield block;
+        }
+    }
+
+    WAVEGEN_STATS_COUNT(stats_counter::files, 1);
+}
+
+}// namespace
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+thread_pool& render_context::get_pool(unsigned thread_count, bool pin_threads)
+{
+    unsigned size = thread_count ? thread_count : std::max(1u, std::thread::hardware_concurrency());
+    if (!m_pool || m_pool->size() != size || m_pool->pinned() != pin_threads) {
+        m_pool.reset();
+        m_pool = std::make_unique<thread_pool>(size, pin_threads);
+    }
+    return *m_pool;
+}
+
+void render_context::use_generator(const render_options& options)
+{
+    if (!is_same_generator(options, m_generator_options)) {
+        m_frame_writers.clear();
+        m_frame_writer_frequency = -1.0;
+        period_tables.clear();
+        m_generator_options = options;
+    }
+}
+
+std::vector<frame_writer>& render_context::get_frame_writers(double wave_frequency, const render_options& options, unsigned worker_count)
+{
+    use_generator(options);
+    if (wave_frequency != m_frame_writer_frequency) {
+        m_frame_writers.clear();
+        m_frame_writer_frequency = wave_frequency;
+    }
+
+    while (m_frame_writers.size() < worker_count) {
+        m_frame_writers.push_back(create_frame_writer(wave_frequency, options));
+    }
+    return m_frame_writers;
+}
+
+std::shared_ptr<const period_table>& render_context::get_period_table(double wave_frequency, const render_options& options)
+{
+    use_generator(options);
+    return period_tables[wave_frequency];
+}
+
+render_timing create_wave_file(double wave_frequency, double file_length_sec, const render_options& render_settings, render_context& context)
+{
+    validate_render(wave_frequency, file_length_sec, render_settings);
+    render_options resolved;
+    const auto& options = resolve_options(render_settings, file_length_sec, resolved);
+
+    uint64_t data_size = static_cast<uint64_t>(get_frame_range(file_length_sec, options).size()) * get_frame_size(options);
+    auto format = get_wave_format(options);
+    if (!options.playback_device.empty()) {
+        block_generator samples(wave_frequency, file_length_sec, options, context);
+        return play_on_device(std::ref(samples), format, options);
+    }
+
+    // fails early if the data does not fit the container
+    auto header = get_render_header(wave_frequency, file_length_sec, options);
+    if (options.encoding == output_encoding::wave) {
+        get_wave_header(format, data_size, header.shard ? &*header.shard : nullptr);
+    }
+
+    const auto& file_path = options.file_path;
+    std::string cache_key;
+    if (options.cache) {
+        cache_key = get_cache_key(wave_frequency, file_length_sec, options);
+        cached_render render;
+        if (options.cache->find(cache_key, data_size, render)) {
+            return write_cached_render(render, header, data_size, file_path);
+        }
+    }
+
+    // a file linked into the render cache must not be overwritten in place, other links are the user's own
+    std::error_code error;
+    if (options.cache && !is_sink_target(file_path) && std::filesystem::hard_link_count(file_path, error) > 1 && !error) {
+        std::filesystem::remove(file_path, error);
+    }
+
+    render_timing timing{};
+    if (options.encoding == output_encoding::flac) {
+        // the frames start with their own header
+        flac_block_source frames(wave_frequency, file_length_sec, options, context);
+        render_header flac_header {format, header_mode::raw};
+        timing = is_sink_target(file_path) ? write_to_sink(flac_header, 0, std::ref(frames), file_path)
+                                           : write_to_file(flac_header, std::ref(frames), file_path);
+
+        WAVEGEN_STATS_COUNT(stats_counter::files, 1);
+        return timing;
+    }
+
+    if (is_sink_target(file_path)) {
+        if (options.writer != output_writer::stream) {
+            throw std::invalid_argument("Invalid argument. Stdout, pipes and sockets cannot seek, their writer should be stream.");
+        }
+
+        block_generator samples(wave_frequency, file_length_sec, options, context);
+        timing = write_to_sink(header, data_size, std::ref(samples), file_path);
+    } else if (options.writer == output_writer::mmap) {
+        timing = write_to_mapped_file(header, data_size, [&](uint8_t* data) {
+            create_wave_data(wave_frequency, file_length_sec, options, context, data);
+        }, file_path);
+    } else if (options.writer == output_writer::async) {
+        block_generator samples(wave_frequency, file_length_sec, options, context, options.buffer_count);
+        timing = write_to_file_async(header, std::ref(samples), options.buffer_count, file_path);
+    } else {
+        block_generator samples(wave_frequency, file_length_sec, options, context);
+        timing = write_to_file(header, std::ref(samples), file_path);
+    }
+
+    if (options.cache && !is_sink_target(file_path)) {
+        options.cache->insert(cache_key, file_path, header.size(), data_size);
+    }
+
+    WAVEGEN_STATS_COUNT(stats_counter::files, 1);
+    return timing;
+}
+
+render_timing create_wave_file(double wave_frequency, double file_length_sec, const render_options& options)
+{
+    render_context context;
+    return create_wave_file(wave_frequency, file_length_sec, options, context);
+}
+
+render_timing render_wave(double wave_frequency, double file_length_sec, const render_options& render_settings, render_context& context,
+                          const output_callback& write_output)
+{
+    validate_render(wave_frequency, file_length_sec, render_settings);
+    render_options resolved;
+    const auto& options = resolve_options(render_settings, file_length_sec, resolved);
+
+    render_timing timing{};
+    if (options.encoding == output_encoding::flac) {
+        flac_block_source frames(wave_frequency, file_length_sec, options, context);
+        timing = write_to_callback({}, std::ref(frames), write_output);
+    } else {
+        uint64_t data_size = static_cast<uint64_t>(get_frame_range(file_length_sec, options).size()) * get_frame_size(options);
+        auto header = get_render_header(wave_frequency, file_length_sec, options).get(data_size);
+
+        block_generator samples(wave_frequency, file_length_sec, options, context);
+        timing = write_to_callback(header, std::ref(samples), write_output);
+    }
+
+    WAVEGEN_STATS_COUNT(stats_counter::files, 1);
+    return timing;
+}
+
+block_stream render_blocks(double wave_frequency, double file_length_sec, const render_options& options, render_context& context,
+                           unsigned buffer_count)
+{
+    validate_render(wave_frequency, file_length_sec, options);
+    if (buffer_count == 0 || (options.encoding == output_encoding::flac && buffer_count > 1)) {
+        throw std::invalid_argument("Invalid argument. A stream needs a buffer, the frames of FLAC only stay valid until the next pull.");
+    }
+
+    return {generate_blocks(wave_frequency, file_length_sec, options, context, buffer_count), buffer_count};
+}
+
+render_timing write_renders_async(std::vector<lazy_render>& renders, unsigned buffer_count)
+{
+    if (buffer_count < 2) {
+        throw std::invalid_argument("Invalid argument. The async writer needs at least 2 buffers.");
+    }
+    // a block still being written must not be overwritten by the stream
+    for (const auto& render : renders) {
+        if (render.blocks.buffer_count() != buffer_count) {
+            throw std::invalid_argument("Invalid argument. The stream of " + render.file_path + " rotates through "
+                                        + std::to_string(render.blocks.buffer_count()) + " buffers, the async writer through "
+                                        + std::to_string(buffer_count) + " (a FLAC stream has 1).");
+        }
+    }
+
+    // block i of a render is written through slot i % buffer_count, its buffer is reused by block i + buffer_count
+    struct render_file
+    {
+        render_file(const std::string& file_path, unsigned slot_count)
+            : file(file_path, slot_count)
+        {
+        }
+
+        async_file_writer file;
+        block_stream::iterator block;
+        uint64_t block_count {};    // Pulled so far
+        uint64_t offset {};
+        bool done {};
+    };
+
+    render_timing timing{};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<render_file>> files;
+    files.reserve(renders.size());
+    for (auto& render : renders) {
+        files.push_back(std::make_unique<render_file>(render.file_path, buffer_count));
+    }
+    timing.io_wait_sec += seconds_since(start);
+
+    for (std::size_t active_count = files.size(); active_count > 0;) {
+        for (std::size_t index{}; index < files.size(); ++index) {
+            auto& file = *files[index];
+            if (file.done) {
+                continue;
+            }
+
+            auto slot = static_cast<unsigned>(file.block_count % buffer_count);
+            start = std::chrono::steady_clock::now();
+            {
+                WAVEGEN_STATS_SCOPE(stats_stage::write);
+                file.file.wait(slot);
+            }
+            timing.io_wait_sec += seconds_since(start);
+
+            start = std::chrono::steady_clock::now();
+            if (file.block_count++ == 0) {
+                file.block = renders[index].blocks.begin();
+            } else {
+                ++file.block;
+            }
+            timing.compute_sec += seconds_since(start);
+
+            if (file.block == std::default_sentinel) {
+                start = std::chrono::steady_clock::now();
+                {
+                    WAVEGEN_STATS_SCOPE(stats_stage::write);
+                    file.file.close();
+                }
+                timing.io_wait_sec += seconds_since(start);
+                file.done = true;
+                --active_count;
+                continue;
+            }
+
+            auto block = *file.block;
+            file.file.write(slot, block.data(), block.size(), file.offset);
+            file.offset += block.size();
+            WAVEGEN_STATS_COUNT(stats_counter::bytes_written, block.size());
+        }
+    }
+
+    return timing;
+}
+
+uint64_t render_wave(double wave_frequency, double file_length_sec, const render_options& render_settings, render_context& context,
+                     std::span<uint8_t> output)
+{
+    validate_render(wave_frequency, file_length_sec, render_settings);
+    check_known_size(render_settings);
+    render_options resolved;
+    const auto& options = resolve_options(render_settings, file_length_sec, resolved);
+
+    uint64_t data_size = static_cast<uint64_t>(get_frame_range(file_length_sec, options).size()) * get_frame_size(options);
+    auto header = get_render_header(wave_frequency, file_length_sec, options);
+    if (output.size() < header.size() + data_size) {
+        throw std::invalid_argument("Invalid argument. The output buffer is smaller than the render.");
+    }
+
+    header.write(data_size, output);
+    create_wave_data(wave_frequency, file_length_sec, options, context, output.data() + header.size());
+
+    WAVEGEN_STATS_COUNT(stats_counter::bytes_written, header.size() + data_size);
+    WAVEGEN_STATS_COUNT(stats_counter::files, 1);
+    return header.size() + data_size;
+}
+
+page_buffer render_wave(double wave_frequency, double file_length_sec, const render_options& options, render_context& context)
+{
+    validate_render(wave_frequency, file_length_sec, options);
+
+    // with pinned threads, every worker's part of the output has to land on its own node
+    auto writer_count = options.pin_threads ? context.get_pool(options.thread_count, options.pin_threads).size() : 1;
+    page_buffer output(static_cast<std::size_t>(get_render_size(file_length_sec, options)), writer_count);
+    render_wave(wave_frequency, file_length_sec, options, context, std::span<uint8_t>(output.data(), output.size()));
+    return output;
+}
+
+uint64_t get_render_size(double file_length_sec, const render_options& options)
+{
+    check_known_size(options);
+    uint64_t data_size = static_cast<uint64_t>(get_frame_range(file_length_sec, options).size()) * get_frame_size(options);
+    // the size of a header does not depend on the frequency
+    return get_render_header(0.0, file_length_sec, options).size() + data_size;
+}
+
+render_timing create_resampled_wave_files(double wave_frequency, double file_length_sec, const render_options& render_settings,
+                                          const std::vector<rate_output>& outputs, render_context& context)
+{
+    validate_render(wave_frequency, file_length_sec, render_settings);
+    if (render_settings.first_frame != 0 || render_settings.end_frame != 0 || render_settings.cache || render_settings.period_table
+        || !render_settings.playback_device.empty() || render_settings.writer != output_writer::stream || is_sink_target(render_settings.file_path)
+        || render_settings.encoding != output_encoding::wave) {
+        throw std::invalid_argument("Invalid argument. Resampled renders are written to Wave files with streams, "
+                                    "without ranges, caching, playback or period tables.");
+    }
+
+    for (std::size_t output_index{}; output_index < outputs.size(); ++output_index) {
+        const auto& output = outputs[output_index];
+        if (output.sample_rate == 0 || output.sample_rate > k_max_sample_rate) {
+            throw std::invalid_argument("Invalid argument. Sample rate should be between 1 Hz and 768 kHz.");
+        }
+        if (get_highest_frequency(wave_frequency, render_settings) > output.sample_rate/2.0) {
+            throw std::invalid_argument("Invalid argument. Wave frequency should be less than or equal to half of the sample rate of every output.");
+        }
+        if (is_sink_target(output.file_path) || output.file_path == render_settings.file_path
+            || std::any_of(outputs.begin(), outputs.begin() + output_index, [&](const rate_output& other) { return other.file_path == output.file_path; })) {
+            throw std::invalid_argument("Invalid argument. Every resampled output should be written to a file of its own.");
+        }
+    }
+
+    render_options resolved;
+    const auto& options = resolve_options(render_settings, file_length_sec, resolved);
+    auto& pool = context.get_pool(options.thread_count, options.pin_threads);
+
+    // the render is the first file, the outputs follow
+    master_stream stream(wave_frequency, options, get_sample_count(file_length_sec, options.sample_rate));
+    std::vector<stream_file> files;
+    files.reserve(outputs.size() + 1);
+    files.emplace_back(stream, options, options.sample_rate, get_sample_count(file_length_sec, options.sample_rate), options.file_path);
+    for (const auto& output : outputs) {
+        files.emplace_back(stream, options, output.sample_rate, get_sample_count(file_length_sec, output.sample_rate), output.file_path);
+    }
+
+    render_timing timing{};
+    auto start = std::chrono::steady_clock::now();
+    for (auto& file : files) {
+        // fails early if the data does not fit the container
+        get_wave_header(file.header().format, file.get_data_size());
+    }
+    for (auto& file : files) {
+        file.open();
+    }
+    timing.io_wait_sec += seconds_since(start);
+
+    for (bool started{};; started = true) {
+        int64_t first_needed {INT64_MAX};
+        for (const auto& file : files) {
+            if (!file.is_done()) {
+                first_needed = std::min(first_needed, file.get_first_needed());
+            }
+        }
+        if (first_needed == INT64_MAX) {
+            break;
+        }
+
+        start = std::chrono::steady_clock::now();
+        if (!started) {
+            stream.start(first_needed);
+        }
+        stream.drop_before(first_needed);
+        {
+            WAVEGEN_STATS_SCOPE(stats_stage::generate);
+            stream.extend(options.block_sample_count, pool);
+        }
+        {
+            WAVEGEN_STATS_SCOPE(stats_stage::resample);
+            auto pack_range = [&](unsigned, std::size_t begin, std::size_t end) {
+                for (auto file_index = begin; file_index < end; ++file_index) {
+                    files[file_index].pack(stream);
+                }
+            };
+            pool.for_each_range(files.size(), std::cref(pack_range));
+        }
+        timing.compute_sec += seconds_since(start);
+
+        start = std::chrono::steady_clock::now();
+        {
+            WAVEGEN_STATS_SCOPE(stats_stage::write);
+            for (auto& file : files) {
+                file.write();
+            }
+        }
+        timing.io_wait_sec += seconds_since(start);
+    }
+
+    start = std::chrono::steady_clock::now();
+    {
+        WAVEGEN_STATS_SCOPE(stats_stage::write);
+        for (auto& file : files) {
+            file.close();
+        }
+    }
+    timing.io_wait_sec += seconds_since(start);
+
+    return timing;
+}
+
+uint64_t merge_wave_files(const std::vector<std::string>& shard_paths, const std::string& file_path)
+{
+    if (shard_paths.empty()) {
+        throw std::invalid_argument("Invalid argument. There are no shards to merge.");
+    }
+
+    wave_format format;
+    wave_shard render;      // The render of the shards, up to the end of the last one
+    uint64_t data_size{};
+    std::vector<file_slice> slices;
+    for (const auto& shard_path : shard_paths) {
+        std::error_code error;
+        if (std::filesystem::equivalent(shard_path, file_path, error)) {
+            throw std::invalid_argument("Invalid argument. The merged file should not be one of its shards.");
+        }
+
+        std::ifstream shard(shard_path, std::ifstream::binary);
+        if (!shard.is_open()) {
+            throw std::ifstream::failure("File generation failed. Failed to open file " + shard_path);
+        }
+
+        wave_header_bytes header;
+        shard.read(reinterpret_cast<char*>(header.data()), header.bytes.size());
+        header.length = static_cast<std::size_t>(shard.gcount());
+
+        wave_file_layout layout;
+        try {
+            layout = parse_wave_header(header, std::filesystem::file_size(shard_path));
+        } catch (const std::invalid_argument& e) {
+            throw std::invalid_argument("Invalid argument. " + shard_path + " is not a shard rendered with a header.");
+        }
+
+        if (!layout.has_shard) {
+            throw std::invalid_argument("Invalid argument. " + shard_path + " is not a shard rendered with a header.");
+        }
+
+        if (!slices.empty() && layout.format != format) {
+            throw std::invalid_argument("Invalid argument. Shard " + shard_path + " differs in format or container from the first shard.");
+        }
+        format = layout.format;
+
+        const auto& range = layout.shard;
+        if (!slices.empty() && (range.render_key != render.render_key || range.frame_count != render.frame_count)) {
+            throw std::invalid_argument("Invalid argument. Shard " + shard_path + " belongs to another render than the first shard.");
+        }
+        if (range.first_frame != render.end_frame) {
+            throw std::invalid_argument("Invalid argument. Shard " + shard_path + " starts at frame " + std::to_string(range.first_frame)
+                                        + ", its shards should follow each other from frame 0 without a gap, starting at frame "
+                                        + std::to_string(render.end_frame) + ".");
+        }
+
+        uint64_t frame_size = format.channel_count * format.bits_per_sample / 8u;
+        if (range.end_frame <= range.first_frame || layout.data_size != (range.end_frame - range.first_frame) * frame_size) {
+            throw std::invalid_argument("Invalid argument. Shard " + shard_path + " does not hold all the frames of its range.");
+        }
+
+        render = range;
+        slices.push_back({shard_path, layout.data_offset, layout.data_size});
+        data_size += layout.data_size;
+    }
+
+    if (render.end_frame != render.frame_count) {
+        throw std::invalid_argument("Invalid argument. The shards end at frame " + std::to_string(render.end_frame) + " of "
+                                    + std::to_string(render.frame_count) + " frames of their render.");
+    }
+
+    {
+        WAVEGEN_STATS_SCOPE(stats_stage::write);
+        write_file_slices(file_path, get_wave_header(format, data_size), slices);
+    }
+    WAVEGEN_STATS_COUNT(stats_counter::bytes_written, get_wave_header_size(format.container) + data_size);
+    WAVEGEN_STATS_COUNT(stats_counter::files, 1);
+
+    return data_size;
+}
+
+verify_report verify_wave_file(double wave_frequency, double file_length_sec, const render_options& options, render_context& context,
+                               const std::string& file_path)
+{
+    std::ifstream file(file_path, std::ifstream::binary);
+    if (!file.is_open()) {
+        throw std::ifstream::failure("Verification failed. Failed to open file " + file_path);
+    }
+
+    verify_report report;
+    report.file_size = std::filesystem::file_size(file_path);
+    report.matches = true;
+
+    // the render goes on after a mismatch, it is only compared until the first one
+    std::vector<uint8_t> buffer;
+    uint64_t offset{};
+    render_wave(wave_frequency, file_length_sec, options, context, [&](std::span<const uint8_t> data) {
+        if (report.matches) {
+            buffer.resize(std::max(buffer.size(), data.size()));
+            file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(data.size()));
+            auto read_size = static_cast<std::size_t>(file.gcount());
+
+            auto mismatch = std::mismatch(data.begin(), data.begin() + read_size, buffer.begin()).first;
+            if (mismatch != data.begin() + read_size || read_size < data.size()) {
+                report.matches = false;
+                report.mismatch_offset = offset + (mismatch - data.begin());
+            }
+        }
+        offset += data.size();
+    });
+    report.render_size = offset;
+
+    if (report.matches && report.file_size != report.render_size) {
+        report.matches = false;
+        report.mismatch_offset = std::min(report.file_size, report.render_size);
+    }
+
+    return report;
+}
+
+batch_report create_wave_files(const std::vector<batch_job>& jobs, const render_options& options)
+{
+    if (options.backend == compute_backend::opencl) {
+        return create_wave_files_on_gpu(jobs, options);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    thread_pool pool(options.thread_count, options.pin_threads);
+    std::atomic<std::size_t> next_job {};
+    std::mutex error_mutex;
+    batch_report report;
+    report.file_count = jobs.size();
+
+    pool.run([&](unsigned) {
+        render_options job_options = options;
+        job_options.thread_count = 1;
+        job_options.pin_threads = false;    // the worker is pinned already, a pinned pool of one would move it to the first CPU
+        render_context context;
+
+        for (std::size_t job_index; (job_index = next_job++) < jobs.size();) {
+            const auto& job = jobs[job_index];
+            job_options.file_path = job.file_path;
+
+            try {
+                create_wave_file(job.wave_frequency, job.file_length_sec, job_options, context);
+            } catch (const std::exception& e) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                ++report.failed_count;
+                report.errors.push_back(job.file_path + ": " + e.what());
+            }
+        }
+    });
+
+    report.elapsed_sec = seconds_since(start);
+    return report;
+}
+
+}// namespace wavegen
@@ -0,0 +1,336 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   The wavegen library: renders Wave files to files, sinks, playback devices,
+ *          callbacks or caller-provided memory, reusing buffers and generators through a context.
+ */
+#ifndef WAVE_RENDER_H_
+#define WAVE_RENDER_H_
+
+#include <map>
+#include <span>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include "Dither.h"
+#include "WaveFormat.h"
+#include "WaveWriter.h"
+#include "ThreadPool.h"
+#include "NumaMemory.h"
+#include "PeriodTable.h"
+#include "LazyGenerator.h"
+#include "SineWaveGen.h"
+#include "RenderCache.h"
+#include "WaveformGen.h"
+#include "BatchManifest.h"
+#include "SweepGenerator.h"
+
+namespace wavegen
+{
+
+constexpr uint32_t  k_amplitude {30'000'000};   // The amplitude of the sine wave to generate
+static_assert(k_float_full_scale == k_amplitude, "Float samples are normalised to the amplitude of the generators.");
+
+constexpr uint32_t  k_sample_rate {48'000};  // 48kHz default sample rate
+constexpr uint32_t  k_max_sample_rate {768'000};   // Highest sample rate of a render
+constexpr uint16_t  k_bits_per_sample {24};  // 24 bits per PCM sample
+
+constexpr uint32_t  k_block_sample_count {16'384};  // Samples per channel generated and written per block (48 KiB for 24 bit mono)
+
+// The way audio data gets into the output file.
+enum class output_writer
+{
+    stream,     // blocks are generated into a buffer and written with std::ofstream
+    mmap,       // the file is pre-sized and memory mapped, samples are generated straight into it
+    async       // blocks rotate through several buffers, the next one is generated while earlier ones are written
+};
+
+// The encoding of the audio data of a render.
+enum class output_encoding
+{
+    wave,       // uncompressed samples after a Wave header of the container
+    flac        // a FLAC stream of 24 bit PCM, its frames encoded in parallel (see FlacEncoder.h)
+};
+
+// Where the files of a batch are generated.
+enum class compute_backend
+{
+    cpu,        // on a pool of workers, every worker renders whole files
+    opencl      // on an OpenCL device, chunks of many files at once (see GpuGenerator.h)
+};
+
+// The header put in front of the audio data.
+enum class header_mode
+{
+    exact,      // sizes of the data actually rendered
+    streaming,  // maximum sizes of the container, for readers of a stream of unknown length
+    raw         // no header, raw interleaved samples
+};
+
+// Settings of a render.
+struct render_options
+{
+    oscillator_mode oscillator {oscillator_mode::exact};
+    uint32_t sample_rate {k_sample_rate};   // Hz the samples are generated at
+    unsigned thread_count {1};      // Threads generating samples, 0 selects one per hardware thread
+    bool pin_threads {};            // Pins the threads to CPUs spread over the NUMA nodes, so each one generates into memory on its node
+    output_writer writer {output_writer::stream};
+    compute_backend backend {compute_backend::cpu};     // Of batches, single renders are generated on the CPU
+    wave_container container {wave_container::riff};
+    output_encoding encoding {output_encoding::wave};   // FLAC ignores the container
+    wavegen::sample_format sample_format {wavegen::sample_format::pcm};    // 24 bit PCM or 32 bit float
+    uint16_t channel_count {1};     // Interleaved channels
+    double channel_step {};         // Channel c plays the wave frequency plus c * channel_step Hz
+    unsigned buffer_count {2};      // Rotating buffers of the async writer
+    uint32_t block_sample_count {k_block_sample_count};    // Samples per channel and worker of a block, small blocks lower the latency
+    header_mode header {header_mode::exact};
+    dither_mode dither {dither_mode::none};     // Quantization of the generated samples
+    bool period_table {};           // Compute one period of the wave once and copy it into the output
+    uint32_t harmonic_count {1};    // Partials of a harmonic spectrum, 1 renders a pure sine wave
+    wavegen::waveform waveform {wavegen::waveform::sine};
+    sweep_shape sweep {sweep_shape::none};
+    double sweep_end_frequency {};  // Hz the sweep ends at, channels keep their channel step
+    double sweep_duration_sec {};   // 0 sweeps over the whole file
+    std::vector<envelope_point> envelope;      // Amplitude breakpoints, none for a constant amplitude
+    std::string file_path {"audio.wav"};   // A file, or a sink: "-" for stdout, a named pipe or tcp://<host>:<port>
+    std::string playback_device;    // Plays the render on an audio device instead of writing a file, if not empty
+    double playback_latency_sec {0.02};    // Device buffer of the playback
+    std::shared_ptr<render_cache> cache;       // Serves repeated renders of files from an on-disk cache, if set
+    uint64_t first_frame {};        // Renders only the frames [first_frame, end_frame) of the file, a shard recorded in its header
+    uint64_t end_frame {};          // 0 renders up to the last frame
+};
+
+// Time a render spent computing samples and blocked on writing them.
+struct render_timing
+{
+    double compute_sec {};
+    double io_wait_sec {};
+    double first_block_sec {-1.0};   // Until the first block of audio data was written to a sink, negative for files
+    uint64_t underrun_count {};      // Periods a playback device could not be fed in time
+    bool cache_hit {};               // Served from the render cache instead of being rendered
+};
+
+// Outcome of a batch render.
+struct batch_report
+{
+    std::size_t file_count {};
+    std::size_t failed_count {};
+    double elapsed_sec {};
+    std::vector<std::string> errors;    // "<path>: <reason>" of every failed job
+};
+
+// A further file of a render, resampled to another sample rate.
+struct rate_output
+{
+    uint32_t sample_rate {};
+    std::string file_path;
+};
+
+// Outcome of a comparison of a file with a render.
+struct verify_report
+{
+    bool matches {};
+    uint64_t file_size {};
+    uint64_t render_size {};
+    uint64_t mismatch_offset {};    // The first byte the file differs at, if it does not match
+};
+
+// The header, then the blocks of audio data of a render, generated as they are pulled (see render_blocks).
+// It records the buffers its blocks rotate through, a block stays valid until that many more blocks have been pulled.
+class block_stream : public lazy_generator<std::span<const uint8_t>>
+{
+public:
+    block_stream() = default;
+    block_stream(lazy_generator&& blocks, unsigned buffer_count)
+        : lazy_generator(std::move(blocks))
+        , m_buffer_count(buffer_count)
+    {
+    }
+
+    unsigned buffer_count() const { return m_buffer_count; }
+
+private:
+    unsigned m_buffer_count {1};
+};
+
+// A render pulled block by block, and the file it is written to.
+struct lazy_render
+{
+    block_stream blocks;
+    std::string file_path;
+};
+
+// Receives the output of a render in order: the header, then the audio data block by block.
+// A block is only valid during the call.
+using output_callback = std::function<void(std::span<const uint8_t>)>;
+
+/**
+ * The reusable state of renders: the thread pool, the generators of the settings rendered last,
+ * the period tables of their frequencies, and the block and sample buffers. Renders through the
+ * same context reuse all of them, so rendering the same settings again into a callback or into
+ * memory does not create threads or generators, and does not allocate buffers.
+ * Its members are managed by the render functions. Not thread safe, every thread rendering
+ * concurrently owns one.
+ */
+class render_context
+{
+public:
+    render_context() = default;
+
+    render_context(const render_context&) = delete;
+    render_context& operator=(const render_context&) = delete;
+
+    /**
+     * Returns a pool of the given thread count, only recreated when the count or the pinning changes.
+     */
+    thread_pool& get_pool(unsigned thread_count, bool pin_threads = false);
+
+    /**
+     * Returns one frame writer per worker for the given frequency and options. The writers are
+     * only recreated when the frequency or the generator settings change, and the period tables
+     * are dropped when the generator settings change.
+     */
+    std::vector<frame_writer>& get_frame_writers(double wave_frequency, const render_options& options, unsigned worker_count);
+
+    /**
+     * Returns the period table slot of the given frequency, empty until a table has been created.
+     */
+    std::shared_ptr<const period_table>& get_period_table(double wave_frequency, const render_options& options);
+
+    std::vector<page_buffer> blocks;                // Rotating buffers of packed audio data, first written by the workers
+    std::vector<std::vector<int32_t>> samples;      // Scratch of the frame writers, one buffer per worker
+    std::map<double, std::shared_ptr<const period_table>> period_tables;   // By wave frequency, of the current generator settings
+
+private:
+    // Drops the frame writers and period tables if they were created for other generator settings.
+    void use_generator(const render_options& options);
+
+    std::unique_ptr<thread_pool> m_pool;
+    std::vector<frame_writer> m_frame_writers;
+    double m_frame_writer_frequency {-1.0};
+    render_options m_generator_options;     // Settings the frame writers and period tables were created for
+};
+
+/**
+ * Returns the seconds passed since the given point in time.
+ */
+double seconds_since(std::chrono::steady_clock::time_point start);
+
+/**
+ * Renders a Wave file to options.file_path (a file or a sink), or plays it on options.playback_device.
+ * With options.encoding flac, the blocks are encoded into FLAC frames by the workers that generated
+ * them and written in order with the stream writer. A FLAC render is neither cached nor played, and its
+ * header needs to be exact, or streaming for a stream of unknown length.
+ * Throws std::invalid_argument for invalid settings, and std::ofstream::failure (or a
+ * std::overflow_error for a file too long for its container) if the file cannot be written.
+ */
+render_timing create_wave_file(double wave_frequency, double file_length_sec, const render_options& options, render_context& context);
+render_timing create_wave_file(double wave_frequency, double file_length_sec, const render_options& options = {});
+
+/**
+ * Renders a Wave file into a callback, header first, without touching options.file_path. FLAC
+ * renders pass their frames on as they are encoded.
+ */
+render_timing render_wave(double wave_frequency, double file_length_sec, const render_options& options, render_context& context,
+                          const output_callback& write_output);
+
+/**
+ * Returns a render as a lazy sequence of blocks: the header (unless it is raw), then the packed audio
+ * data, one block of options.block_sample_count frames per worker each time a block is pulled. Nothing
+ * is generated before the first block is pulled and no block which is not pulled is generated, so a
+ * consumer reading part of a stream only pays for that part, and can do other work between pulls.
+ * The header stays valid as long as the stream, a block until buffer_count more blocks have been
+ * pulled. options.file_path is not touched.
+ * The stream renders through context, which has to outlive the stream and must not be used by
+ * another render until the stream is destroyed, so every concurrent stream owns a context.
+ * Throws std::invalid_argument for invalid settings at once, and for FLAC with more than one
+ * buffer, the frames of a FLAC render only staying valid until the next pull.
+ */
+block_stream render_blocks(double wave_frequency, double file_length_sec, const render_options& options, render_context& context,
+                           unsigned buffer_count = 1);
+
+/**
+ * Writes renders of render_blocks to their files, all from the calling thread: the next block of every
+ * render is pulled in turn and handed to the async_file_writer of its file, so the thread generates
+ * blocks of one render while the blocks of the others are being written. The streams have to
+ * rotate through buffer_count buffers, at least 2, so FLAC renders, whose frames only stay valid
+ * until the next pull, cannot be written by it. Finished streams are left at their end.
+ * Returns the time spent pulling blocks and waiting for writes, over all renders.
+ * Throws std::invalid_argument for a stream of another buffer count, before any file is opened,
+ * std::ofstream::failure if a file cannot be written, and what a stream throws.
+ */
+render_timing write_renders_async(std::vector<lazy_render>& renders, unsigned buffer_count);
+
+/**
+ * Renders a Wave file into the given memory, which must hold at least get_render_size() bytes.
+ * The samples are generated straight into it. Returns the bytes written.
+ * Throws std::invalid_argument for FLAC, whose size is only known once it has been encoded.
+ */
+uint64_t render_wave(double wave_frequency, double file_length_sec, const render_options& options, render_context& context,
+                     std::span<uint8_t> output);
+
+/**
+ * Renders a Wave file into a new page_buffer of get_render_size() bytes, see NumaMemory.h: a large
+ * render is backed by huge pages, and with options.pin_threads every worker's part of it is first
+ * written, and therefore allocated, on the worker's NUMA node. Pinned workers only get huge pages
+ * for parts of at least a huge page, so no page is shared by the parts of two workers.
+ */
+page_buffer render_wave(double wave_frequency, double file_length_sec, const render_options& options, render_context& context);
+
+/**
+ * Returns the bytes of header and audio data of a render of the given length.
+ * Throws std::invalid_argument for FLAC, whose size is only known once it has been encoded.
+ */
+uint64_t get_render_size(double file_length_sec, const render_options& options);
+
+/**
+ * Renders a Wave file to options.file_path like create_wave_file does, and derives the file of every
+ * output from it in the same pass: the channels are generated once, at options.sample_rate, and every
+ * block is resampled to the rates of the outputs by polyphase filters (see Resampler.h), instead of
+ * generating the wave again for every rate. The outputs share the format, header and dither of the
+ * render, a resampled output is dithered after the filter. Samples outside of the file are zero to
+ * the filters.
+ * All files are written with streams, ranges, caching, playback, sinks and period tables are not supported.
+ * Throws like create_wave_file, and std::invalid_argument for an output rate below twice the wave frequency.
+ */
+render_timing create_resampled_wave_files(double wave_frequency, double file_length_sec, const render_options& options,
+                                          const std::vector<rate_output>& outputs, render_context& context);
+
+/**
+ * Merges shards of a render, frame ranges rendered with a header, into one file at file_path.
+ * The header of a shard records its frames and a key of the settings of its render, so the shards
+ * have to be given in order, cover all frames of the same render without a gap and share their
+ * format and container. Their audio data is copied after a header of the merged size by the kernel
+ * (copy_file_range) where it can, the merge is bit-exact with a render of all frames at once.
+ * Returns the bytes of audio data merged.
+ * Throws std::invalid_argument for files which are no shards, or not all shards of the same render in order.
+ */
+uint64_t merge_wave_files(const std::vector<std::string>& shard_paths, const std::string& file_path);
+
+/**
+ * Renders a Wave file like create_wave_file does, into memory block by block, and compares it
+ * with the file at file_path, e.g. a merge of shards rendered on several machines.
+ */
+verify_report verify_wave_file(double wave_frequency, double file_length_sec, const render_options& options, render_context& context,
+                               const std::string& file_path);
+
+/**
+ * Renders the jobs of a manifest, the jobs being spread over a pool of options.thread_count workers.
+ * Every job is rendered by a single thread, so the workers do not compete for cores, and every worker
+ * renders all of its jobs through its own context.
+ * A failing job does not stop the others, its error is reported and counted as a failure.
+ * With options.backend opencl, the files are generated on an OpenCL device instead, many files at once,
+ * and written by the calling thread in between. The device renders plain sine waves only, a job of
+ * a fractional frequency or to a sink is rendered on the CPU. Its samples are within 1 LSB of the CPU.
+ * Throws std::invalid_argument for settings the device cannot render, and std::runtime_error if
+ * there is no OpenCL device.
+ */
+batch_report create_wave_files(const std::vector<batch_job>& jobs, const render_options& options);
+
+}// namespace wavegen
+
+#endif // WAVE_RENDER_H_
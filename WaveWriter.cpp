@@ -0,0 +1,116 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Frame writers generating and packing interleaved audio, specialized at compile time
+ *          for the common sample formats and channel counts.
+ */
+#include "WaveWriter.h"
+
+#include <initializer_list>
+
+namespace wavegen
+{
+
+namespace
+{
+
+/**
+ * Frame writer of any configuration: channels are generated into blocks, interleaved
+ * into a frame buffer and packed with the kernel of the bit depth.
+ */
+class generic_frame_writer
+{
+public:
+    static constexpr std::size_t k_block_frames {4'096};
+
+    generic_frame_writer(sample_format format, uint16_t bits_per_sample, uint16_t channel_count, std::vector<channel_source> sources)
+        : m_channel_count(channel_count)
+        , m_bits_per_sample(bits_per_sample)
+        , m_kernel(best_pack_kernel(bits_per_sample, format))
+        , m_sources(std::move(sources))
+    {
+    }
+
+    void operator()(uint64_t first_index, std::size_t frame_count, uint8_t* out, std::vector<int32_t>& scratch) {
+        // channel blocks, followed by the interleaved frames
+        scratch.resize(std::max(scratch.size(), k_block_frames * (m_sources.size() + m_channel_count)));
+        auto* frames = scratch.data() + k_block_frames * m_sources.size();
+
+        for (std::size_t frame{}; frame < frame_count; frame += k_block_frames) {
+            auto count = std::min(k_block_frames, frame_count - frame);
+
+            for (std::size_t channel{}; channel < m_channel_count; ++channel) {
+                auto* samples = scratch.data() + channel % m_sources.size() * k_block_frames;
+                if (channel < m_sources.size()) {
+                    m_sources[channel]({samples, count}, first_index + frame);
+                }
+
+                for (std::size_t i{}; i < count; ++i) {
+                    frames[i * m_channel_count + channel] = samples[i];
+                }
+            }
+
+            m_kernel(frames, count * m_channel_count, out + frame * m_channel_count * m_bits_per_sample / 8);
+        }
+    }
+
+private:
+    uint16_t m_channel_count;
+    uint16_t m_bits_per_sample;
+    pack_kernel m_kernel;
+    std::vector<channel_source> m_sources;
+};
+
+struct writer_entry
+{
+    sample_format format;
+    uint16_t bits_per_sample;
+    uint16_t channel_count;
+    frame_writer (*create)(std::vector<channel_source> sources);
+};
+
+template <typename Format, uint16_t Channels>
+constexpr writer_entry make_entry()
+{
+    using writer = wave_writer<Format, Channels>;
+    return {Format::k_format, writer::k_bits_per_sample, Channels, [](std::vector<channel_source> sources) -> frame_writer {
+        return writer(std::move(sources));
+    }};
+}
+
+template <typename Format>
+constexpr auto make_entries()
+{
+    return std::array {make_entry<Format, 1>(), make_entry<Format, 2>(), make_entry<Format, 4>(), make_entry<Format, 6>(),
+                       make_entry<Format, 8>()};
+}
+
+// Mono, stereo, quad, 5.1 and 7.1 of every format, the packing does not depend on the sample rate.
+constexpr auto k_pcm24_writers = make_entries<pcm24_format>();
+constexpr auto k_float32_writers = make_entries<float32_format>();
+
+const writer_entry* find_writer(sample_format format, uint16_t bits_per_sample, uint16_t channel_count)
+{
+    for (const auto* table : {&k_pcm24_writers, &k_float32_writers}) {
+        for (const auto& entry : *table) {
+            if (entry.format == format && entry.bits_per_sample == bits_per_sample && entry.channel_count == channel_count) {
+                return &entry;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+}// namespace
+
+frame_writer make_frame_writer(sample_format format, uint16_t bits_per_sample, uint16_t channel_count, std::vector<channel_source> sources)
+{
+    if (const auto* entry = find_writer(format, bits_per_sample, channel_count)) {
+        return entry->create(std::move(sources));
+    }
+
+    return generic_frame_writer(format, bits_per_sample, channel_count, std::move(sources));
+}
+
+}// namespace wavegen
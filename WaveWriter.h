@@ -0,0 +1,125 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Frame writers generating and packing interleaved audio, specialized at compile time
+ *          for the common sample formats and channel counts.
+ */
+#ifndef WAVE_WRITER_H_
+#define WAVE_WRITER_H_
+
+#include <span>
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+
+#include "SamplePacker.h"
+
+namespace wavegen
+{
+
+// Fills a block of consecutive samples of one channel, starting at the given sample index.
+using channel_source = std::function<void(std::span<int32_t>, uint64_t)>;
+
+// Generates frame_count interleaved frames, starting at frame first_index, and packs them into out.
+// scratch holds the samples being generated. It is only ever grown, so the calls of one thread can share it.
+using frame_writer = std::function<void(uint64_t first_index, std::size_t frame_count, uint8_t* out, std::vector<int32_t>& scratch)>;
+
+// 24 bit signed PCM, packed by the kernels of SamplePacker.h.
+struct pcm24_format
+{
+    static constexpr sample_format k_format {sample_format::pcm};
+    static constexpr uint16_t k_bits_per_sample {24};
+};
+
+// 32 bit IEEE 754 float, the amplitude of the generators maps to 1.0.
+struct float32_format
+{
+    static constexpr sample_format k_format {sample_format::ieee_float};
+    static constexpr uint16_t k_bits_per_sample {32};
+};
+
+/**
+ * Frame writer of a sample format and channel count fixed at compile time.
+ * Channels are generated block by block into the scratch buffer and packed straight into
+ * interleaved frames, the channel loop of the packing is unrolled for the channel count.
+ * Mono output is packed with the fastest SIMD kernel.
+ */
+template <typename Format, uint16_t Channels>
+class wave_writer
+{
+public:
+    static constexpr uint16_t k_channel_count {Channels};
+    static constexpr uint16_t k_bits_per_sample {Format::k_bits_per_sample};
+    static constexpr uint32_t k_frame_size {Channels * k_bits_per_sample / 8u};
+    static constexpr std::size_t k_block_frames {4'096};    // Frames generated per channel before they are packed
+    static constexpr std::size_t k_chunk_frames {256};      // Frames interleaved at once by pack_frames
+
+    static_assert(Channels > 0 && k_frame_size <= UINT16_MAX, "A frame has to fit the bytes_per_bloc field of the header.");
+
+    // sources holds one source per channel, or a single source shared by all channels
+    explicit wave_writer(std::vector<channel_source> sources)
+        : m_sources(std::move(sources))
+    {
+    }
+
+    void operator()(uint64_t first_index, std::size_t frame_count, uint8_t* out, std::vector<int32_t>& scratch) {
+        scratch.resize(std::max(scratch.size(), k_block_frames * m_sources.size()));
+
+        for (std::size_t frame{}; frame < frame_count; frame += k_block_frames) {
+            auto count = std::min(k_block_frames, frame_count - frame);
+
+            std::array<const int32_t*, Channels> channels;
+            for (std::size_t channel{}; channel < Channels; ++channel) {
+                auto* samples = scratch.data() + channel % m_sources.size() * k_block_frames;
+                if (channel < m_sources.size()) {
+                    m_sources[channel]({samples, count}, first_index + frame);
+                }
+                channels[channel] = samples;
+            }
+
+            pack_frames(channels, count, out + frame * k_frame_size);
+        }
+    }
+
+    /**
+     * Packs count frames into out, taking the samples of channel c from channels[c].
+     */
+    static void pack_frames(const std::array<const int32_t*, Channels>& channels, std::size_t count, uint8_t* out) {
+        if constexpr (Channels == 1) {
+            best_pack_kernel(k_bits_per_sample, Format::k_format)(channels[0], count, out);
+        } else {
+            // interleaves a chunk of frames that stays in L1 cache, then packs it with the SIMD kernel
+            auto kernel = best_pack_kernel(k_bits_per_sample, Format::k_format);
+            std::array<int32_t, k_chunk_frames * Channels> frames;
+
+            for (std::size_t frame{}; frame < count; frame += k_chunk_frames) {
+                auto chunk = std::min(k_chunk_frames, count - frame);
+                for (std::size_t i{}; i < chunk; ++i) {
+                    for (std::size_t channel{}; channel < Channels; ++channel) {
+                        frames[i * Channels + channel] = channels[channel][frame + i];
+                    }
+                }
+
+                kernel(frames.data(), chunk * Channels, out + frame * k_frame_size);
+            }
+        }
+    }
+
+private:
+    std::vector<channel_source> m_sources;
+};
+
+/**
+ * Returns the frame writer of an output configuration. Configurations listed in the dispatch
+ * table get a wave_writer specialization, all others a generic writer which interleaves the
+ * channels at run time and packs them in a second pass.
+ * sources holds one source per channel, or a single source shared by all channels.
+ */
+frame_writer make_frame_writer(sample_format format, uint16_t bits_per_sample, uint16_t channel_count, std::vector<channel_source> sources);
+
+}// namespace wavegen
+
+#endif // WAVE_WRITER_H_
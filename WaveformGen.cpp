@@ -0,0 +1,148 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Band-limited square, saw and triangle wave generators.
+ */
+#include "WaveformGen.h"
+#include "SineKernels.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+
+namespace wavegen
+{
+
+namespace
+{
+
+/**
+ * Residual of a band-limited step of height -2 at phase 0, for a phase t in [0, 1)
+ * advancing dt turns per sample. Non-zero only for the sample before and after the step.
+ */
+inline double poly_blep(double t, double dt)
+{
+    if (t < dt) {
+        double x = t / dt;
+        return x + x - x * x - 1.0;
+    }
+    if (t > 1.0 - dt) {
+        double x = (t - 1.0) / dt;
+        return x * x + x + x + 1.0;
+    }
+    return 0.0;
+}
+
+/**
+ * Residual of a band-limited corner at phase 0, the integral of poly_blep. A change of slope by
+ * s per sample is rounded off by adding s / 2 times the residual.
+ */
+inline double poly_blamp(double t, double dt)
+{
+    if (t < dt) {
+        double x = t / dt - 1.0;
+        return -x * x * x / 3.0;
+    }
+    if (t > 1.0 - dt) {
+        double x = (t - 1.0) / dt + 1.0;
+        return x * x * x / 3.0;
+    }
+    return 0.0;
+}
+
+inline double wrap(double turns)
+{
+    return turns - std::floor(turns);
+}
+
+}// namespace
+
+waveform_generator::waveform_generator(double amplitude, waveform shape, double frequency, uint32_t sample_rate)
+    : m_amplitude(amplitude)
+    , m_shape(shape)
+    , m_phase_increment(frequency / sample_rate)
+    , m_sample_rate(sample_rate)
+    , m_integer_frequency(frequency == std::floor(frequency) ? static_cast<uint32_t>(frequency) : 0)
+{
+    if (shape == waveform::sine) {
+        throw std::invalid_argument("Invalid argument. Sine waves are rendered by the sine wave generator.");
+    }
+
+    if (!(m_phase_increment > 0.0 && m_phase_increment <= 0.5)) {
+        throw std::invalid_argument("Invalid argument. Wave frequency should be greater than 0 and at most half of the sample rate.");
+    }
+}
+
+void waveform_generator::get_phases(uint64_t sample_index, double* phases, std::size_t count) const
+{
+    if (m_integer_frequency != 0) {
+        // the phase in 1 / m_sample_rate turns, exact and periodic
+        auto step = static_cast<uint64_t>(m_integer_frequency);
+        uint64_t phase = sample_index % m_sample_rate * step % m_sample_rate;
+        double turns_per_step = 1.0 / m_sample_rate;
+
+        for (std::size_t i{}; i < count; ++i) {
+            phases[i] = static_cast<double>(phase) * turns_per_step;
+            phase += step;
+            if (phase >= m_sample_rate) {
+                phase -= m_sample_rate;
+            }
+        }
+        return;
+    }
+
+    auto block_offset = sample_index % k_block_size;
+    double block_phase = fractional_product(static_cast<double>(sample_index - block_offset), m_phase_increment);
+    for (std::size_t i{}; i < count; ++i) {
+        phases[i] = wrap(block_phase + static_cast<double>(block_offset + i) * m_phase_increment);
+    }
+}
+
+template <waveform Shape>
+void waveform_generator::generate_chunk(const double* phases, int32_t* samples, std::size_t count) const
+{
+    const double dt = m_phase_increment;
+
+    for (std::size_t i{}; i < count; ++i) {
+        double t = phases[i];
+        double value{};
+
+        if constexpr (Shape == waveform::square) {
+            // rising edge at 0, falling edge at half a period
+            value = (t < 0.5 ? 1.0 : -1.0) + poly_blep(t, dt) - poly_blep(wrap(t + 0.5), dt);
+        } else if constexpr (Shape == waveform::saw) {
+            // jumps from +1 to -1 at half a period
+            double u = wrap(t + 0.5);
+            value = u + u - 1.0 - poly_blep(u, dt);
+        } else {
+            // the slope of 4 turns per turn flips at the minimum (u = 0) and the maximum (u = 0.5),
+            // a change of 8 * dt per sample
+            double u = wrap(t + 0.25);
+            value = 1.0 - 4.0 * std::fabs(u - 0.5) + 4.0 * dt * (poly_blamp(u, dt) - poly_blamp(wrap(u + 0.5), dt));
+        }
+
+        samples[i] = static_cast<int32_t>(m_amplitude * value);
+    }
+}
+
+void waveform_generator::generate(std::span<int32_t> samples, uint64_t first_index) const
+{
+    double phases[k_chunk_size];
+
+    for (std::size_t offset{}; offset < samples.size(); ) {
+        // chunks are aligned to absolute sample indices, so they never cross a block
+        auto sample_index = first_index + offset;
+        auto count = std::min<std::size_t>(k_chunk_size - sample_index % k_chunk_size, samples.size() - offset);
+        int32_t* out = samples.data() + offset;
+
+        get_phases(sample_index, phases, count);
+        switch (m_shape) {
+            case waveform::square:   generate_chunk<waveform::square>(phases, out, count); break;
+            case waveform::saw:      generate_chunk<waveform::saw>(phases, out, count); break;
+            default:                 generate_chunk<waveform::triangle>(phases, out, count); break;
+        }
+        offset += count;
+    }
+}
+
+}// namespace wavegen
@@ -0,0 +1,72 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Band-limited square, saw and triangle wave generators.
+ */
+#ifndef WAVEFORM_GEN_H_
+#define WAVEFORM_GEN_H_
+
+#include <span>
+#include <cstdint>
+
+namespace wavegen
+{
+
+// The shape of a periodic wave. All shapes start at 0 and rise, in phase with a sine wave.
+enum class waveform
+{
+    sine,
+    square,     // +1 for the first half of a period, -1 for the second
+    saw,        // rises from -1 to +1 over a period, jumping back at half a period
+    triangle    // rises to +1 at a quarter of a period, falls to -1 at three quarters
+};
+
+/**
+ * Generates band-limited square, saw and triangle waves with PolyBLEP: the naive wave is
+ * sampled, and the two samples around every discontinuity get a polynomial residual of a
+ * band-limited step (PolyBLEP, square and saw) or of a band-limited corner (PolyBLAMP,
+ * triangle) added. This pushes aliasing from around -22 dB (square, saw) and -52 dB
+ * (triangle) of the harmonics down to around -46 and -66 dB, at a cost per sample which
+ * does not depend on the frequency, unlike the sum of partials of an oscillator bank.
+ *
+ * The phase of an integer frequency is counted exactly in integers, so the wave repeats exactly
+ * and can be put into a period table. For a fractional frequency the phase of every block of
+ * k_block_size samples is computed exactly from its absolute sample index. Either way a sample
+ * only depends on its index.
+ */
+class waveform_generator
+{
+public:
+    static constexpr uint32_t k_block_size {4'096};    // Samples per block of a fractional frequency, each starts from an exact phase
+    static constexpr uint32_t k_chunk_size {256};      // Samples whose phases are computed ahead of their values, divides k_block_size
+
+    /**
+     * Throws std::invalid_argument for a sine shape (rendered by sine_wave_generator) or a
+     * frequency outside (0, sample_rate / 2].
+     */
+    waveform_generator(double amplitude, waveform shape, double frequency, uint32_t sample_rate);
+
+    /**
+     * Fills the given block with consecutive samples, starting at first_index.
+     */
+    void generate(std::span<int32_t> samples, uint64_t first_index) const;
+
+    waveform shape() const { return m_shape; }
+
+private:
+    // Phases in turns in [0, 1) of count samples from sample_index, which do not cross a block.
+    void get_phases(uint64_t sample_index, double* phases, std::size_t count) const;
+
+    template <waveform Shape>
+    void generate_chunk(const double* phases, int32_t* samples, std::size_t count) const;
+
+    double m_amplitude;
+    waveform m_shape;
+    double m_phase_increment;       // Turns per sample
+    uint32_t m_sample_rate;
+    uint32_t m_integer_frequency;   // Hz of an integer frequency, counted in 1 / m_sample_rate turns, 0 if fractional
+};
+
+}// namespace wavegen
+
+#endif // WAVEFORM_GEN_H_
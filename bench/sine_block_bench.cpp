@@ -0,0 +1,124 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Microbenchmark of the per-sample get_sample loop against the block generate() API
+ *          and each vectorised sine kernel supported by the running CPU.
+ *
+ * Build:   g++ -O2 -std=c++20 -I.. sine_block_bench.cpp ../SineKernels.cpp ../CpuFeatures.cpp -o sine-block-bench
+ * Usage:   sine-block-bench [sample_count]
+ */
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <functional>
+
+#include "SineWaveGen.h"
+
+namespace
+{
+
+constexpr uint32_t k_amplitude {30'000'000};
+constexpr uint32_t k_frequency {1'000};
+constexpr uint32_t k_sample_rate {48'000};
+constexpr uint32_t k_block_size {16'384};
+constexpr int      k_repetitions {5};
+
+/**
+ * Runs fill over all samples and returns the best throughput in samples per second.
+ */
+double measure(uint32_t sample_count, const std::function<void(uint32_t, uint32_t)>& fill)
+{
+    double best {};
+    for (int repetition{}; repetition < k_repetitions; ++repetition) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t first{}; first < sample_count; first += k_block_size) {
+            fill(first, std::min(k_block_size, sample_count - first));
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::max(best, sample_count / elapsed.count());
+    }
+
+    return best;
+}
+
+/**
+ * Returns the largest difference (in LSB) of the last generated block against the exact path.
+ */
+int32_t max_error(const std::vector<int32_t>& samples, uint32_t sample_count)
+{
+    wavegen::sine_wave_generator exact(k_amplitude, k_frequency, k_sample_rate);
+
+    uint32_t first = (sample_count - 1) / k_block_size * k_block_size;
+    int32_t error {};
+    for (uint32_t i{}; i < sample_count - first; ++i) {
+        error = std::max(error, std::abs(samples[i] - exact.get_sample(first + i)));
+    }
+
+    return error;
+}
+
+void report(const std::string& name, double samples_per_sec, double baseline, int32_t error)
+{
+    std::cout << std::left << std::setw(24) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(1) << samples_per_sec / 1e6 << " MS/s"
+              << std::setw(9) << std::setprecision(2) << samples_per_sec / baseline << "x"
+              << std::setw(10) << error << " LSB\n";
+}
+
+}// namespace
+
+int main(int argc, char* argv[])
+{
+    uint32_t sample_count = argc > 1 ? std::stoul(argv[1]) : k_sample_rate * 60;
+    std::vector<int32_t> samples(k_block_size);
+
+    std::cout << "Generating " << sample_count << " samples of a " << k_frequency << "Hz sine wave in blocks of "
+              << k_block_size << " samples.\n\n"
+              << std::left << std::setw(24) << "path" << std::right << std::setw(15) << "throughput"
+              << std::setw(10) << "speedup" << std::setw(14) << "max error\n";
+
+    wavegen::sine_wave_generator exact(k_amplitude, k_frequency, k_sample_rate);
+    double baseline = measure(sample_count, [&](uint32_t first, uint32_t count) {
+        for (uint32_t i{}; i < count; ++i) {
+            samples[i] = exact.get_sample(first + i);
+        }
+    });
+    report("get_sample (exact)", baseline, baseline, 0);
+
+    wavegen::sine_wave_generator recursive(k_amplitude, k_frequency, k_sample_rate, wavegen::oscillator_mode::recursive);
+    double throughput = measure(sample_count, [&](uint32_t first, uint32_t count) {
+        recursive.generate({samples.data(), count}, first);
+    });
+    report("generate (recursive)", throughput, baseline, max_error(samples, sample_count));
+
+    for (auto isa : {wavegen::simd_isa::scalar, wavegen::simd_isa::avx2, wavegen::simd_isa::avx512, wavegen::simd_isa::neon}) {
+        auto kernel = wavegen::get_sine_kernel(isa);
+        if (!kernel) {
+            continue;
+        }
+
+        throughput = measure(sample_count, [&](uint32_t first, uint32_t count) {
+            for (uint32_t offset{}; offset < count; offset += wavegen::sine_wave_generator::k_kernel_block) {
+                auto phase_numerator = static_cast<uint64_t>(first + offset) * k_frequency % k_sample_rate;
+                wavegen::sine_block_args args {k_amplitude, static_cast<double>(phase_numerator) / k_sample_rate,
+                                               static_cast<double>(k_frequency) / k_sample_rate, 0.0};
+                kernel(args, samples.data() + offset, std::min(wavegen::sine_wave_generator::k_kernel_block, count - offset));
+            }
+        });
+        // appended in place, the temporaries of a chain of operator+ trip -Wrestrict of GCC 12
+        std::string name {"kernel ("};
+        name.append(wavegen::simd_isa_name(isa)).append(")");
+        report(name, throughput, baseline, max_error(samples, sample_count));
+    }
+
+    wavegen::sine_wave_generator polynomial(k_amplitude, k_frequency, k_sample_rate, wavegen::oscillator_mode::polynomial);
+    throughput = measure(sample_count, [&](uint32_t first, uint32_t count) {
+        polynomial.generate({samples.data(), count}, first);
+    });
+    report("generate (polynomial)", throughput, baseline, max_error(samples, sample_count));
+
+    return 0;
+}
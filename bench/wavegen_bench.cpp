@@ -0,0 +1,652 @@
+/**
+ * Author:  Mohammad Khodsetan
+ * Date:    14-10-2026
+ * Desc.:   Benchmark suite of the generation, dither, resampling, memory placement, GPU, packing, FLAC, header and I/O stages, measured separately
+ *          across durations and thread counts. Results are written as JSON (in the layout of
+ *          Google Benchmark, so its compare tools can track them over time) or as CSV.
+ *
+ * Build:   g++ -O2 -std=c++20 -pthread -I.. wavegen_bench.cpp ../SineKernels.cpp ../CpuFeatures.cpp ../SamplePacker.cpp ../Dither.cpp
+ *              ../Resampler.cpp ../NumaMemory.cpp ../GpuGenerator.cpp ../FlacEncoder.cpp ../WaveFormat.cpp ../MappedFile.cpp
+ *              ../AsyncFileWriter.cpp -ldl -o wavegen-bench
+ * Usage:   wavegen-bench [--durations <sec,...>] [--threads <count,...>] [--repetitions <count>]
+ *                        [--format json|csv] [--dir <path>] [--filter <text>]
+ */
+#include <ctime>
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+
+#include "Dither.h"
+#include "Resampler.h"
+#include "SineWaveGen.h"
+#include "SamplePacker.h"
+#include "ThreadPool.h"
+#include "WaveFormat.h"
+#include "FlacEncoder.h"
+#include "MappedFile.h"
+#include "NumaMemory.h"
+#include "GpuGenerator.h"
+#include "AsyncFileWriter.h"
+
+namespace
+{
+
+constexpr uint32_t k_amplitude {30'000'000};
+constexpr uint32_t k_frequency {1'000};
+constexpr uint32_t k_sample_rate {48'000};
+constexpr uint16_t k_bits_per_sample {24};
+constexpr uint32_t k_block_size {16'384};
+constexpr uint32_t k_header_count {100'000};     // Headers created per header benchmark run
+constexpr uint32_t k_gpu_wave_count {64};        // Waves generated at once by the GPU benchmarks
+constexpr uint32_t k_gpu_chunk_frames {65'536};
+
+volatile std::size_t g_sink {};     // Keeps results of otherwise unused computations alive
+
+struct bench_settings
+{
+    std::vector<double> durations {1, 10, 60};
+    std::vector<unsigned> thread_counts {1, 2, 4, 0};
+    int repetitions {3};
+    std::string format {"json"};
+    std::string directory {"."};
+    std::string filter;
+};
+
+struct bench_result
+{
+    std::string name;
+    int repetitions {};
+    double best_sec {};
+    double mean_sec {};
+    double items {};    // Samples (or headers) processed by one run
+    double bytes {};    // Bytes produced by one run, 0 if not meaningful
+};
+
+/**
+ * Runs fn the given number of times and records its best and mean time, unless
+ * the name does not contain the filter.
+ */
+void run(const bench_settings& settings, std::vector<bench_result>& results, const std::string& name, double items, double bytes,
+         const std::function<void()>& fn)
+{
+    if (name.find(settings.filter) == std::string::npos) {
+        return;
+    }
+
+    bench_result result {name, settings.repetitions, 0.0, 0.0, items, bytes};
+    for (int repetition{}; repetition < settings.repetitions; ++repetition) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        result.best_sec = repetition == 0 ? elapsed.count() : std::min(result.best_sec, elapsed.count());
+        result.mean_sec += elapsed.count() / settings.repetitions;
+    }
+
+    std::cerr << name << ": " << result.best_sec * 1e3 << " ms\n";
+    results.push_back(result);
+}
+
+const char* mode_name(wavegen::oscillator_mode mode)
+{
+    switch (mode) {
+        case wavegen::oscillator_mode::recursive:  return "recursive";
+        case wavegen::oscillator_mode::polynomial: return "polynomial";
+        case wavegen::oscillator_mode::integer:    return "integer";
+        default:                                    return "exact";
+    }
+}
+
+const char* container_name(wavegen::wave_container container)
+{
+    switch (container) {
+        case wavegen::wave_container::rf64: return "rf64";
+        case wavegen::wave_container::w64:  return "w64";
+        default:                            return "riff";
+    }
+}
+
+std::string duration_name(double duration_sec)
+{
+    std::ostringstream name;
+    name << duration_sec << "s";
+    return name.str();
+}
+
+void bench_generation(const bench_settings& settings, std::vector<bench_result>& results)
+{
+    constexpr wavegen::oscillator_mode modes[] {wavegen::oscillator_mode::exact, wavegen::oscillator_mode::recursive,
+                                                wavegen::oscillator_mode::polynomial, wavegen::oscillator_mode::integer};
+
+    for (auto duration : settings.durations) {
+        auto sample_count = static_cast<uint32_t>(k_sample_rate * duration);
+
+        for (auto mode : modes) {
+            std::vector<int32_t> block(k_block_size);
+            wavegen::sine_wave_generator generator(k_amplitude, k_frequency, k_sample_rate, mode);
+
+            run(settings, results, std::string("get_sample/") + mode_name(mode) + "/" + duration_name(duration), sample_count, 0, [&] {
+                for (uint32_t index{}; index < sample_count; ++index) {
+                    block[index % k_block_size] = generator.get_sample(index);
+                }
+            });
+        }
+
+        std::vector<unsigned> pool_sizes;
+        for (auto thread_count : settings.thread_counts) {
+            wavegen::thread_pool pool(thread_count);
+            if (std::find(pool_sizes.begin(), pool_sizes.end(), pool.size()) != pool_sizes.end()) {
+                continue;
+            }
+            pool_sizes.push_back(pool.size());
+
+            for (auto mode : modes) {
+                std::vector<std::vector<int32_t>> blocks(pool.size(), std::vector<int32_t>(k_block_size));
+                auto name = std::string("generate/") + mode_name(mode) + "/" + duration_name(duration) + "/threads:" + std::to_string(pool.size());
+
+                run(settings, results, name, sample_count, 0, [&] {
+                    pool.for_each_range(sample_count, [&](unsigned worker_index, std::size_t begin, std::size_t end) {
+                        wavegen::sine_wave_generator generator(k_amplitude, k_frequency, k_sample_rate, mode);
+                        auto& block = blocks[worker_index];
+
+                        for (auto first = begin; first < end; first += k_block_size) {
+                            auto count = std::min<std::size_t>(k_block_size, end - first);
+                            generator.generate({block.data(), count}, static_cast<uint32_t>(first));
+                        }
+                    });
+                });
+            }
+        }
+    }
+}
+
+void bench_packing(const bench_settings& settings, std::vector<bench_result>& results)
+{
+    std::vector<int32_t> samples(k_block_size);
+    wavegen::sine_wave_generator generator(k_amplitude, k_frequency, k_sample_rate);
+    generator.generate(samples, 0);
+
+    std::vector<uint8_t> packed(k_block_size * k_bits_per_sample / 8);
+
+    for (auto duration : settings.durations) {
+        auto sample_count = static_cast<uint32_t>(k_sample_rate * duration);
+
+        for (auto isa : {wavegen::simd_isa::scalar, wavegen::simd_isa::ssse3, wavegen::simd_isa::avx2, wavegen::simd_isa::avx512,
+                         wavegen::simd_isa::neon}) {
+            auto kernel = wavegen::get_pack_kernel(k_bits_per_sample, isa);
+            if (!kernel) {
+                continue;
+            }
+
+            auto name = std::string("pack24/") + wavegen::simd_isa_name(isa) + "/" + duration_name(duration);
+            run(settings, results, name, sample_count, sample_count * 3.0, [&] {
+                for (uint32_t first{}; first < sample_count; first += k_block_size) {
+                    kernel(samples.data(), std::min(k_block_size, sample_count - first), packed.data());
+                }
+            });
+        }
+    }
+}
+
+void bench_dither(const bench_settings& settings, std::vector<bench_result>& results)
+{
+    std::vector<int32_t> samples(k_block_size);
+    wavegen::sine_wave_generator generator(k_amplitude << wavegen::k_dither_fraction_bits, k_frequency, k_sample_rate);
+    generator.generate(samples, 0);
+
+    std::vector<int32_t> dithered(k_block_size);
+
+    for (auto duration : settings.durations) {
+        auto sample_count = static_cast<uint32_t>(k_sample_rate * duration);
+
+        for (auto isa : {wavegen::simd_isa::scalar, wavegen::simd_isa::avx2, wavegen::simd_isa::avx512, wavegen::simd_isa::neon}) {
+            auto kernel = wavegen::get_dither_kernel(isa);
+            if (!kernel) {
+                continue;
+            }
+
+            auto name = std::string("dither_tpdf/") + wavegen::simd_isa_name(isa) + "/" + duration_name(duration);
+            run(settings, results, name, sample_count, 0, [&] {
+                for (uint32_t first{}; first < sample_count; first += k_block_size) {
+                    kernel(samples.data(), std::min(k_block_size, sample_count - first), 0, first, dithered.data());
+                }
+            });
+        }
+
+        run(settings, results, "dither_shaped/" + duration_name(duration), sample_count, 0, [&] {
+            wavegen::noise_shaper_state state;
+            for (uint32_t first{}; first < sample_count; first += k_block_size) {
+                wavegen::shape_noise(samples.data(), std::min(k_block_size, sample_count - first), 0, first, dithered.data(), state);
+            }
+        });
+    }
+
+    g_sink = static_cast<std::size_t>(dithered[0]);
+}
+
+void bench_resample(const bench_settings& settings, std::vector<bench_result>& results)
+{
+    for (uint32_t output_rate : {44'100u, 96'000u, 192'000u}) {
+        wavegen::polyphase_resampler resampler(k_sample_rate, output_rate);
+        std::vector<int32_t> resampled(k_block_size);
+
+        // the input of a block of output samples, generated once and filtered again for every block
+        auto input_count = static_cast<std::size_t>(resampler.get_first_input(k_block_size) + resampler.tap_count() - resampler.get_first_input(0));
+        std::vector<int32_t> samples(input_count);
+        wavegen::sine_wave_generator generator(k_amplitude, k_frequency, k_sample_rate);
+        generator.generate(samples, 0);
+
+        for (auto duration : settings.durations) {
+            auto sample_count = static_cast<uint32_t>(output_rate * duration);
+            auto name = "resample/" + std::to_string(output_rate) + "/" + duration_name(duration);
+            run(settings, results, name, sample_count, 0, [&] {
+                for (uint32_t first{}; first < sample_count; first += k_block_size) {
+                    resampler.resample(samples.data(), {resampled.data(), std::min(k_block_size, sample_count - first)}, 0);
+                }
+            });
+        }
+
+        g_sink = static_cast<std::size_t>(resampled[0]);
+    }
+}
+
+void bench_memory(const bench_settings& settings, std::vector<bench_result>& results)
+{
+    // generates into a new buffer every run, so the time includes the page faults of its first writes
+    auto generate_into = [](wavegen::thread_pool& pool, int32_t* samples, uint32_t sample_count) {
+        pool.for_each_range(sample_count, [&](unsigned, std::size_t begin, std::size_t end) {
+            wavegen::sine_wave_generator generator(k_amplitude, k_frequency, k_sample_rate);
+            for (auto first = begin; first < end; first += k_block_size) {
+                auto count = std::min<std::size_t>(k_block_size, end - first);
+                generator.generate({samples + first, count}, first);
+            }
+        });
+    };
+
+    for (auto duration : settings.durations) {
+        auto sample_count = static_cast<uint32_t>(k_sample_rate * duration);
+        auto byte_count = static_cast<std::size_t>(sample_count) * sizeof(int32_t);
+
+        std::vector<unsigned> pool_sizes;
+        for (auto thread_count : settings.thread_counts) {
+            wavegen::thread_pool pool(thread_count);
+            if (std::find(pool_sizes.begin(), pool_sizes.end(), pool.size()) != pool_sizes.end()) {
+                continue;
+            }
+            pool_sizes.push_back(pool.size());
+            auto suffix = "/" + duration_name(duration) + "/threads:" + std::to_string(pool.size());
+
+            run(settings, results, "render_memory/vector" + suffix, sample_count, byte_count, [&] {
+                std::vector<int32_t> samples(sample_count);
+                generate_into(pool, samples.data(), sample_count);
+                g_sink = static_cast<std::size_t>(samples.back());
+            });
+
+            run(settings, results, "render_memory/pages" + suffix, sample_count, byte_count, [&] {
+                wavegen::page_buffer buffer(byte_count);
+                generate_into(pool, reinterpret_cast<int32_t*>(buffer.data()), sample_count);
+                g_sink = buffer.data()[byte_count - 1];
+            });
+
+            wavegen::thread_pool pinned_pool(pool.size(), true);
+            run(settings, results, "render_memory/pages:pinned" + suffix, sample_count, byte_count, [&] {
+                wavegen::page_buffer buffer(byte_count);
+                generate_into(pinned_pool, reinterpret_cast<int32_t*>(buffer.data()), sample_count);
+                g_sink = buffer.data()[byte_count - 1];
+            });
+        }
+    }
+}
+
+void bench_gpu(const bench_settings& settings, std::vector<bench_result>& results)
+{
+    std::unique_ptr<wavegen::gpu_device> device;
+    try {
+        device = std::make_unique<wavegen::gpu_device>();
+    } catch (const std::exception& e) {
+        std::cerr << "Skipping the GPU benchmarks: " << e.what() << "\n";
+        return;
+    }
+    std::cerr << "GPU benchmarks on " << device->name() << "\n";
+
+    for (auto duration : settings.durations) {
+        auto sample_count = static_cast<uint32_t>(k_sample_rate * duration);
+
+        for (auto mode : {wavegen::oscillator_mode::exact, wavegen::oscillator_mode::integer}) {
+            std::vector<int32_t> samples(sample_count);
+            wavegen::gpu_sine_wave_generator generator(*device, k_amplitude, k_frequency, k_sample_rate, mode);
+
+            run(settings, results, std::string("generate_gpu/") + mode_name(mode) + "/" + duration_name(duration), sample_count,
+                0, [&] {
+                generator.generate(samples, 0);
+                g_sink = static_cast<std::size_t>(samples.back());
+            });
+        }
+
+        // k_gpu_wave_count packed 24 bit waves, in chunks of k_gpu_chunk_frames, like a batch render of as many files
+        auto wave_name = "/" + duration_name(duration) + "/waves:" + std::to_string(k_gpu_wave_count);
+        auto item_count = static_cast<double>(sample_count) * k_gpu_wave_count;
+        std::vector<uint32_t> frequencies(k_gpu_wave_count);
+        for (uint32_t wave{}; wave < k_gpu_wave_count; ++wave) {
+            frequencies[wave] = k_frequency + wave;
+        }
+
+        wavegen::gpu_batch_generator batch(*device, {k_amplitude, k_sample_rate}, k_gpu_wave_count, k_gpu_chunk_frames);
+        run(settings, results, "generate_batch_gpu" + wave_name, item_count, item_count * 3, [&] {
+            std::vector<wavegen::gpu_chunk_wave> waves(k_gpu_wave_count);
+            unsigned slot {};
+            for (uint32_t first{}; first < sample_count; first += k_gpu_chunk_frames, slot = 1 - slot) {
+                for (uint32_t wave{}; wave < k_gpu_wave_count; ++wave) {
+                    waves[wave] = {&frequencies[wave], first, std::min(k_gpu_chunk_frames, sample_count - first)};
+                }
+                batch.enqueue(slot, waves);
+            }
+            batch.wait(0);
+            batch.wait(1);
+            g_sink = batch.get_frames(0, 0)[0];
+        });
+
+        std::vector<unsigned> pool_sizes;
+        for (auto thread_count : settings.thread_counts) {
+            wavegen::thread_pool pool(thread_count);
+            if (std::find(pool_sizes.begin(), pool_sizes.end(), pool.size()) != pool_sizes.end()) {
+                continue;
+            }
+            pool_sizes.push_back(pool.size());
+
+            std::vector<std::vector<int32_t>> blocks(pool.size(), std::vector<int32_t>(k_gpu_chunk_frames));
+            std::vector<std::vector<uint8_t>> packed(pool.size(), std::vector<uint8_t>(k_gpu_chunk_frames * 3));
+            run(settings, results, "generate_batch_cpu" + wave_name + "/threads:" + std::to_string(pool.size()), item_count,
+                item_count * 3, [&] {
+                pool.for_each_range(k_gpu_wave_count, [&](unsigned worker_index, std::size_t begin, std::size_t end) {
+                    auto& block = blocks[worker_index];
+                    for (auto wave = begin; wave < end; ++wave) {
+                        wavegen::sine_wave_generator generator(k_amplitude, frequencies[wave], k_sample_rate);
+                        for (uint32_t first{}; first < sample_count; first += k_gpu_chunk_frames) {
+                            auto count = std::min(k_gpu_chunk_frames, sample_count - first);
+                            generator.generate({block.data(), count}, first);
+                            wavegen::pack_samples({block.data(), count}, k_bits_per_sample, packed[worker_index].data());
+                        }
+                    }
+                });
+            });
+        }
+    }
+}
+
+void bench_flac(const bench_settings& settings, std::vector<bench_result>& results)
+{
+    // a quarter of the amplitude keeps the tone within 24 bits, like a render with an envelope gain of 0.25
+    std::vector<int32_t> samples(k_block_size);
+    std::vector<uint8_t> packed;
+    wavegen::sine_wave_generator generator(k_amplitude / 4, k_frequency, k_sample_rate);
+
+    for (auto duration : settings.durations) {
+        auto sample_count = static_cast<uint32_t>(k_sample_rate * duration);
+        packed.resize(static_cast<std::size_t>(sample_count) * 3);
+        for (uint32_t first{}; first < sample_count; first += k_block_size) {
+            auto count = std::min(k_block_size, sample_count - first);
+            generator.generate({samples.data(), count}, first);
+            wavegen::pack_samples({samples.data(), count}, k_bits_per_sample, packed.data() + first * 3ull);
+        }
+
+        std::vector<unsigned> pool_sizes;
+        for (auto thread_count : settings.thread_counts) {
+            wavegen::thread_pool pool(thread_count);
+            if (std::find(pool_sizes.begin(), pool_sizes.end(), pool.size()) != pool_sizes.end()) {
+                continue;
+            }
+            pool_sizes.push_back(pool.size());
+
+            // blocks of the size of the blocks of a render on the pool
+            std::size_t block_bytes = static_cast<std::size_t>(k_block_size) * pool.size() * 3;
+            auto name = "flac_encode/" + duration_name(duration) + "/threads:" + std::to_string(pool.size());
+            run(settings, results, name, sample_count, static_cast<double>(packed.size()), [&] {
+                wavegen::flac_encoder encoder({}, sample_count, pool);
+                std::size_t encoded_bytes {};
+                for (std::size_t offset{}; offset < packed.size(); offset += block_bytes) {
+                    encoded_bytes += encoder.encode({packed.data() + offset, std::min(block_bytes, packed.size() - offset)}).size();
+                }
+                g_sink = encoded_bytes + encoder.finish().size();
+            });
+        }
+    }
+}
+
+void bench_header(const bench_settings& settings, std::vector<bench_result>& results)
+{
+    for (auto container : {wavegen::wave_container::riff, wavegen::wave_container::rf64, wavegen::wave_container::w64}) {
+        wavegen::wave_format format {container};
+        std::size_t header_bytes {};
+
+        run(settings, results, std::string("create_wave_header/") + container_name(container), k_header_count, 0, [&] {
+            for (uint32_t i{}; i < k_header_count; ++i) {
+                header_bytes += wavegen::create_wave_header(format, i * 3ull).size();
+            }
+        });
+
+        std::array<uint8_t, wavegen::k_max_wave_header_size> header {};
+        run(settings, results, std::string("write_wave_header/") + container_name(container), k_header_count, 0, [&] {
+            for (uint32_t i{}; i < k_header_count; ++i) {
+                header_bytes += wavegen::write_wave_header(format, i * 3ull, header);
+            }
+        });
+
+        run(settings, results, std::string("patch_wave_header/") + container_name(container), k_header_count, 0, [&] {
+            for (uint32_t i{}; i < k_header_count; ++i) {
+                wavegen::patch_wave_header(format, i * 3ull, header);
+            }
+            header_bytes += header[4];
+        });
+
+        g_sink = header_bytes;
+    }
+}
+
+void bench_io(const bench_settings& settings, std::vector<bench_result>& results)
+{
+    std::string file_path = settings.directory + "/wavegen-bench.tmp";
+    auto header = wavegen::create_wave_header({}, 0);
+
+    std::vector<uint8_t> block(k_block_size * k_bits_per_sample / 8);
+    for (std::size_t i{}; i < block.size(); ++i) {
+        block[i] = static_cast<uint8_t>(i * 37);
+    }
+
+    for (auto duration : settings.durations) {
+        auto sample_count = static_cast<uint32_t>(k_sample_rate * duration);
+        uint64_t data_size = static_cast<uint64_t>(sample_count) * k_bits_per_sample / 8;
+
+        run(settings, results, "io/stream/" + duration_name(duration), sample_count, data_size, [&] {
+            std::ofstream file(file_path, std::fstream::binary);
+            file.write(reinterpret_cast<const char*>(header.data()), header.size());
+            for (uint64_t offset{}; offset < data_size; offset += block.size()) {
+                file.write(reinterpret_cast<const char*>(block.data()), std::min<uint64_t>(block.size(), data_size - offset));
+            }
+
+            file.close();
+            if (file.fail()) {
+                throw std::ofstream::failure("Benchmark failed. Failed to write " + file_path);
+            }
+        });
+
+        run(settings, results, "io/mmap/" + duration_name(duration), sample_count, data_size, [&] {
+            wavegen::mapped_file file(file_path, header.size() + data_size);
+            std::memcpy(file.data(), header.data(), header.size());
+            for (uint64_t offset{}; offset < data_size; offset += block.size()) {
+                std::memcpy(file.data() + header.size() + offset, block.data(), std::min<uint64_t>(block.size(), data_size - offset));
+            }
+            file.close();
+        });
+
+        std::string backend_name = wavegen::async_file_writer(file_path, 1).backend_name();
+        run(settings, results, "io/async:" + backend_name + "/" + duration_name(duration), sample_count, data_size, [&] {
+            // the same block is written from every slot, the data never changes while in flight
+            constexpr unsigned k_slot_count {2};
+            wavegen::async_file_writer file(file_path, k_slot_count + 1);
+            file.write(k_slot_count, header.data(), header.size(), 0);
+
+            unsigned slot {};
+            for (uint64_t offset{}; offset < data_size; offset += block.size(), slot = (slot + 1) % k_slot_count) {
+                file.wait(slot);
+                file.write(slot, block.data(), std::min<uint64_t>(block.size(), data_size - offset), header.size() + offset);
+            }
+            file.close();
+        });
+    }
+
+    std::remove(file_path.c_str());
+}
+
+std::string json_string(const std::string& text)
+{
+    std::string quoted {"\""};
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+        }
+        quoted += c;
+    }
+
+    return quoted + "\"";
+}
+
+void write_json(std::ostream& out, const std::vector<bench_result>& results, const char* executable)
+{
+    auto now = std::time(nullptr);
+    char date[32] {};
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    const char* simd = "scalar";
+    for (auto isa : {wavegen::simd_isa::neon, wavegen::simd_isa::ssse3, wavegen::simd_isa::avx2, wavegen::simd_isa::avx512}) {
+        if (wavegen::cpu_supports(isa)) {
+            simd = wavegen::simd_isa_name(isa);
+        }
+    }
+
+    out << std::setprecision(9)
+        << "{\n  \"context\": {\n"
+        << "    \"date\": " << json_string(date) << ",\n"
+        << "    \"executable\": " << json_string(executable) << ",\n"
+        << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+        << "    \"simd\": " << json_string(simd) << "\n"
+        << "  },\n  \"benchmarks\": [";
+
+    for (std::size_t i{}; i < results.size(); ++i) {
+        const auto& result = results[i];
+        out << (i ? ",\n" : "\n")
+            << "    {\n"
+            << "      \"name\": " << json_string(result.name) << ",\n"
+            << "      \"run_type\": \"iteration\",\n"
+            << "      \"repetitions\": " << result.repetitions << ",\n"
+            << "      \"iterations\": 1,\n"
+            << "      \"real_time\": " << result.best_sec * 1e3 << ",\n"
+            << "      \"mean_time\": " << result.mean_sec * 1e3 << ",\n"
+            << "      \"time_unit\": \"ms\",\n"
+            << "      \"items_per_second\": " << result.items / result.best_sec;
+        if (result.bytes > 0) {
+            out << ",\n      \"bytes_per_second\": " << result.bytes / result.best_sec;
+        }
+        out << "\n    }";
+    }
+
+    out << "\n  ]\n}\n";
+}
+
+void write_csv(std::ostream& out, const std::vector<bench_result>& results)
+{
+    out << std::setprecision(9) << "name,repetitions,best_ms,mean_ms,items_per_second,bytes_per_second\n";
+    for (const auto& result : results) {
+        out << result.name << ',' << result.repetitions << ',' << result.best_sec * 1e3 << ',' << result.mean_sec * 1e3 << ','
+            << result.items / result.best_sec << ',' << result.bytes / result.best_sec << '\n';
+    }
+}
+
+template <typename T>
+std::vector<T> parse_list(const std::string& text)
+{
+    std::vector<T> values;
+    std::istringstream stream(text);
+    for (std::string item; std::getline(stream, item, ',');) {
+        values.push_back(static_cast<T>(std::stod(item)));
+    }
+
+    if (values.empty()) {
+        throw std::invalid_argument("Invalid arguments. Empty list " + text + ".");
+    }
+
+    return values;
+}
+
+bench_settings parse_args(int argc, char* argv[])
+{
+    bench_settings settings;
+    for (int arg_index{1}; arg_index < argc; ++arg_index) {
+        std::string option {argv[arg_index]};
+        if (arg_index + 1 >= argc) {
+            throw std::invalid_argument("Invalid arguments. Missing value for option " + option + ".");
+        }
+
+        std::string value {argv[++arg_index]};
+        if (option == "--durations") {
+            settings.durations = parse_list<double>(value);
+        } else if (option == "--threads") {
+            settings.thread_counts = parse_list<unsigned>(value);
+        } else if (option == "--repetitions") {
+            settings.repetitions = std::max(1, std::stoi(value));
+        } else if (option == "--format" && (value == "json" || value == "csv")) {
+            settings.format = value;
+        } else if (option == "--dir") {
+            settings.directory = value;
+        } else if (option == "--filter") {
+            settings.filter = value;
+        } else {
+            throw std::invalid_argument("Invalid arguments. Unknown option " + option + " " + value + ".");
+        }
+    }
+
+    return settings;
+}
+
+}// namespace
+
+int main(int argc, char* argv[])
+{
+    try {
+        auto settings = parse_args(argc, argv);
+        std::vector<bench_result> results;
+
+        bench_generation(settings, results);
+        bench_dither(settings, results);
+        bench_resample(settings, results);
+        bench_memory(settings, results);
+        bench_gpu(settings, results);
+        bench_packing(settings, results);
+        bench_flac(settings, results);
+        bench_header(settings, results);
+        bench_io(settings, results);
+
+        if (settings.format == "csv") {
+            write_csv(std::cout, results);
+        } else {
+            write_json(std::cout, results, argv[0]);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: \"" << e.what() << "\"\n";
+        return -1;
+    }
+
+    return 0;
+}
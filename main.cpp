@@ -14,154 +14,602 @@
  * - audio.wav file 24 bit, mono, 48kHz in current directory.
  * - an exception with an explanation if there was an error anywhere.
  */
-#include <array>
 #include <string>
 #include <vector>
+#include <chrono>
 #include <cstring>
-#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <stdexcept>
 
-#include "WaveHeader.h"
-#include "SineWaveGen.h"
+#include "WaveRender.h"
+#include "RenderStats.h"
 
-// Helper constants
-constexpr uint32_t  k_amplitude {30'000'000};   // The amplitude of the sine wave to generate 
-
-constexpr uint32_t  k_sample_rate {48'000};  // 48kHz sample rate
-constexpr uint16_t  k_bits_per_sample {24};  // 24 bits per sample
+// Settings of the command line tool around its renders.
+struct command_options
+{
+    std::string manifest_path;      // Renders the jobs of a batch manifest instead of a single file
+    std::vector<std::string> shard_paths;      // Merges these shards into the output instead of rendering it
+    std::string verify_path;        // Compares this file with the render instead of writing it, if not empty
+    std::vector<wavegen::rate_output> rate_outputs;    // Further files of the render, resampled to other sample rates
+    std::string stats_format;       // Prints a timing report as text or json after the render, none if empty
+    std::string cache_directory;    // Serves repeated renders from an on-disk cache in this directory, if not empty
+    uint64_t cache_size_limit {uint64_t{1} << 30};     // Bytes of cached files kept, least recently used ones are removed
+    bool cache_prefixes {};         // Serves shorter renders by truncating longer cached ones
+};
 
 /**
- * Generates the header for a Wave file. 
+ * Prints the stats collected so far, as an aligned text report or as a single line of JSON.
+ * With the stats compiled out only wall time and peak RSS are known.
  */
-auto create_wave_header(double file_length_sec)
+void print_stats(std::ostream& out, const std::string& stats_format, double wall_sec)
 {
-    wave::WaveHeader hdr{};
+    auto stats = wavegen::get_stats();
+    auto files = stats.counters[static_cast<std::size_t>(wavegen::stats_counter::files)];
+    auto samples = stats.counters[static_cast<std::size_t>(wavegen::stats_counter::samples)];
+    auto bytes_written = stats.counters[static_cast<std::size_t>(wavegen::stats_counter::bytes_written)];
+    auto peak_rss = wavegen::get_peak_rss();
 
-    std::memcpy(&hdr.file_type_bloc_id, "RIFF", 4);
-    std::memcpy(&hdr.file_format_id, "WAVE", 4);
-    std::memcpy(&hdr.format_bloc_id, "fmt ", 4);
-    std::memcpy(&hdr.data_bloc_id, "data", 4);
+    if (stats_format == "json") {
+        out << std::setprecision(9) << "{\"wall_sec\": " << wall_sec << ", \"peak_rss_bytes\": " << peak_rss;
+        if (WAVEGEN_STATS) {
+            out << ", \"files\": " << files << ", \"samples\": " << samples << ", \"samples_per_sec\": " << samples / wall_sec
+                << ", \"bytes_written\": " << bytes_written << ", \"mb_per_sec\": " << bytes_written / wall_sec / 1e6
+                << ", \"stages\": {";
+            for (std::size_t stage{}; stage < stats.stage_sec.size(); ++stage) {
+                out << (stage ? ", " : "") << '"' << wavegen::stats_stage_name(static_cast<wavegen::stats_stage>(stage))
+                    << "\": {\"calls\": " << stats.stage_calls[stage] << ", \"sec\": " << stats.stage_sec[stage] << '}';
+            }
+            out << '}';
+        }
+        out << std::defaultfloat << '}' << std::endl;
+        return;
+    }
 
-    hdr.bloc_size = wave::k_header_bloc_size;
-    hdr.audio_format = wave::k_audio_format_PCM;
-    hdr.channel_count = wave::k_channel_count_mono;
-    hdr.sample_rate = k_sample_rate;
-    hdr.bits_per_sample = k_bits_per_sample;
-    hdr.bytes_per_bloc = (hdr.channel_count * hdr.bits_per_sample / 8);
-    hdr.bytes_per_sec = (hdr.sample_rate * hdr.bytes_per_bloc);
+    out << std::fixed << std::setprecision(3)
+        << "Stats:\n"
+        << "  wall time     " << std::setw(12) << wall_sec << " s\n"
+        << "  peak RSS      " << std::setw(12) << peak_rss / 1e6 << " MB\n";
 
-    uint64_t data_size = static_cast<uint64_t>(file_length_sec * hdr.bytes_per_sec);
-    if (data_size > UINT32_MAX) {
-        throw std::overflow_error("File generation failed. Data size exceeds the maximum limit.");
+    if (!WAVEGEN_STATS) {
+        out << "  counters and stage timers are compiled out (WAVEGEN_STATS=0)\n";
+    } else {
+        out << "  files         " << std::setw(12) << files << "\n"
+            << "  samples       " << std::setw(12) << samples << " (" << samples / wall_sec / 1e6 << " M samples/s)\n"
+            << "  written       " << std::setw(12) << bytes_written / 1e6 << " MB (" << bytes_written / wall_sec / 1e6 << " MB/s)\n"
+            << "  stage                calls      seconds   of wall time\n";
+        for (std::size_t stage{}; stage < stats.stage_sec.size(); ++stage) {
+            out << "  " << std::left << std::setw(14) << wavegen::stats_stage_name(static_cast<wavegen::stats_stage>(stage))
+                << std::right << std::setw(12) << stats.stage_calls[stage] << std::setw(13) << stats.stage_sec[stage]
+                << std::setw(13) << std::setprecision(1) << 100.0 * stats.stage_sec[stage] / wall_sec << " %\n"
+                << std::setprecision(3);
+        }
     }
+    out << std::defaultfloat;
+}
 
-    hdr.data_size = static_cast<uint32_t>(data_size);
-    hdr.file_size = wave::k_header_size + hdr.data_size - 8;
+/**
+ * Parses a comma separated list of paths.
+ */
+std::vector<std::string> parse_paths(const std::string& value)
+{
+    std::vector<std::string> paths;
+    for (std::size_t begin{}; begin <= value.size(); ) {
+        auto end = std::min(value.find(',', begin), value.size());
+        if (end == begin) {
+            throw std::invalid_argument("Invalid arguments. Shards should be given as <path>[,<path>...].");
+        }
 
-    std::array<uint8_t, wave::k_header_size> header;
-    std::memcpy(header.data(), &hdr, wave::k_header_size);
+        paths.push_back(value.substr(begin, end - begin));
+        begin = end + 1;
+    }
 
-    return header;
+    return paths;
 }
 
 /**
- * Generates data for a Wave file.
+ * Parses the sample rate of a render or an output in Hz.
  */
-auto create_wave_data(uint32_t wave_frequency, double file_length_sec)
-{    
-    std::vector<uint8_t> samples;
-
-    wavegen::sine_wave_generator  audio_source(k_amplitude, wave_frequency, k_sample_rate);
-    uint32_t total_sample_count = k_sample_rate * file_length_sec;
-    for (uint32_t sample_index{}; sample_index < total_sample_count; ++sample_index) 
-    {        
-        auto sample = audio_source.get_sample(sample_index);
+uint32_t parse_sample_rate(const std::string& value)
+{
+    const std::string error {"Invalid arguments. Sample rate should be a whole number of Hz between 1 and 768000."};
 
-        samples.push_back(sample & 0xFF);
-        samples.push_back((sample >> 8) & 0xFF);
-        samples.push_back((sample >> 16) & 0xFF);
+    unsigned long sample_rate{};
+    std::size_t end{};
+    try {
+        sample_rate = std::stoul(value, &end);
+    } catch (const std::exception& e) {
+        throw std::invalid_argument(error);
     }
 
-    return samples;
+    if (end != value.size() || sample_rate == 0 || sample_rate > wavegen::k_max_sample_rate) {
+        throw std::invalid_argument(error);
+    }
+    return static_cast<uint32_t>(sample_rate);
 }
 
 /**
- * Writes header and audio data to a given file
+ * Parses resampled outputs given as <Hz>[=<path>][,<Hz>[=<path>]...]. An output without a path
+ * is written next to the render, its rate appended to the name: audio_44100.wav for audio.wav.
+ * The paths are completed once the path of the render is known.
  */
-void write_to_file(const uint8_t* hdr, uint32_t hdr_size, const uint8_t* data, uint32_t data_size, const std::string& file_path)
+std::vector<wavegen::rate_output> parse_rate_outputs(const std::string& value)
 {
-    std::ofstream file(file_path, std::fstream::binary);
+    std::vector<wavegen::rate_output> outputs;
+    for (std::size_t begin{}; begin <= value.size(); ) {
+        auto end = std::min(value.find(',', begin), value.size());
+        auto output = value.substr(begin, end - begin);
+        auto equals = output.find('=');
+        if (equals == output.size() - 1) {
+            throw std::invalid_argument("Invalid arguments. Resampled outputs should be given as <Hz>[=<path>][,<Hz>[=<path>]...].");
+        }
 
-    if (!file.is_open()) {
-        throw std::ofstream::failure("File generation failed. Failed to open file " + file_path);
+        outputs.push_back({parse_sample_rate(output.substr(0, equals)), equals == std::string::npos ? "" : output.substr(equals + 1)});
+        begin = end + 1;
     }
 
-    try {
-        if(file.write((const char*)hdr, hdr_size).fail()) {
-            throw std::ofstream::failure("File generation failed. Failed to write header data to file.");
-        }
+    return outputs;
+}
 
-        if (file.write((const char*)data, data_size).fail()) {
-            throw std::ofstream::failure("File generation failed. Failed to write audio data to file.");
-        }
-    } catch (...) {
-        file.close(); // ensure file is closed on exception
-        throw;
+/**
+ * Returns the path of a resampled output without a path of its own.
+ */
+std::string get_rate_output_path(const std::string& file_path, uint32_t sample_rate)
+{
+    auto slash = file_path.find_last_of("/\\");
+    auto dot = file_path.rfind('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        dot = file_path.size();
     }
 
-    file.close();
+    return file_path.substr(0, dot) + "_" + std::to_string(sample_rate) + file_path.substr(dot);
 }
 
-
-void create_wave_file(uint32_t wave_frequency, double file_length_sec)
+/**
+ * Parses a frame range given as <first>:<end> or <first>:, the latter ending with the file.
+ */
+void parse_range(const std::string& value, wavegen::render_options& options)
 {
-    if (file_length_sec <= 0.0) {
-        throw std::invalid_argument("Invalid argument. File length should be greater than 0.");
+    auto colon = value.find(':');
+    if (colon == 0 || colon == std::string::npos || value.find(':', colon + 1) != std::string::npos
+        || value.find_first_not_of("0123456789:") != std::string::npos) {
+        throw std::invalid_argument("Invalid arguments. Range should be given as <first frame>:<end frame> or <first frame>:.");
     }
 
-    if (wave_frequency > k_sample_rate/2) {
-        throw std::invalid_argument("Invalid argument. Wave frequency should be less than or equal to half of the sample rate.");
+    try {
+        options.first_frame = std::stoull(value.substr(0, colon));
+        options.end_frame = colon + 1 == value.size() ? 0 : std::stoull(value.substr(colon + 1));
+    } catch (const std::exception& e) {
+        throw std::invalid_argument("Invalid arguments. Enter valid frame numbers for the range.");
     }
+}
 
-    auto header  = create_wave_header(file_length_sec);
-    auto samples = create_wave_data(wave_frequency, file_length_sec);
+/**
+ * Parses envelope breakpoints given as <seconds>:<gain>[,<seconds>:<gain>...].
+ */
+std::vector<wavegen::envelope_point> parse_envelope(const std::string& value)
+{
+    std::vector<wavegen::envelope_point> envelope;
+    for (std::size_t begin{}; begin <= value.size(); ) {
+        auto end = std::min(value.find(',', begin), value.size());
+        auto point = value.substr(begin, end - begin);
+        auto colon = point.find(':');
+
+        try {
+            std::size_t time_end{}, gain_end{};
+            if (colon == std::string::npos) {
+                throw std::invalid_argument(point);
+            }
+            auto time_sec = std::stod(point.substr(0, colon), &time_end);
+            auto gain = std::stod(point.substr(colon + 1), &gain_end);
+            if (time_end != colon || gain_end != point.size() - colon - 1) {
+                throw std::invalid_argument(point);
+            }
+            envelope.push_back({time_sec, gain});
+        } catch (const std::exception& e) {
+            throw std::invalid_argument("Invalid arguments. Envelope breakpoints should be given as <seconds>:<gain>[,<seconds>:<gain>...].");
+        }
+
+        begin = end + 1;
+    }
 
-    std::string file_path {"audio.wav"};
-    write_to_file(header.data(), header.size(), samples.data(), samples.size(), file_path);
+    return envelope;
 }
 
-void parse_args(int argc, char* argv[], uint32_t& frequency, double& file_length)
+void parse_args(int argc, char* argv[], double& frequency, double& file_length, wavegen::render_options& options,
+                command_options& command)
 {
-    if (argc < 3) {
-        throw std::invalid_argument("Invalid arguments. Usage: " + std::string(argv[0]) + " <wave_frequency> <file_length_sec>");
+    std::string usage = "Invalid arguments. Usage: " + std::string(argv[0]) + " <wave_frequency> <file_length_sec> | --batch <manifest> | --merge <shard>,..."
+                        " [--oscillator exact|recursive|polynomial|integer] [--threads <count>] [--pin-threads on|off]"
+                        " [--writer stream|mmap|async] [--buffers <count>] [--container riff|rf64|w64] [--encoding wave|flac]"
+                        " [--period-table on|off] [--harmonics <count>] [--waveform sine|square|saw|triangle] [--format pcm24|float32]"
+                        " [--dither none|tpdf|shaped]"
+                        " [--channels <count>] [--channel-step <Hz>] [--sweep linear|exponential] [--sweep-to <Hz>]"
+                        " [--sweep-time <sec>] [--envelope <sec>:<gain>,...] [--output <path>|-|tcp://<host>:<port>]"
+                        " [--header exact|streaming|raw] [--block-frames <count>] [--play default|null|<device>]"
+                        " [--latency <ms>] [--cache <dir>] [--cache-size <MiB>] [--cache-mode exact|prefix] [--stats text|json]"
+                        " [--range <first>:<end>] [--verify <file>] [--sample-rate <Hz>] [--resample <Hz>[=<path>],...]"
+                        " [--backend cpu|opencl]";
+
+    // the positional arguments may only be left out for a batch
+    bool has_positionals = argc >= 2 && std::strncmp(argv[1], "--", 2) != 0;
+    if (has_positionals) {
+        if (argc < 3) {
+            throw std::invalid_argument(usage);
+        }
+
+        try {
+            frequency = std::stod(argv[1]);
+            file_length = std::stod(argv[2]);
+        } catch (const std::exception& e) {
+            throw std::invalid_argument("Invalid arguments. Enter valid numbers for wave frequency and file length.");
+        }
     }
 
-    try {
-        frequency = std::stoul(argv[1]);
-        file_length = std::stod(argv[2]);
-    } catch (const std::exception& e) {
-        throw std::invalid_argument("Invalid arguments. Enter valid numbers for wave frequency and file length.");
+    for (int arg_index{has_positionals ? 3 : 1}; arg_index < argc; ++arg_index) {
+        std::string option {argv[arg_index]};
+        if (arg_index + 1 >= argc) {
+            throw std::invalid_argument("Invalid arguments. Missing value for option " + option + ".");
+        }
+
+        std::string value {argv[++arg_index]};
+        if (option == "--oscillator") {
+            if (value == "exact") {
+                options.oscillator = wavegen::oscillator_mode::exact;
+            } else if (value == "recursive") {
+                options.oscillator = wavegen::oscillator_mode::recursive;
+            } else if (value == "polynomial") {
+                options.oscillator = wavegen::oscillator_mode::polynomial;
+            } else if (value == "integer") {
+                options.oscillator = wavegen::oscillator_mode::integer;
+            } else {
+                throw std::invalid_argument("Invalid arguments. Oscillator mode should be exact, recursive, polynomial or integer.");
+            }
+        } else if (option == "--threads") {
+            try {
+                options.thread_count = std::stoul(value);
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("Invalid arguments. Enter a valid number for thread count.");
+            }
+        } else if (option == "--pin-threads") {
+            if (value != "on" && value != "off") {
+                throw std::invalid_argument("Invalid arguments. Pin threads should be either on or off.");
+            }
+            options.pin_threads = value == "on";
+        } else if (option == "--backend") {
+            if (value == "cpu") {
+                options.backend = wavegen::compute_backend::cpu;
+            } else if (value == "opencl") {
+                options.backend = wavegen::compute_backend::opencl;
+            } else {
+                throw std::invalid_argument("Invalid arguments. Backend should be cpu or opencl.");
+            }
+        } else if (option == "--writer") {
+            if (value == "stream") {
+                options.writer = wavegen::output_writer::stream;
+            } else if (value == "mmap") {
+                options.writer = wavegen::output_writer::mmap;
+            } else if (value == "async") {
+                options.writer = wavegen::output_writer::async;
+            } else {
+                throw std::invalid_argument("Invalid arguments. Writer should be stream, mmap or async.");
+            }
+        } else if (option == "--container") {
+            if (value == "riff") {
+                options.container = wavegen::wave_container::riff;
+            } else if (value == "rf64") {
+                options.container = wavegen::wave_container::rf64;
+            } else if (value == "w64") {
+                options.container = wavegen::wave_container::w64;
+            } else {
+                throw std::invalid_argument("Invalid arguments. Container should be riff, rf64 or w64.");
+            }
+        } else if (option == "--encoding") {
+            if (value == "wave") {
+                options.encoding = wavegen::output_encoding::wave;
+            } else if (value == "flac") {
+                options.encoding = wavegen::output_encoding::flac;
+            } else {
+                throw std::invalid_argument("Invalid arguments. Encoding should be wave or flac.");
+            }
+        } else if (option == "--buffers") {
+            try {
+                options.buffer_count = std::stoul(value);
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("Invalid arguments. Enter a valid number for buffer count.");
+            }
+
+            if (options.buffer_count < 2) {
+                throw std::invalid_argument("Invalid arguments. The async writer needs at least 2 buffers.");
+            }
+        } else if (option == "--period-table") {
+            if (value != "on" && value != "off") {
+                throw std::invalid_argument("Invalid arguments. Period table should be either on or off.");
+            }
+            options.period_table = value == "on";
+        } else if (option == "--harmonics") {
+            try {
+                options.harmonic_count = std::stoul(value);
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("Invalid arguments. Enter a valid number for harmonic count.");
+            }
+        } else if (option == "--format") {
+            if (value == "pcm24") {
+                options.sample_format = wavegen::sample_format::pcm;
+            } else if (value == "float32") {
+                options.sample_format = wavegen::sample_format::ieee_float;
+            } else {
+                throw std::invalid_argument("Invalid arguments. Format should be pcm24 or float32.");
+            }
+        } else if (option == "--channels") {
+            unsigned long channel_count{};
+            try {
+                channel_count = std::stoul(value);
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("Invalid arguments. Enter a valid number for channel count.");
+            }
+
+            if (channel_count == 0 || channel_count > UINT16_MAX) {
+                throw std::invalid_argument("Invalid arguments. Channel count should be between 1 and 65535.");
+            }
+            options.channel_count = static_cast<uint16_t>(channel_count);
+        } else if (option == "--channel-step") {
+            try {
+                options.channel_step = std::stod(value);
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("Invalid arguments. Enter a valid number for channel step.");
+            }
+        } else if (option == "--waveform") {
+            if (value == "sine") {
+                options.waveform = wavegen::waveform::sine;
+            } else if (value == "square") {
+                options.waveform = wavegen::waveform::square;
+            } else if (value == "saw") {
+                options.waveform = wavegen::waveform::saw;
+            } else if (value == "triangle") {
+                options.waveform = wavegen::waveform::triangle;
+            } else {
+                throw std::invalid_argument("Invalid arguments. Waveform should be sine, square, saw or triangle.");
+            }
+        } else if (option == "--dither") {
+            if (value == "none") {
+                options.dither = wavegen::dither_mode::none;
+            } else if (value == "tpdf") {
+                options.dither = wavegen::dither_mode::tpdf;
+            } else if (value == "shaped") {
+                options.dither = wavegen::dither_mode::shaped;
+            } else {
+                throw std::invalid_argument("Invalid arguments. Dither should be none, tpdf or shaped.");
+            }
+        } else if (option == "--sweep") {
+            if (value == "linear") {
+                options.sweep = wavegen::sweep_shape::linear;
+            } else if (value == "exponential") {
+                options.sweep = wavegen::sweep_shape::exponential;
+            } else {
+                throw std::invalid_argument("Invalid arguments. Sweep should be linear or exponential.");
+            }
+        } else if (option == "--sweep-to") {
+            try {
+                options.sweep_end_frequency = std::stod(value);
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("Invalid arguments. Enter a valid number for the sweep end frequency.");
+            }
+        } else if (option == "--sweep-time") {
+            try {
+                options.sweep_duration_sec = std::stod(value);
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("Invalid arguments. Enter a valid number for the sweep time.");
+            }
+        } else if (option == "--envelope") {
+            options.envelope = parse_envelope(value);
+        } else if (option == "--header") {
+            if (value == "exact") {
+                options.header = wavegen::header_mode::exact;
+            } else if (value == "streaming") {
+                options.header = wavegen::header_mode::streaming;
+            } else if (value == "raw") {
+                options.header = wavegen::header_mode::raw;
+            } else {
+                throw std::invalid_argument("Invalid arguments. Header should be exact, streaming or raw.");
+            }
+        } else if (option == "--block-frames") {
+            try {
+                options.block_sample_count = std::stoul(value);
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("Invalid arguments. Enter a valid number for block frames.");
+            }
+
+            if (options.block_sample_count == 0) {
+                throw std::invalid_argument("Invalid arguments. Block frames should be greater than 0.");
+            }
+        } else if (option == "--play") {
+            options.playback_device = value;
+        } else if (option == "--latency") {
+            try {
+                options.playback_latency_sec = std::stod(value) / 1e3;
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("Invalid arguments. Enter a valid number for latency.");
+            }
+
+            if (!(options.playback_latency_sec > 0.0)) {
+                throw std::invalid_argument("Invalid arguments. Latency should be greater than 0.");
+            }
+        } else if (option == "--output") {
+            options.file_path = value;
+        } else if (option == "--cache") {
+            command.cache_directory = value;
+        } else if (option == "--cache-size") {
+            try {
+                command.cache_size_limit = static_cast<uint64_t>(std::stoull(value)) << 20;
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("Invalid arguments. Enter a valid number of MiB for the cache size.");
+            }
+        } else if (option == "--cache-mode") {
+            if (value == "exact" || value == "prefix") {
+                command.cache_prefixes = value == "prefix";
+            } else {
+                throw std::invalid_argument("Invalid arguments. Cache mode should be exact or prefix.");
+            }
+        } else if (option == "--stats") {
+            if (value != "text" && value != "json") {
+                throw std::invalid_argument("Invalid arguments. Stats should be either text or json.");
+            }
+            command.stats_format = value;
+        } else if (option == "--batch") {
+            command.manifest_path = value;
+        } else if (option == "--merge") {
+            command.shard_paths = parse_paths(value);
+        } else if (option == "--range") {
+            parse_range(value, options);
+        } else if (option == "--verify") {
+            command.verify_path = value;
+        } else if (option == "--sample-rate") {
+            options.sample_rate = parse_sample_rate(value);
+        } else if (option == "--resample") {
+            command.rate_outputs = parse_rate_outputs(value);
+        } else {
+            throw std::invalid_argument("Invalid arguments. Unknown option " + option + ".");
+        }
+    }
+
+    // a render, a batch or a merge
+    int command_count = has_positionals + !command.manifest_path.empty() + !command.shard_paths.empty();
+    if (command_count != 1) {
+        throw std::invalid_argument(usage);
+    }
+
+    if (!command.rate_outputs.empty() && (!has_positionals || !command.verify_path.empty())) {
+        throw std::invalid_argument("Invalid arguments. Resampled outputs are made by a render, not by a batch, a merge or a verification.");
+    }
+    if (options.backend != wavegen::compute_backend::cpu && command.manifest_path.empty()) {
+        throw std::invalid_argument("Invalid arguments. The OpenCL backend renders batches, single files are rendered on the CPU.");
+    }
+    for (auto& output : command.rate_outputs) {
+        if (output.file_path.empty()) {
+            output.file_path = get_rate_output_path(options.file_path, output.sample_rate);
+        }
     }
 }      
 
 int main(int argc, char* argv[])
 {
+    // progress goes to stderr while the audio data goes to stdout
+    std::ostream* log = &std::cout;
+
     try {
-        uint32_t frequency{};
+        double frequency{};
         double file_length{};
-        parse_args(argc, argv, frequency, file_length);
+        wavegen::render_options options{};
+        command_options command{};
+        parse_args(argc, argv, frequency, file_length, options, command);
+        auto start = std::chrono::steady_clock::now();
+        if (options.file_path == "-") {
+            log = &std::cerr;
+        }
+
+        if (!command.cache_directory.empty()) {
+            options.cache = std::make_shared<wavegen::render_cache>(command.cache_directory, command.cache_size_limit, command.cache_prefixes);
+        }
+
+        if (!command.manifest_path.empty()) {
+            auto jobs = wavegen::read_manifest(command.manifest_path);
+            *log << "Generating " << jobs.size() << " wave files of manifest " << command.manifest_path << "...\n";
+
+            auto report = wavegen::create_wave_files(jobs, options);
+            for (const auto& error : report.errors) {
+                std::cerr << "Error: \"" << error << "\"\n";
+            }
 
-        std::cout << "Generating a wave file with wave frequency " << frequency 
-                  << "Hz and file length " << file_length << " seconds...\n";
+            // only the files actually written count towards the rate
+            auto written_count = report.file_count - report.failed_count;
+            *log << "Generated " << written_count << " of " << report.file_count << " files in " << report.elapsed_sec
+                 << " seconds (" << written_count / report.elapsed_sec << " files per second).\n";
+            if (!command.stats_format.empty()) {
+                print_stats(*log, command.stats_format, wavegen::seconds_since(start));
+            }
+
+            if (report.failed_count > 0) {
+                throw std::runtime_error("Batch generation failed. " + std::to_string(report.failed_count) + " files could not be generated.");
+            }
+
+            *log << "Finished.\n";
+            return 0;
+        }
+
+        if (!command.shard_paths.empty()) {
+            *log << "Merging " << command.shard_paths.size() << " shards into " << options.file_path << "...\n";
+
+            auto data_size = wavegen::merge_wave_files(command.shard_paths, options.file_path);
+
+            *log << "Merged " << data_size << " bytes of audio data in " << wavegen::seconds_since(start) << " seconds.\n";
+            if (!command.stats_format.empty()) {
+                print_stats(*log, command.stats_format, wavegen::seconds_since(start));
+            }
+
+            *log << "Finished.\n";
+            return 0;
+        }
+
+        if (!command.verify_path.empty()) {
+            *log << "Verifying " << command.verify_path << " against a wave with wave frequency " << frequency
+                 << "Hz and length " << file_length << " seconds...\n";
+
+            wavegen::render_context context;
+            auto report = wavegen::verify_wave_file(frequency, file_length, options, context, command.verify_path);
+            if (!report.matches) {
+                throw std::runtime_error("Verification failed. " + command.verify_path + " (" + std::to_string(report.file_size)
+                                         + " bytes) differs from the render (" + std::to_string(report.render_size)
+                                         + " bytes) at byte " + std::to_string(report.mismatch_offset) + ".");
+            }
+
+            *log << "Verified " << report.file_size << " bytes in " << wavegen::seconds_since(start) << " seconds, the file matches the render.\n";
+            *log << "Finished.\n";
+            return 0;
+        }
+
+        if (options.playback_device.empty()) {
+            *log << "Generating a wave file with wave frequency " << frequency 
+                 << "Hz and file length " << file_length << " seconds...\n";
+        } else {
+            *log << "Playing a wave with wave frequency " << frequency 
+                 << "Hz and length " << file_length << " seconds on " << options.playback_device << "...\n";
+        }
         
-        create_wave_file(frequency, file_length);
+        wavegen::render_timing timing;
+        if (command.rate_outputs.empty()) {
+            timing = wavegen::create_wave_file(frequency, file_length, options);
+        } else {
+            *log << "Resampling it from " << options.sample_rate << "Hz to";
+            for (const auto& output : command.rate_outputs) {
+                *log << ' ' << output.sample_rate << "Hz (" << output.file_path << ')';
+            }
+            *log << " in the same pass...\n";
+
+            wavegen::render_context context;
+            timing = wavegen::create_resampled_wave_files(frequency, file_length, options, command.rate_outputs, context);
+        }
 
+        *log << "Spent " << timing.compute_sec << " seconds computing and " 
+             << timing.io_wait_sec << " seconds blocked on I/O.\n";
+        if (timing.cache_hit) {
+            *log << "Served from the render cache in " << command.cache_directory << ".\n";
+        }
+        if (!options.playback_device.empty()) {
+            *log << "Played with " << timing.underrun_count << " underruns.\n";
+        }
+        if (timing.first_block_sec >= 0.0) {
+            *log << "First block reached " << options.file_path << " after " << timing.first_block_sec * 1e3 << " ms.\n";
+        }
+        if (!command.stats_format.empty()) {
+            print_stats(*log, command.stats_format, wavegen::seconds_since(start));
+        }
     } catch (const std::exception& e) {
         std::cerr << "Error: \"" << e.what() << "\"\n";
         return -1;
     }
 
-    std::cout << "Finished.\n";
+    *log << "Finished.\n";
 
     return 0;
 }
\ No newline at end of file